@@ -0,0 +1,54 @@
+/* This file measures how MCTS scales with the number of threads.
+ *
+ * It runs MCTS on a large corner problem (see CornerProblem.hpp) for an
+ * increasing number of threads, with both root and tree parallelism, and
+ * prints the number of simulations per second that each configuration
+ * achieves.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <AIToolbox/MDP/Algorithms/MCTS.hpp>
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+int main() {
+    using namespace AIToolbox::MDP;
+
+    constexpr unsigned iterations = 200000;
+    constexpr unsigned horizon = 50;
+
+    GridWorld grid(20, 20);
+    const auto model = makeCornerProblem(grid);
+    const size_t start = grid.getS() / 2 + grid.getWidth() / 2;
+
+    // Powers of two, up to all the cores of the machine.
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(16) << "root sims/s"
+              << std::setw(16) << "tree sims/s" << '\n';
+
+    for (const auto threads : threadCounts) {
+        std::cout << std::setw(8) << threads;
+        for (const auto p : {MCTSParallelism::Root, MCTSParallelism::Tree}) {
+            MCTS solver(model, iterations, 5.0, threads);
+            solver.setParallelism(p);
+
+            const auto begin = std::chrono::steady_clock::now();
+            solver.sampleAction(start, horizon);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+            std::cout << std::setw(16) << static_cast<unsigned long>(iterations / elapsed.count());
+        }
+        std::cout << '\n';
+    }
+
+    return 0;
+}
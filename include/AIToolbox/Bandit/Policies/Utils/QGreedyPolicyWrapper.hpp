@@ -5,6 +5,43 @@
 #include <AIToolbox/Bandit/Types.hpp>
 
 namespace AIToolbox::Bandit {
+    /**
+     * @brief This function finds all the greedy actions of a QFunction row.
+     *
+     * The greedy actions are written, in increasing order, at the start of
+     * the buffer, which must have space for all actions. Values that are
+     * equal up to checkEqualGeneral() are considered ties.
+     *
+     * @param q The values of the actions.
+     * @param buffer The output buffer.
+     *
+     * @return The number of greedy actions.
+     */
+    template <typename V>
+    unsigned findBestActions(const V & q, size_t * buffer) {
+        // Automatically sets initial best action as bestAction[0] = 0
+        buffer[0] = 0;
+
+        // This work is due to multiple max-valued actions
+        double bestValue = q[0]; unsigned bestActionCount = 1;
+        for ( size_t a = 1; a < static_cast<size_t>(q.size()); ++a ) {
+            const double val = q[a];
+            // The checkEqualGeneral is before the greater since we want to
+            // trap here things that may be equal (even if one is a tiny bit
+            // higher than the other).
+            if ( checkEqualGeneral(val, bestValue) ) {
+                buffer[bestActionCount] = a;
+                ++bestActionCount;
+            }
+            else if ( val > bestValue ) {
+                buffer[0] = a;
+                bestActionCount = 1;
+                bestValue = val;
+            }
+        }
+        return bestActionCount;
+    }
+
     /**
      * @brief This class implements some basic greedy policy primitives.
      *
@@ -85,26 +122,8 @@ namespace AIToolbox::Bandit {
 
     template <typename V, typename Gen>
     size_t QGreedyPolicyWrapper<V, Gen>::sampleAction() {
-        // Automatically sets initial best action as bestAction[0] = 0
-        buffer_[0] = 0;
+        const unsigned bestActionCount = findBestActions(q_, buffer_.data());
 
-        // This work is due to multiple max-valued actions
-        double bestValue = q_[0]; unsigned bestActionCount = 1;
-        for ( size_t a = 1; a < buffer_.size(); ++a ) {
-            const double val = q_[a];
-            // The checkEqualGeneral is before the greater since we want to
-            // trap here things that may be equal (even if one is a tiny bit
-            // higher than the other).
-            if ( checkEqualGeneral(val, bestValue) ) {
-                buffer_[bestActionCount] = a;
-                ++bestActionCount;
-            }
-            else if ( val > bestValue ) {
-                buffer_[0] = a;
-                bestActionCount = 1;
-                bestValue = val;
-            }
-        }
         auto pickDistribution = std::uniform_int_distribution<unsigned>(0, bestActionCount-1);
         const unsigned selection = pickDistribution(rand_);
 
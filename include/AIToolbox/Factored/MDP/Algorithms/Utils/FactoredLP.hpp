@@ -2,6 +2,7 @@
 #define AI_TOOLBOX_FACTORED_MDP_FACTORED_LP_HEADER_FILE
 
 #include <utility>
+#include <optional>
 
 #include <AIToolbox/Factored/MDP/Types.hpp>
 
@@ -0,0 +1,264 @@
+#ifndef AI_TOOLBOX_IMPL_BINARY_MODEL_FORMAT_HEADER_FILE
+#define AI_TOOLBOX_IMPL_BINARY_MODEL_FORMAT_HEADER_FILE
+
+#include <cstdint>
+#include <string>
+#include <iosfwd>
+#include <fstream>
+#include <memory>
+
+#include <AIToolbox/Types.hpp>
+
+namespace AIToolbox::Impl {
+    /**
+     * @brief This enum identifies which model a binary file contains.
+     */
+    enum class BinaryModelKind : std::uint32_t {
+        MDPModel         = 1,
+        MDPSparseModel   = 2,
+        POMDPModel       = 3,
+        POMDPSparseModel = 4,
+    };
+
+    /**
+     * @brief This class writes models in the library binary format.
+     *
+     * The format is a fixed 64 byte header, followed by a sequence of
+     * sections, each starting at an 8 byte aligned offset from the start of
+     * the file.
+     *
+     * The header contains a magic string, the format version, the kind of
+     * the stored model, a byte order marker, the size of the scalars of the
+     * transition function, the S, A, O sizes and the discount. All other
+     * matrices are always stored as doubles.
+     *
+     * Dense sections store their matrix in row-major order. Sparse sections
+     * store the number of non-zeros, followed by the outer index, the inner
+     * index and the values arrays of a compressed row-major matrix, each
+     * padded to 8 bytes. Everything is written in the native byte order;
+     * the reader refuses files written on machines with a different one.
+     *
+     * The layout of the sections depends on the kind of the model; the
+     * MDP and POMDP IO functions take care of it.
+     */
+    class BinaryModelWriter {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * This constructor immediately writes the header to the stream.
+             * The stream should be opened in binary mode.
+             *
+             * @param os The output stream.
+             * @param kind The kind of model being written.
+             * @param S The number of states of the model.
+             * @param A The number of actions of the model.
+             * @param O The number of observations of the model (0 for MDPs).
+             * @param discount The discount of the model.
+             * @param scalarSize The size of the scalars of the transition function.
+             */
+            BinaryModelWriter(std::ostream & os, BinaryModelKind kind, size_t S, size_t A, size_t O, double discount, size_t scalarSize = sizeof(double));
+
+            /**
+             * @brief This function writes a dense matrix section.
+             *
+             * @param m The matrix to write.
+             */
+            void writeDense(const Matrix2D & m);
+
+            /**
+             * @brief This function writes a sparse matrix section.
+             *
+             * @tparam Scalar The type of the values of the matrix.
+             * @param m The matrix to write.
+             */
+            template <typename Scalar>
+            void writeSparse(const SparseMatrix2DT<Scalar> & m);
+
+        private:
+            void write(const void * data, size_t bytes);
+            void pad();
+
+            std::ostream & os_;
+            size_t written_;
+    };
+
+    /**
+     * @brief This class reads models written by BinaryModelWriter.
+     *
+     * This is a plain binary reader: every section is read from the file
+     * directly into the storage of its destination matrix, with no
+     * parsing involved. The resulting matrices own their data.
+     *
+     * Model and SparseModelT own their Eigen storage, so the data would
+     * have to be copied out of a mapping anyway; reading straight into the
+     * matrices costs a single copy without keeping the file mapped. To
+     * share a sparse model between processes without copying it, use
+     * BinaryModelMapping instead.
+     *
+     * The model dimensions in the header, and the extent of every section,
+     * are checked against the size of the file before any memory is
+     * allocated for them, so that corrupted sizes can't cause huge
+     * allocations.
+     *
+     * Any problem with the file (wrong magic, version, kind, byte order,
+     * truncation, oversized dimensions, a discount outside (0,1] or
+     * invalid sparse indices) results in an std::runtime_error.
+     */
+    class BinaryModelReader {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * This constructor opens the file and validates its header.
+             *
+             * @param filename The file to read.
+             * @param kind The kind of model we expect to find in the file.
+             */
+            BinaryModelReader(const std::string & filename, BinaryModelKind kind);
+
+            /**
+             * @brief This function reads the next section as a dense matrix.
+             *
+             * @param rows The expected number of rows.
+             * @param cols The expected number of columns.
+             *
+             * @return The read matrix.
+             */
+            Matrix2D readDense(size_t rows, size_t cols);
+
+            /**
+             * @brief This function reads the next section as a sparse matrix.
+             *
+             * Since Eigen uses int indices, dimensions above INT_MAX are
+             * rejected.
+             *
+             * @tparam Scalar The type of the values of the matrix.
+             * @param rows The expected number of rows.
+             * @param cols The expected number of columns.
+             *
+             * @return The read matrix.
+             */
+            template <typename Scalar>
+            SparseMatrix2DT<Scalar> readSparse(size_t rows, size_t cols);
+
+            /**
+             * @brief This function returns the number of states of the stored model.
+             */
+            size_t getS() const;
+
+            /**
+             * @brief This function returns the number of actions of the stored model.
+             */
+            size_t getA() const;
+
+            /**
+             * @brief This function returns the number of observations of the stored model.
+             */
+            size_t getO() const;
+
+            /**
+             * @brief This function returns the discount of the stored model.
+             */
+            double getDiscount() const;
+
+            /**
+             * @brief This function returns the size of the scalars of the transition function of the stored model.
+             */
+            size_t getScalarSize() const;
+
+        private:
+            void require(size_t bytes) const;
+            void read(void * data, size_t bytes);
+            void skipPadding();
+
+            std::ifstream file_;
+            size_t size_, offset_, scalarSize_;
+
+            size_t S, A, O;
+            double discount_;
+    };
+
+    /**
+     * @brief This class maps a file written by BinaryModelWriter read-only in memory.
+     *
+     * Sparse sections are not copied: mapSparse() returns an Eigen::Map
+     * over the CSR arrays in the mapped file, which the writer already
+     * aligns. Since the mapping is read-only and shared, the operating
+     * system keeps a single copy of the pages no matter how many
+     * processes map the same file, and only loads the pages that are
+     * actually accessed.
+     *
+     * The mapping is reference counted, so copies of this class, and the
+     * maps it returns, remain valid as long as any copy is alive. The file
+     * must not be modified or truncated while it is mapped.
+     *
+     * The header, the extent of every section and the sparse indices are
+     * validated as in BinaryModelReader, and any problem results in an
+     * std::runtime_error. Validating the indices reads them once, but
+     * does not copy them.
+     */
+    class BinaryModelMapping {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * This constructor maps the file and validates its header.
+             *
+             * @param filename The file to map.
+             * @param kind The kind of model we expect to find in the file.
+             */
+            BinaryModelMapping(const std::string & filename, BinaryModelKind kind);
+
+            /**
+             * @brief This function maps the next section as a sparse matrix.
+             *
+             * Since Eigen uses int indices, dimensions above INT_MAX are
+             * rejected.
+             *
+             * @tparam Scalar The type of the values of the matrix.
+             * @param rows The expected number of rows.
+             * @param cols The expected number of columns.
+             *
+             * @return A read-only map over the section.
+             */
+            template <typename Scalar>
+            Eigen::Map<const SparseMatrix2DT<Scalar>> mapSparse(size_t rows, size_t cols);
+
+            /**
+             * @brief This function returns the number of states of the stored model.
+             */
+            size_t getS() const;
+
+            /**
+             * @brief This function returns the number of actions of the stored model.
+             */
+            size_t getA() const;
+
+            /**
+             * @brief This function returns the number of observations of the stored model.
+             */
+            size_t getO() const;
+
+            /**
+             * @brief This function returns the discount of the stored model.
+             */
+            double getDiscount() const;
+
+            /**
+             * @brief This function returns the size of the scalars of the transition function of the stored model.
+             */
+            size_t getScalarSize() const;
+
+        private:
+            void require(size_t bytes) const;
+
+            std::shared_ptr<const char> data_;
+            size_t size_, offset_, scalarSize_;
+
+            size_t S, A, O;
+            double discount_;
+    };
+}
+
+#endif
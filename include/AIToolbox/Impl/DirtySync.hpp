@@ -0,0 +1,163 @@
+#ifndef AI_TOOLBOX_IMPL_DIRTY_SYNC_HEADER_FILE
+#define AI_TOOLBOX_IMPL_DIRTY_SYNC_HEADER_FILE
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace AIToolbox::Impl {
+    /**
+     * @brief This class holds the epoch of an Experience.
+     *
+     * Epochs are unique across all instances. Copying an Epoch (through
+     * construction or assignment) does not copy its value, but draws a new
+     * one, since the Experience holding it now contains different data
+     * from what any model synced to it has seen.
+     */
+    class Epoch {
+        public:
+            Epoch() : value_(next()) {}
+            Epoch(const Epoch &) : value_(next()) {}
+            Epoch & operator=(const Epoch &) { value_ = next(); return *this; }
+
+            /**
+             * @brief This function starts a new epoch.
+             */
+            void advance() { value_ = next(); }
+
+            /**
+             * @brief This function returns the current epoch.
+             */
+            unsigned long get() const { return value_; }
+
+        private:
+            static unsigned long next() {
+                static std::atomic<unsigned long> epochs{0};
+                return ++epochs;
+            }
+
+            unsigned long value_;
+    };
+
+    /**
+     * @brief This class keeps the list of state-action pairs modified within an epoch.
+     *
+     * Each modification is appended together with its version, so the
+     * log is sorted by version. Readers never modify the log; each of them
+     * remembers the version it last read up to, and asks for the pairs
+     * modified after it. This way any number of models can sync from the
+     * same Experience.
+     *
+     * To keep memory bounded, once the log grows past twice the number of
+     * pairs it drops all entries superseded by a later modification of
+     * the same pair. The last entry of each pair is always kept, so no
+     * reader can miss it.
+     */
+    class DirtyLog {
+        public:
+            /**
+             * @brief This function records a modification of a pair.
+             *
+             * Versions must be non-decreasing across calls.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             * @param version The version of the modification.
+             * @param pairs The total number of state-action pairs.
+             * @param current A function returning the last version of a pair.
+             */
+            template <typename F>
+            void add(const size_t s, const size_t a, const unsigned long version, const size_t pairs, F current) {
+                entries_.push_back({s, a, version});
+                if ( entries_.size() > 2 * std::max<size_t>(pairs, 32) ) {
+                    entries_.erase(std::remove_if(std::begin(entries_), std::end(entries_),
+                        [&current](const Entry & e) { return current(e.s, e.a) != e.version; }),
+                        std::end(entries_));
+                }
+            }
+
+            /**
+             * @brief This function returns the pairs modified after the input version.
+             *
+             * Each pair appears once, in the order of its last
+             * modification.
+             *
+             * @param version The version the reader last read up to.
+             * @param current A function returning the last version of a pair.
+             *
+             * @return The modified state-action pairs.
+             */
+            template <typename F>
+            std::vector<std::pair<size_t, size_t>> since(const unsigned long version, F current) const {
+                auto it = std::upper_bound(std::begin(entries_), std::end(entries_), version,
+                    [](const unsigned long v, const Entry & e) { return v < e.version; });
+
+                std::vector<std::pair<size_t, size_t>> retval;
+                for ( ; it != std::end(entries_); ++it )
+                    if ( current(it->s, it->a) == it->version )
+                        retval.emplace_back(it->s, it->a);
+                return retval;
+            }
+
+            /**
+             * @brief This function empties the log, at the start of a new epoch.
+             */
+            void clear() { entries_.clear(); }
+
+        private:
+            struct Entry {
+                size_t s, a;
+                unsigned long version;
+            };
+            std::vector<Entry> entries_;
+    };
+
+    /**
+     * @brief This function syncs a model with the state-action pairs modified in its Experience.
+     *
+     * Only the pairs modified after the version of the last sync are
+     * synced. If the epoch of the Experience differs from the one of the
+     * last sync (the first sync, a reset, or a replaced Experience), all
+     * pairs are synced instead.
+     *
+     * The Experience is not modified, so multiple models can sync from
+     * the same one, each with its own epoch and version.
+     *
+     * @param model The model to sync, which must provide sync() and sync(s, a).
+     * @param exp The Experience of the model.
+     * @param syncedEpoch The epoch of the last sync; it is updated.
+     * @param syncedVersion The version of the last sync; it is updated.
+     *
+     * @return The synced state-action pairs, sorted.
+     */
+    template <typename M, typename E>
+    std::vector<std::pair<size_t, size_t>> syncDirty(M & model, const E & exp, unsigned long & syncedEpoch, unsigned long & syncedVersion) {
+        std::vector<std::pair<size_t, size_t>> dirty;
+
+        if ( exp.getEpoch() != syncedEpoch ) {
+            syncedEpoch = exp.getEpoch();
+            syncedVersion = exp.getVersion();
+            model.sync();
+
+            const size_t S = exp.getS(), A = exp.getA();
+            dirty.reserve(S * A);
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    dirty.emplace_back(s, a);
+            return dirty;
+        }
+
+        dirty = exp.getDirtyPairs(syncedVersion);
+        syncedVersion = exp.getVersion();
+
+        std::sort(std::begin(dirty), std::end(dirty));
+        for ( const auto & [s, a] : dirty )
+            model.sync(s, a);
+
+        return dirty;
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef AI_TOOLBOX_IMPL_EXPERIENCE_BATCH_HEADER_FILE
+#define AI_TOOLBOX_IMPL_EXPERIENCE_BATCH_HEADER_FILE
+
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace AIToolbox::Impl {
+    /**
+     * @brief This function merges the reward statistics of two sets of samples.
+     *
+     * This is the parallel variant of Welford's algorithm (Chan et al.).
+     * The first set of statistics is updated in place to describe the
+     * union of both sets.
+     *
+     * @param count The number of samples of the first set.
+     * @param mean The mean of the first set.
+     * @param m2 The sum of squared differences from the mean of the first set.
+     * @param otherCount The number of samples of the second set.
+     * @param otherMean The mean of the second set.
+     * @param otherM2 The sum of squared differences from the mean of the second set.
+     */
+    template <typename Count>
+    void mergeWelford(Count & count, double & mean, double & m2, const Count otherCount, const double otherMean, const double otherM2) {
+        const auto total = count + otherCount;
+        const double delta = otherMean - mean;
+
+        mean += delta * otherCount / total;
+        m2 += otherM2 + delta * delta * count * otherCount / total;
+        count = total;
+    }
+
+    /**
+     * @brief This function groups a batch of MDP events by state-action pair.
+     *
+     * The events are passed as four parallel arrays. They are sorted
+     * through an index permutation, so that all events of the same
+     * state-action pair, and within those all events with the same new
+     * state, are contiguous.
+     *
+     * The visit callback is called once per unique transition, as
+     * visit(s, a, s1, visits). The pair callback is called once per unique
+     * state-action pair, after all its transitions, as pair(s, a, count,
+     * mean, m2), with the Welford statistics of its rewards in the batch.
+     *
+     * @param n     The number of events.
+     * @param s     The old states.
+     * @param a     The performed actions.
+     * @param s1    The new states.
+     * @param rew   The obtained rewards.
+     * @param visit The callback for each unique transition.
+     * @param pair  The callback for each unique state-action pair.
+     */
+    template <typename VisitF, typename PairF>
+    void groupBatch(const size_t n, const size_t * s, const size_t * a, const size_t * s1, const double * rew, VisitF visit, PairF pair) {
+        std::vector<size_t> order(n);
+        std::iota(std::begin(order), std::end(order), 0);
+        std::sort(std::begin(order), std::end(order), [&](const size_t l, const size_t r) {
+            return std::tie(a[l], s[l], s1[l]) < std::tie(a[r], s[r], s1[r]);
+        });
+
+        size_t i = 0;
+        while ( i < n ) {
+            const auto ss = s[order[i]], aa = a[order[i]];
+
+            // Welford over the events of this pair only.
+            unsigned long count = 0;
+            double mean = 0.0, m2 = 0.0;
+            while ( i < n && s[order[i]] == ss && a[order[i]] == aa ) {
+                const auto ss1 = s1[order[i]];
+                unsigned long visits = 0;
+                for ( ; i < n && s[order[i]] == ss && a[order[i]] == aa && s1[order[i]] == ss1; ++i ) {
+                    const auto r = rew[order[i]];
+                    ++visits;
+                    const auto delta = r - mean;
+                    mean += delta / ++count;
+                    m2 += delta * (r - mean);
+                }
+                visit(ss, aa, ss1, visits);
+            }
+            pair(ss, aa, count, mean, m2);
+        }
+    }
+}
+
+#endif
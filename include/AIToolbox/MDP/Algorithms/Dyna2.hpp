@@ -4,8 +4,17 @@
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/MDP/Algorithms/SARSAL.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/EligibilityTraces.hpp>
 #include <AIToolbox/Bandit/Policies/RandomPolicy.hpp>
 #include <AIToolbox/MDP/Policies/BanditPolicyAdaptor.hpp>
+#include <AIToolbox/Utils/Parallel.hpp>
+#include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace AIToolbox::MDP {
     /**
@@ -25,6 +34,10 @@ namespace AIToolbox::MDP {
      *
      * Another advantage of clearing the memory is that, if the exploration
      * model is not perfect, imperfect information learned is also discarded.
+     *
+     * If the model can be sampled with an external random engine (see
+     * has_engine_sampling), batchUpdateQ() can split its simulation steps
+     * across multiple threads. See setThreads() for details.
      */
     template <typename M>
     class Dyna2 {
@@ -39,8 +52,9 @@ namespace AIToolbox::MDP {
              * @param lambda The lambda parameter for the eligibility traces.
              * @param tolerance The cutoff point for eligibility traces.
              * @param n The number of sampling passes to do on the model upon batchUpdateQ().
+             * @param threads The number of threads to use in batchUpdateQ(), 0 for all available ones.
              */
-            explicit Dyna2(const M & m, double alpha = 0.1, double lambda = 0.9, double tolerance = 0.001, unsigned n = 50);
+            explicit Dyna2(const M & m, double alpha = 0.1, double lambda = 0.9, double tolerance = 0.001, unsigned n = 50, unsigned threads = 1);
 
             /**
              * @brief This function updates the internal QFunction.
@@ -156,6 +170,46 @@ namespace AIToolbox::MDP {
              */
             unsigned getN() const;
 
+            /**
+             * @brief This function sets the number of threads to use in batchUpdateQ().
+             *
+             * With more than one thread, the N simulation steps are split
+             * in contiguous shares, one per thread. Each thread runs its
+             * own simulation from the root state, with its own random
+             * engine (seeded in order from the one of this class) and its
+             * own eligibility traces. Changes to the transient QFunction
+             * are accumulated per thread, against the transient QFunction
+             * as it was at the start of the batch, and are added to it in
+             * thread order once all threads are done. Thus the results
+             * only depend on the seeds and on the number of threads.
+             *
+             * In this mode the model is sampled with sampleSR(s, a, rnd),
+             * so its sampling index, if any, must be eager; and actions
+             * are sampled with each thread's engine from the
+             * getActionProbabilities() of the internal policy. Policies are
+             * not thread-safe (QGreedyPolicy and QSoftmaxPolicy, for
+             * example, write to internal buffers and caches), so these
+             * calls are serialized with a lock. The policy sees the
+             * transient QFunction as it was at the start of the batch.
+             *
+             * The threads are kept alive between calls to batchUpdateQ(),
+             * so that each batch only wakes them up.
+             *
+             * Multithreading is only used with models that satisfy
+             * has_engine_sampling. A value of 0 uses all available
+             * hardware threads, while 1 disables multithreading.
+             *
+             * @param threads The new number of threads.
+             */
+            void setThreads(unsigned threads);
+
+            /**
+             * @brief This function returns the currently set number of threads.
+             *
+             * @return The currently set number of threads.
+             */
+            unsigned getThreads() const;
+
             /**
              * @brief This function sets the trace cutoff parameter.
              *
@@ -192,6 +246,24 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getTransientQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the permanent QFunction.
+             *
+             * \sa SARSAL::getQFunctionVersion()
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getPermanentQFunctionVersion() const;
+
+            /**
+             * @brief This function returns a reference to the version counter of the transient QFunction.
+             *
+             * \sa SARSAL::getQFunctionVersion()
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getTransientQFunctionVersion() const;
+
             /**
              * @brief This function returns a reference to the referenced Model.
              *
@@ -205,17 +277,47 @@ namespace AIToolbox::MDP {
             SARSAL permanentLearning_;
             SARSAL transientLearning_;
             std::unique_ptr<PolicyInterface> internalPolicy_;
+
+            // Parallel batch updates
+            struct Worker {
+                Worker(size_t A);
+
+                RandomEngine rand;
+                EligibilityTraces traces;
+                std::unordered_map<size_t, double> deltas; // s * A + a
+                Vector policy;
+            };
+
+            /**
+             * @brief This function runs a simulation on a single thread of a parallel batchUpdateQ().
+             *
+             * @param w The worker state of the thread.
+             * @param initS The root state of the simulation.
+             * @param steps The number of simulation steps.
+             */
+            void simulate(Worker & w, size_t initS, size_t steps) const;
+
+            unsigned threads_;
+            RandomEngine rand_;
+            std::vector<Worker> workers_;
+            std::unique_ptr<ThreadPool> pool_;
+            // Serializes the workers' queries to the internal policy.
+            mutable std::mutex policyLock_;
     };
 
     template <typename M>
-    Dyna2<M>::Dyna2(const M & m, const double alpha, const double lambda, const double tolerance, const unsigned n) :
+    Dyna2<M>::Dyna2(const M & m, const double alpha, const double lambda, const double tolerance, const unsigned n, const unsigned threads) :
             N(n), model_(m),
             permanentLearning_(model_, alpha, lambda, tolerance),
             transientLearning_(model_, alpha, lambda, tolerance),
-            internalPolicy_(new BanditPolicyAdaptor<Bandit::RandomPolicy>(model_.getS(), model_.getA()))
+            internalPolicy_(new BanditPolicyAdaptor<Bandit::RandomPolicy>(model_.getS(), model_.getA())),
+            threads_(threads), rand_(Impl::Seeder::getSeed())
     {
     }
 
+    template <typename M>
+    Dyna2<M>::Worker::Worker(const size_t A) : traces(A), policy(A) {}
+
     template <typename M>
     void Dyna2<M>::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const size_t a1, const double rew) {
         // We copy the traces from the permanent SARSAL to the transient one so
@@ -247,6 +349,33 @@ namespace AIToolbox::MDP {
         // and/or multiple times in a row.
         transientLearning_.clearTraces();
 
+        if constexpr (has_engine_sampling_v<M>) {
+            const unsigned T = getNumThreads(threads_, N);
+            if ( T > 1 ) {
+                // Seeds are drawn in thread order, so the outcome does not
+                // depend on scheduling.
+                workers_.reserve(T);
+                while ( workers_.size() < T )
+                    workers_.emplace_back(model_.getA());
+                for ( unsigned t = 0; t < T; ++t )
+                    workers_[t].rand.seed(rand_());
+
+                if ( !pool_ || pool_->size() != T )
+                    pool_ = std::make_unique<ThreadPool>(T);
+
+                pool_->parallelFor(N, [&](const size_t begin, const size_t end, const unsigned t) {
+                    simulate(workers_[t], initS, end - begin);
+                });
+
+                double * q = transientLearning_.q_.data();
+                for ( unsigned t = 0; t < T; ++t )
+                    for ( const auto & [id, delta] : workers_[t].deltas )
+                        q[id] += delta;
+                ++transientLearning_.version_;
+                return;
+            }
+        }
+
         size_t s = initS;
         size_t a = internalPolicy_->sampleAction(s);
         for ( unsigned i = 0; i < N; ++i ) {
@@ -265,6 +394,54 @@ namespace AIToolbox::MDP {
         }
     }
 
+    template <typename M>
+    void Dyna2<M>::simulate(Worker & w, const size_t initS, const size_t steps) const {
+        const size_t A = model_.getA();
+        const auto & q = transientLearning_.getQFunction();
+
+        const double alpha = transientLearning_.getLearningRate();
+        const double discount = transientLearning_.getDiscount();
+        const double gammaL = discount * transientLearning_.getLambda();
+        const double tolerance = transientLearning_.getTolerance();
+
+        w.traces.clear();
+        w.deltas.clear();
+
+        const auto getQ = [&](const size_t s, const size_t a) {
+            const auto it = w.deltas.find(s * A + a);
+            return q(s, a) + (it != w.deltas.end() ? it->second : 0.0);
+        };
+        const auto sampleAction = [&](const size_t s) {
+            {
+                std::lock_guard<std::mutex> lock(policyLock_);
+                internalPolicy_->getActionProbabilities(s, w.policy);
+            }
+            return sampleProbability(A, w.policy, w.rand);
+        };
+
+        // This is the same as SARSAL::stepUpdateQ, but the changes go in
+        // the sparse deltas rather than in the QFunction.
+        size_t s = initS;
+        size_t a = sampleAction(s);
+        for ( size_t i = 0; i < steps; ++i ) {
+            const auto [s1, rew] = model_.sampleSR(s, a, w.rand);
+            const size_t a1 = sampleAction(s1);
+
+            const double error = alpha * ( rew + discount * getQ(s1, a1) - getQ(s, a) );
+            w.traces.update(s, a, gammaL, tolerance, [&](const size_t id, const double el) {
+                w.deltas[id] += error * el;
+            });
+
+            if (model_.isTerminal(s1)) {
+                s = initS;
+                a = sampleAction(s);
+            } else {
+                s = s1;
+                a = a1;
+            }
+        }
+    }
+
     template <typename M>
     void Dyna2<M>::resetTransientLearning() {
         transientLearning_.setQFunction(permanentLearning_.getQFunction());
@@ -274,11 +451,26 @@ namespace AIToolbox::MDP {
         internalPolicy_.reset(p);
     }
 
+    template <typename M>
+    void Dyna2<M>::setN(const unsigned n) {
+        N = n;
+    }
+
     template <typename M>
     unsigned Dyna2<M>::getN() const {
         return N;
     }
 
+    template <typename M>
+    void Dyna2<M>::setThreads(const unsigned threads) {
+        threads_ = threads;
+    }
+
+    template <typename M>
+    unsigned Dyna2<M>::getThreads() const {
+        return threads_;
+    }
+
     template <typename M>
     void Dyna2<M>::setTolerance(const double t) {
         transientLearning_.setTolerance(t);
@@ -300,6 +492,16 @@ namespace AIToolbox::MDP {
         return transientLearning_.getQFunction();
     }
 
+    template <typename M>
+    const size_t & Dyna2<M>::getPermanentQFunctionVersion() const {
+        return permanentLearning_.getQFunctionVersion();
+    }
+
+    template <typename M>
+    const size_t & Dyna2<M>::getTransientQFunctionVersion() const {
+        return transientLearning_.getQFunctionVersion();
+    }
+
     template <typename M>
     const M & Dyna2<M>::getModel() const {
         return model_;
@@ -4,11 +4,9 @@
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/MDP/Algorithms/QLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/VisitedPairs.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
-#include <boost/functional/hash.hpp>
-#include <utility>
-#include <unordered_set>
 #include <vector>
 
 namespace AIToolbox::MDP {
@@ -29,8 +27,20 @@ namespace AIToolbox::MDP {
      *
      * The algorithm selects randomly which state action pairs to try again
      * from.
+     *
+     * The visited pairs are tracked by the V class, which must provide the
+     * same interface as DenseVisitedPairs. The default uses S*A bits; for
+     * models where that is too much use PagedVisitedPairs, whose memory
+     * only grows with the visited part of the state-action space.
+     *
+     * batchUpdateQ() draws the whole batch of pairs before sampling the
+     * model, into a buffer that is reused across calls, so that planning
+     * does not allocate. If the model supports it, enabling its sampling
+     * index (see Model::setSamplingIndex()) makes each model sample take
+     * constant time, as the alias tables of the replayed pairs are built
+     * once and then reused.
      */
-    template <typename M>
+    template <typename M, typename V = DenseVisitedPairs>
     class DynaQ {
         static_assert(is_generative_model_v<M>, "This class only works for generative MDP models!");
 
@@ -56,7 +66,7 @@ namespace AIToolbox::MDP {
              *
              * The sampling list in DynaQ is a simple list of all visited
              * state action pairs. This function is responsible for inserting
-             * them in a set, keeping them unique.
+             * them in the visited set, keeping them unique.
              *
              * @param s The previous state.
              * @param a The action performed.
@@ -117,6 +127,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function returns a reference to the referenced Model.
              *
@@ -124,72 +145,93 @@ namespace AIToolbox::MDP {
              */
             const M & getModel() const;
 
+            /**
+             * @brief This function returns the set of visited state-action pairs.
+             *
+             * @return The visited pairs.
+             */
+            const V & getVisitedPairs() const;
+
         private:
             unsigned N;
             const M & model_;
             QLearning qLearning_;
 
-            // We use two structures because generally S*A is not THAT big, and we can definitely use
-            // the O(1) insertion and O(1) sampling time.
-            std::unordered_set<std::pair<size_t,size_t>, boost::hash<std::pair<size_t, size_t>>> visitedStatesActionsInserter_;
-            std::vector<std::pair<size_t,size_t>> visitedStatesActionsSampler_;
+            V visited_;
 
             // Stuff for batch update
+            std::vector<size_t> batch_;
             mutable RandomEngine rand_;
     };
 
-    template <typename M>
-    DynaQ<M>::DynaQ(const M & m, const double alpha, const unsigned n) :
-            N(n), model_(m), qLearning_(model_, alpha), rand_(Impl::Seeder::getSeed())
+    template <typename M, typename V>
+    DynaQ<M, V>::DynaQ(const M & m, const double alpha, const unsigned n) :
+            N(n), model_(m), qLearning_(model_, alpha),
+            visited_(model_.getS(), model_.getA()), rand_(Impl::Seeder::getSeed())
     {
-        visitedStatesActionsInserter_.reserve(model_.getS()*model_.getA());
-        visitedStatesActionsSampler_.reserve(model_.getS()*model_.getA());
+        batch_.reserve(N);
     }
 
-    template <typename M>
-    void DynaQ<M>::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+    template <typename M, typename V>
+    void DynaQ<M, V>::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
         qLearning_.stepUpdateQ(s, a, s1, rew);
-        // O(1) insertion...
-        const auto result = visitedStatesActionsInserter_.insert(std::make_pair(s,a));
-        if ( std::get<1>(result) )
-            visitedStatesActionsSampler_.push_back(*std::get<0>(result));
+        visited_.insert(s, a);
     }
 
-    template <typename M>
-    void DynaQ<M>::batchUpdateQ() {
-        if ( ! visitedStatesActionsSampler_.size() ) return;
-        std::uniform_int_distribution<size_t> sampleDistribution_(0, visitedStatesActionsSampler_.size()-1);
+    template <typename M, typename V>
+    void DynaQ<M, V>::batchUpdateQ() {
+        if ( ! visited_.size() ) return;
+        std::uniform_int_distribution<size_t> sampleDistribution(0, visited_.size()-1);
+
+        batch_.clear();
+        for ( unsigned i = 0; i < N; ++i )
+            batch_.push_back(sampleDistribution(rand_));
 
-        for ( unsigned i = 0; i < N; ++i ) {
-            // O(1) sampling...
-            const auto [s,a] = visitedStatesActionsSampler_[sampleDistribution_(rand_)];
-            const auto [s1, rew] = model_.sample(s, a);
+        for ( const auto i : batch_ ) {
+            const auto [s, a] = visited_[i];
+            const auto [s1, rew] = model_.sampleSR(s, a);
 
             qLearning_.stepUpdateQ(s, a, s1, rew);
         }
     }
 
-    template <typename M>
-    unsigned DynaQ<M>::getN() const {
+    template <typename M, typename V>
+    void DynaQ<M, V>::setN(const unsigned n) {
+        N = n;
+        batch_.reserve(N);
+    }
+
+    template <typename M, typename V>
+    unsigned DynaQ<M, V>::getN() const {
         return N;
     }
 
-    template <typename M>
-    const QFunction & DynaQ<M>::getQFunction() const {
+    template <typename M, typename V>
+    const QFunction & DynaQ<M, V>::getQFunction() const {
         return qLearning_.getQFunction();
     }
-    template <typename M>
-    const M & DynaQ<M>::getModel() const {
+
+    template <typename M, typename V>
+    const size_t & DynaQ<M, V>::getQFunctionVersion() const {
+        return qLearning_.getQFunctionVersion();
+    }
+    template <typename M, typename V>
+    const M & DynaQ<M, V>::getModel() const {
         return model_;
     }
 
-    template <typename M>
-    void DynaQ<M>::setLearningRate(const double a) {
+    template <typename M, typename V>
+    const V & DynaQ<M, V>::getVisitedPairs() const {
+        return visited_;
+    }
+
+    template <typename M, typename V>
+    void DynaQ<M, V>::setLearningRate(const double a) {
         qLearning_.setLearningRate(a);
     }
 
-    template <typename M>
-    double DynaQ<M>::getLearningRate() const {
+    template <typename M, typename V>
+    double DynaQ<M, V>::getLearningRate() const {
         return qLearning_.getLearningRate();
     }
 }
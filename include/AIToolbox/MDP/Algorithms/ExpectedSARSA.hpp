@@ -158,8 +158,10 @@ namespace AIToolbox::MDP {
              * @param a The action performed.
              * @param s1 The new state.
              * @param rew The reward obtained.
+             *
+             * @return The temporal difference error of the update.
              */
-            void stepUpdateQ(size_t s, size_t a, size_t s1, double rew);
+            double stepUpdateQ(size_t s, size_t a, size_t s1, double rew);
 
             /**
              * @brief This function returns the number of states on which QLearning is working.
@@ -185,6 +187,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function returns a reference to the policy used by ExpectedSARSA.
              *
@@ -199,6 +212,10 @@ namespace AIToolbox::MDP {
             double discount_;
 
             QFunction & q_;
+            size_t version_;
+
+            // To avoid reallocating a vector every time for the expectation.
+            Vector probs_;
     };
 
     template <typename M, typename>
@@ -0,0 +1,239 @@
+#ifndef AI_TOOLBOX_MDP_GAUSS_SEIDEL_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_GAUSS_SEIDEL_VALUE_ITERATION_HEADER_FILE
+
+#include <algorithm>
+#include <numeric>
+
+#include <AIToolbox/Impl/Logging.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/TypeTraits.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/Utils/Core.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class applies the Gauss-Seidel value iteration algorithm on a Model.
+     *
+     * This algorithm is a variant of ValueIteration. Where ValueIteration
+     * computes a whole new QFunction from the old values before replacing
+     * them (a Jacobi iteration), this class updates the values of each
+     * state in place, one state at a time. Each backup thus already uses
+     * the most recent values for the states that have already been
+     * processed during the current sweep.
+     *
+     * This generally makes the algorithm converge in fewer sweeps,
+     * especially on problems with long chains of states, and avoids
+     * allocating a full QFunction at every sweep; the QFunction is only
+     * computed once, at the end of the process.
+     *
+     * Optionally, states can be swept in order of decreasing residual
+     * (the amount their value changed during the previous sweep), so that
+     * the states that are changing the most propagate their values
+     * first. Only the states whose residual is above the tolerance are
+     * sorted; all others follow them in index order, so the overhead of
+     * each sweep shrinks as the values converge.
+     */
+    class GaussSeidelValueIteration {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * constructor will throw an std::invalid_argument. The tolerance
+             * parameter sets the convergence criterion. A tolerance of 0.0
+             * forces GaussSeidelValueIteration to perform a number of
+             * sweeps equal to the horizon specified. Otherwise,
+             * GaussSeidelValueIteration will stop as soon as the maximum
+             * change in values during a sweep is less than the tolerance
+             * specified.
+             *
+             * Note that the default value function size needs to match
+             * the number of states of the Model. Otherwise it will
+             * be ignored. An empty value function will be defaulted
+             * to all zeroes.
+             *
+             * @param horizon The maximum number of sweeps to perform.
+             * @param tolerance The tolerance factor to stop the sweeps.
+             * @param v The initial value function from which to start the loop.
+             * @param prioritized Whether states should be swept by decreasing residual.
+             */
+            GaussSeidelValueIteration(unsigned horizon, double tolerance = 0.001, ValueFunction v = {Values(), Actions(0)}, bool prioritized = false);
+
+            /**
+             * @brief This function applies Gauss-Seidel value iteration on an MDP to solve it.
+             *
+             * The algorithm is constrained by the currently set parameters.
+             *
+             * @tparam M The type of the solvable MDP.
+             * @param m The MDP that needs to be solved.
+             *
+             * @return A tuple containing the maximum variation for the
+             *         ValueFunction, the ValueFunction and the QFunction for
+             *         the Model.
+             */
+            template <typename M, typename = std::enable_if_t<is_model_v<M>>>
+            std::tuple<double, ValueFunction, QFunction> operator()(const M & m);
+
+            /**
+             * @brief This function sets the tolerance parameter.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * function will throw an std::invalid_argument.
+             *
+             * @param e The new tolerance parameter.
+             */
+            void setTolerance(double e);
+
+            /**
+             * @brief This function sets the horizon parameter.
+             *
+             * @param h The new horizon parameter.
+             */
+            void setHorizon(unsigned h);
+
+            /**
+             * @brief This function sets the starting value function.
+             *
+             * An empty value function defaults to all zeroes. Note
+             * that the default value function size needs to match
+             * the number of states of the Model that needs to be
+             * solved. Otherwise it will be ignored.
+             *
+             * @param v The new starting value function.
+             */
+            void setValueFunction(ValueFunction v);
+
+            /**
+             * @brief This function sets whether states are swept in order of decreasing residual.
+             *
+             * @param prioritized Whether the sweep order should be prioritized.
+             */
+            void setPrioritized(bool prioritized);
+
+            /**
+             * @brief This function will return the currently set tolerance parameter.
+             *
+             * @return The currently set tolerance parameter.
+             */
+            double getTolerance() const;
+
+            /**
+             * @brief This function will return the current horizon parameter.
+             *
+             * @return The currently set horizon parameter.
+             */
+            unsigned getHorizon() const;
+
+            /**
+             * @brief This function will return the current set default value function.
+             *
+             * @return The currently set default value function.
+             */
+            const ValueFunction & getValueFunction() const;
+
+            /**
+             * @brief This function returns whether states are swept in order of decreasing residual.
+             *
+             * @return Whether the sweep order is prioritized.
+             */
+            bool isPrioritized() const;
+
+            /**
+             * @brief This function returns the number of sweeps performed during the last solve.
+             *
+             * @return The number of sweeps performed in the last call to operator().
+             */
+            unsigned getSweeps() const;
+
+        private:
+            // Parameters
+            double tolerance_;
+            unsigned horizon_;
+            ValueFunction vParameter_;
+            bool prioritized_;
+
+            // Internals
+            ValueFunction v1_;
+            unsigned sweeps_;
+    };
+
+    template <typename M, typename>
+    std::tuple<double, ValueFunction, QFunction> GaussSeidelValueIteration::operator()(const M & model) {
+        // Extract necessary knowledge from model so we don't have to pass it around
+        const size_t S = model.getS();
+
+        {
+            // Verify that parameter value function is compatible.
+            const size_t size = vParameter_.values.size();
+            if ( size != S ) {
+                if ( size != 0 ) {
+                    AI_LOGGER(AI_SEVERITY_WARNING, "Size of starting value function is incorrect, ignoring...");
+                }
+                // Defaulting
+                v1_ = makeValueFunction(S);
+            }
+            else
+                v1_ = vParameter_;
+        }
+
+        const auto & ir = [&]{
+            if constexpr (is_model_eigen_v<M>) return model.getRewardFunction();
+            else return computeImmediateRewards(model);
+        }();
+
+        sweeps_ = 0;
+        double variation = tolerance_ * 2; // Make it bigger
+
+        auto & values = v1_.values;
+        auto & actions = v1_.actions;
+
+        std::vector<size_t> order(S);
+        std::iota(std::begin(order), std::end(order), 0);
+        std::vector<double> residuals;
+        if ( prioritized_ ) residuals.resize(S);
+
+        const bool useTolerance = checkDifferentSmall(tolerance_, 0.0);
+        while ( sweeps_ < horizon_ && (!useTolerance || variation > tolerance_) ) {
+            ++sweeps_;
+            AI_LOGGER(AI_SEVERITY_DEBUG, "Processing sweep " << sweeps_);
+
+            variation = 0.0;
+            for ( const auto s : order ) {
+                const auto [a, v] = bellmanBackup(model, ir, values, s);
+                const double residual = std::fabs(v - values[s]);
+
+                values[s] = v;
+                actions[s] = a;
+
+                if ( prioritized_ ) residuals[s] = residual;
+                variation = std::max(variation, residual);
+            }
+
+            // States that changed the most are backed up first in the next
+            // sweep. We only sort the states that still change more than
+            // the tolerance, and leave the others in index order, so that
+            // this costs O(S + k log k) for k changing states.
+            if ( prioritized_ ) {
+                order.clear();
+                for ( size_t s = 0; s < S; ++s )
+                    if ( residuals[s] > tolerance_ )
+                        order.push_back(s);
+
+                std::sort(std::begin(order), std::end(order), [&residuals](size_t lhs, size_t rhs) {
+                    return residuals[lhs] > residuals[rhs] || (residuals[lhs] == residuals[rhs] && lhs < rhs);
+                });
+
+                for ( size_t s = 0; s < S; ++s )
+                    if ( residuals[s] <= tolerance_ )
+                        order.push_back(s);
+            }
+        }
+
+        // We only build the QFunction once, from the final values.
+        QFunction q = computeQFunction(model, values * model.getDiscount(), ir);
+
+        return std::make_tuple(useTolerance ? variation : 0.0, std::move(v1_), std::move(q));
+    }
+}
+
+#endif
@@ -3,12 +3,35 @@
 
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
+#include <AIToolbox/MDP/Policies/PolicyInterface.hpp>
+#include <AIToolbox/Utils/Parallel.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/SearchStatistics.hpp>
+#include <AIToolbox/Utils/SearchTree.hpp>
+#include <AIToolbox/Utils/TranspositionTable.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
-#include <unordered_map>
+#include <functional>
+#include <limits>
+#include <mutex>
 
 namespace AIToolbox::MDP {
+    /**
+     * @brief This enum selects how MCTS splits its simulations between threads.
+     */
+    enum class MCTSParallelism {
+        Root,   ///< Each thread grows its own tree, and the roots are merged at the end.
+        Tree,   ///< All threads grow the same tree, using virtual loss to spread out.
+    };
+
+    /**
+     * @brief This enum selects how root-parallel MCTS picks an action from its merged trees.
+     */
+    enum class MCTSRootMerge {
+        Visits, ///< The action with the most visits across all trees.
+        Values, ///< The action with the highest visit-weighted average value across all trees.
+    };
+
     /**
      * @brief This class represents the MCTS online planner using UCB1.
      *
@@ -37,11 +60,37 @@ namespace AIToolbox::MDP {
      * rollout policy is used to approximate the values for all nodes
      * visited in this rollout inside the tree, before leaving it.
      *
+     * The random rollout policy can be replaced by any policy (for
+     * example one computed offline on an approximate model), and
+     * rollouts can be truncated after a fixed number of steps, using a
+     * leaf evaluator to estimate the value of the rest of the episode.
+     * See setRolloutPolicy(), setRolloutDepth() and setLeafEvaluator().
+     *
      * Since MCTS expands a tree, it can reuse work it has done if
      * multiple action requests are done in order. To do so, it simply asks
      * for the action that has been performed and its respective new state.
      * Then it simply makes that root branch the new root, and starts
      * again.
+     *
+     * The tree is stored in a SearchTree, which keeps all nodes in a
+     * single arena. Pruning the tree when reusing it is O(1), and the
+     * memory of the discarded branches is recycled by the following
+     * searches rather than freed.
+     *
+     * If the model can be sampled with an external random engine (see
+     * has_engine_sampling), the simulations can be split between multiple
+     * threads, each with its own random engine. With root parallelism each
+     * thread grows a separate tree, and the statistics of the roots are
+     * merged at the end. With tree parallelism all threads share the same
+     * tree: each simulation temporarily counts as a loss for the actions
+     * it passes through (a "virtual loss"), so that concurrent simulations
+     * tend to explore different branches. See setThreads().
+     *
+     * When the same state can be reached through many different paths,
+     * the tree stores many copies of it, each learning separately. MCTS
+     * can instead share a single node for each state and remaining
+     * horizon through a bounded transposition table, searching a DAG
+     * rather than a tree. See setTranspositionTableSize().
      */
     template <typename M>
     class MCTS {
@@ -50,21 +99,16 @@ namespace AIToolbox::MDP {
         public:
             using SampleBelief = std::vector<size_t>;
 
-            struct StateNode;
-            using StateNodes = std::unordered_map<size_t, StateNode>;
+            // Nodes are keyed by state.
+            using Graph = SearchTree<>;
+            using Index = Graph::Index;
+            using ActionNode = Graph::Edge;
 
-            struct ActionNode {
-                StateNodes children;
-                double V = 0.0;
-                unsigned N = 0;
-            };
-            using ActionNodes = std::vector<ActionNode>;
+            // Nodes shared between paths, keyed by state and remaining horizon.
+            using Transpositions = TranspositionTable<ActionNode>;
 
-            struct StateNode {
-                StateNode() : N(0) {}
-                ActionNodes children;
-                unsigned N;
-            };
+            // Estimates the value of a state, for truncated rollouts.
+            using LeafEvaluator = std::function<double(size_t)>;
 
             /**
              * @brief Basic constructor.
@@ -72,8 +116,9 @@ namespace AIToolbox::MDP {
              * @param m The MDP model that MCTS will operate upon.
              * @param iterations The number of episodes to run before completion.
              * @param exp The exploration constant. This parameter is VERY important to determine the final MCTS performance.
+             * @param threads The number of threads to use, 0 for all available ones.
              */
-            MCTS(const M& m, unsigned iterations, double exp);
+            MCTS(const M& m, unsigned iterations, double exp, unsigned threads = 1);
 
             /**
              * @brief This function resets the internal graph and samples for the provided state and horizon.
@@ -105,6 +150,47 @@ namespace AIToolbox::MDP {
              */
             size_t sampleAction(size_t a, size_t s1, unsigned horizon);
 
+            /**
+             * @brief This function resets the internal graph and samples for the provided state until a deadline.
+             *
+             * This function works as sampleAction(size_t, unsigned), but
+             * rather than running a fixed number of iterations it keeps
+             * running simulations until the deadline expires. At least
+             * one simulation is always run; each simulation is completed
+             * before the deadline is checked again, so the function may
+             * return after the deadline by up to the duration of a single
+             * simulation.
+             *
+             * When multithreading is enabled, all threads simulate until
+             * the deadline.
+             *
+             * @param s The initial state for the environment.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(size_t s, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
+            /**
+             * @brief This function uses the internal graph to plan until a deadline.
+             *
+             * This function works as sampleAction(size_t, size_t,
+             * unsigned), but it simulates until the deadline as
+             * sampleAction(size_t, unsigned, SearchClock::time_point,
+             * SearchStatistics *).
+             *
+             * @param a The action taken in the last timestep.
+             * @param s1 The state experienced after the action was taken.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(size_t a, size_t s1, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
             /**
              * @brief This function sets the number of performed rollouts in MCTS.
              *
@@ -125,6 +211,149 @@ namespace AIToolbox::MDP {
              */
             void setExploration(double exp);
 
+            /**
+             * @brief This function sets the number of threads used to run the simulations.
+             *
+             * The simulations are split in equal shares between threads.
+             * Each thread uses its own random engine, seeded in order from
+             * the one of this class, both for the rollouts and to sample
+             * the model through sampleSR(s, a, rnd). The model's sampling
+             * index, if any, must thus be eager.
+             *
+             * Multithreading is only used with models that satisfy
+             * has_engine_sampling. A value of 0 uses all available
+             * hardware threads, while 1 disables multithreading.
+             *
+             * \sa setParallelism()
+             *
+             * @param threads The new number of threads.
+             */
+            void setThreads(unsigned threads);
+
+            /**
+             * @brief This function sets how the simulations are parallelized.
+             *
+             * With MCTSParallelism::Root, the first thread grows the
+             * internal graph while the others grow private trees. At the
+             * end, the visits and values of the root actions of all trees
+             * are summed into the internal graph, and the action is picked
+             * following the merge policy (see setRootMerge()). Only the
+             * subtrees of the first thread are kept for reuse.
+             *
+             * With MCTSParallelism::Tree, all threads grow the internal
+             * graph. Nodes are protected by a fixed pool of locks, and
+             * each running simulation lowers the value of the actions it
+             * is going through by the virtual loss (see
+             * setVirtualLoss()), until it has a result to back up.
+             *
+             * @param p The new parallelization mode.
+             */
+            void setParallelism(MCTSParallelism p);
+
+            /**
+             * @brief This function sets how root-parallel search picks the final action.
+             *
+             * @param m The new merge policy.
+             */
+            void setRootMerge(MCTSRootMerge m);
+
+            /**
+             * @brief This function sets the virtual loss used by tree-parallel search.
+             *
+             * Each simulation running through an action is counted as an
+             * additional visit, whose value is the current value of the
+             * action minus this virtual loss. The virtual loss should be
+             * on the scale of the rewards of the problem.
+             *
+             * @param vl The new virtual loss, which must be >= 0.
+             */
+            void setVirtualLoss(double vl);
+
+            /**
+             * @brief This function sets the policy used to pick actions during rollouts.
+             *
+             * By default rollouts pick actions uniformly at random. The
+             * policy is not copied, and must outlive its use in this
+             * class; nullptr restores random rollouts.
+             *
+             * Policies are generally not thread-safe, so in multithreaded
+             * searches the queries to the policy are serialized, and
+             * actions are sampled from getActionProbabilities() with the
+             * random engine of each thread.
+             *
+             * @param p The new rollout policy, or nullptr.
+             */
+            void setRolloutPolicy(const PolicyInterface * p);
+
+            /**
+             * @brief This function sets the function used to estimate the value of truncated rollouts.
+             *
+             * When a rollout is truncated before the horizon (see
+             * setRolloutDepth()), the evaluator is called on the last
+             * state reached, and its discounted result is added to the
+             * return of the rollout. An empty function stops the
+             * estimation, so that truncated rollouts only return the
+             * rewards collected.
+             *
+             * In multithreaded searches the evaluator is called
+             * concurrently.
+             *
+             * @param f The new leaf evaluator.
+             */
+            void setLeafEvaluator(LeafEvaluator f);
+
+            /**
+             * @brief This function sets the leaf evaluator to the greedy value of a QFunction.
+             *
+             * The value of each state is the maximum of its row of the
+             * QFunction, for example as computed by ValueIteration on an
+             * approximate model. The values are copied.
+             *
+             * @param q The QFunction to use, of size S x A.
+             */
+            void setLeafEvaluator(const QFunction & q);
+
+            /**
+             * @brief This function sets the maximum number of steps of each rollout.
+             *
+             * Rollouts never go past the horizon, so by default they are
+             * not truncated. With a depth of zero, new leaves are only
+             * valued by the leaf evaluator.
+             *
+             * @param depth The new maximum rollout depth.
+             */
+            void setRolloutDepth(unsigned depth);
+
+            /**
+             * @brief This function enables searching on a DAG, and sets the size of its transposition table.
+             *
+             * With a non-zero size, nodes are not stored in the internal
+             * graph, but in a transposition table keyed by state and
+             * remaining horizon, so that all paths that reach the same
+             * state with the same remaining horizon share its node.
+             *
+             * Since a node can be reached from many parents, each action
+             * backs up the current value estimate of the node it reached
+             * (the visit-weighted average of the values of its actions)
+             * rather than the return of the single simulation.
+             *
+             * The table is allocated once, and kept between searches,
+             * including those started from a new state, so later
+             * searches can reuse the statistics of any state they reach.
+             * When the table is full, new nodes replace the ones that
+             * have been unused for the longest number of searches; nodes
+             * used by the running search are never replaced, and if there
+             * is no room for a new node its rollout is simply not stored.
+             *
+             * Searches on a DAG always run on a single thread.
+             *
+             * Calling this function clears the table. A size of zero,
+             * the default, goes back to searching on a tree.
+             *
+             * @param size The maximum number of nodes in the table.
+             */
+            void setTranspositionTableSize(size_t size);
+
             /**
              * @brief This function returns the MDP generative model being used.
              *
@@ -135,9 +364,19 @@ namespace AIToolbox::MDP {
             /**
              * @brief This function returns a reference to the internal graph structure holding the results of rollouts.
              *
+             * The root of the graph is the state of the last search; its
+             * children are keyed by state.
+             *
              * @return The internal graph.
              */
-            const StateNode& getGraph() const;
+            const Graph& getGraph() const;
+
+            /**
+             * @brief This function returns a reference to the transposition table used when searching on a DAG.
+             *
+             * @return The transposition table.
+             */
+            const Transpositions& getTranspositionTable() const;
 
             /**
              * @brief This function returns the number of iterations performed to plan for an action.
@@ -153,20 +392,125 @@ namespace AIToolbox::MDP {
              */
             double getExploration() const;
 
+            /**
+             * @brief This function returns the number of threads used to run the simulations.
+             *
+             * @return The number of threads.
+             */
+            unsigned getThreads() const;
+
+            /**
+             * @brief This function returns how the simulations are parallelized.
+             *
+             * @return The parallelization mode.
+             */
+            MCTSParallelism getParallelism() const;
+
+            /**
+             * @brief This function returns how root-parallel search picks the final action.
+             *
+             * @return The merge policy.
+             */
+            MCTSRootMerge getRootMerge() const;
+
+            /**
+             * @brief This function returns the virtual loss used by tree-parallel search.
+             *
+             * @return The virtual loss.
+             */
+            double getVirtualLoss() const;
+
+            /**
+             * @brief This function returns the policy used to pick actions during rollouts.
+             *
+             * @return The rollout policy, or nullptr for random rollouts.
+             */
+            const PolicyInterface * getRolloutPolicy() const;
+
+            /**
+             * @brief This function returns the function used to estimate the value of truncated rollouts.
+             *
+             * @return The leaf evaluator.
+             */
+            const LeafEvaluator & getLeafEvaluator() const;
+
+            /**
+             * @brief This function returns the maximum number of steps of each rollout.
+             *
+             * @return The maximum rollout depth.
+             */
+            unsigned getRolloutDepth() const;
+
+            /**
+             * @brief This function returns the size of the transposition table.
+             *
+             * @return The maximum number of nodes in the table, 0 if searching on a tree.
+             */
+            size_t getTranspositionTableSize() const;
+
         private:
+            // What a single thread needs to run simulations.
+            struct Context {
+                RandomEngine & rand;
+                Graph & graph;
+                // Lock pool for tree parallelism, nullptr otherwise.
+                std::vector<std::mutex> * locks;
+                // Serializes allocations in the shared graph, nullptr otherwise.
+                std::mutex * alloc;
+                // Serializes queries to the rollout policy, nullptr when sequential.
+                std::mutex * policy;
+                // Buffer for the rollout policy, only used when parallel.
+                Vector probs = Vector();
+
+                unsigned simulations = 0;
+                // The deepest node visited.
+                unsigned depth = 0;
+            };
+
             const M& model_;
             size_t S, A;
             unsigned iterations_, maxDepth_;
             double exploration_;
 
-            StateNode graph_;
+            unsigned threads_;
+            MCTSParallelism parallelism_;
+            MCTSRootMerge rootMerge_;
+            double virtualLoss_;
+
+            const PolicyInterface * rolloutPolicy_;
+            LeafEvaluator leafEvaluator_;
+            unsigned rolloutDepth_;
+
+            Graph graph_;
+            // Private trees of root-parallel threads, kept to reuse their memory.
+            std::vector<Graph> helpers_;
+            Transpositions transpositions_;
 
             mutable RandomEngine rand_;
 
             // Private Methods
-            size_t runSimulation(size_t s, unsigned horizon);
-            double simulate(StateNode & sn, size_t s, unsigned horizon);
-            double rollout(size_t s, unsigned horizon);
+            size_t runSimulation(size_t s, unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats);
+            size_t runRootParallel(size_t s, unsigned threads, const SearchClock::time_point * deadline, SearchStatistics & stats);
+            void runTreeParallel(size_t s, unsigned threads, const SearchClock::time_point * deadline, SearchStatistics & stats);
+
+            static void addStatistics(const Context & ctx, SearchStatistics & stats);
+
+            template <bool Parallel, bool Shared>
+            double simulate(Index n, size_t s, unsigned horizon, Context & ctx);
+
+            double simulateTransposed(Index n, size_t s, unsigned depth, Context & ctx);
+
+            template <bool Parallel>
+            double rollout(size_t s, unsigned horizon, Context & ctx);
+
+            template <bool Parallel>
+            size_t sampleRolloutAction(size_t s, Context & ctx);
+
+            template <bool Parallel>
+            std::tuple<size_t, double> sampleSR(size_t s, size_t a, RandomEngine & rnd) const;
+
+            std::unique_lock<std::mutex> lockNode(Index n, Context & ctx) const;
+            std::unique_lock<std::mutex> lockAlloc(Context & ctx) const;
 
             template <typename Iterator>
             Iterator findBestA(Iterator begin, Iterator end);
@@ -176,105 +520,319 @@ namespace AIToolbox::MDP {
     };
 
     template <typename M>
-    MCTS<M>::MCTS(const M& m, const unsigned iter, const double exp) :
+    MCTS<M>::MCTS(const M& m, const unsigned iter, const double exp, const unsigned threads) :
             model_(m), S(model_.getS()), A(model_.getA()), iterations_(iter),
-            exploration_(exp), graph_(), rand_(Impl::Seeder::getSeed()) {}
+            exploration_(exp), threads_(threads), parallelism_(MCTSParallelism::Root),
+            rootMerge_(MCTSRootMerge::Visits), virtualLoss_(1.0),
+            rolloutPolicy_(nullptr), rolloutDepth_(std::numeric_limits<unsigned>::max()),
+            graph_(A), transpositions_(A, 0), rand_(Impl::Seeder::getSeed()) {}
 
     template <typename M>
     size_t MCTS<M>::sampleAction(const size_t s, const unsigned horizon) {
-        // Reset graph
-        graph_ = StateNode();
-        graph_.children.resize(A);
+        graph_.reset();
 
-        return runSimulation(s, horizon);
+        return runSimulation(s, horizon, nullptr, nullptr);
     }
 
     template <typename M>
     size_t MCTS<M>::sampleAction(const size_t a, const size_t s1, const unsigned horizon) {
-        auto & states = graph_.children[a].children;
-
-        auto it = states.find(s1);
-        if ( it == states.end() )
+        if ( !graph_.reroot(a, s1) )
             return sampleAction(s1, horizon);
 
-        // Here we need an additional step, because *it is contained by graph_.
-        // If we just move assign, graph_ is first going to delete everything it
-        // contains (included *it), and then we are going to move unallocated memory
-        // into graph_! So we move *it outside of the graph_ hierarchy, so that
-        // we can then assign safely.
-        { auto tmp = std::move(it->second); graph_ = std::move(tmp); }
+        return runSimulation(s1, horizon, nullptr, nullptr);
+    }
+
+    template <typename M>
+    size_t MCTS<M>::sampleAction(const size_t s, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        graph_.reset();
+
+        return runSimulation(s, horizon, &deadline, stats);
+    }
 
-        // We resize here in case we didn't have time to sample the new
-        // head node. In this case, the new head may not have children.
-        // This would break the UCT call.
-        graph_.children.resize(A);
+    template <typename M>
+    size_t MCTS<M>::sampleAction(const size_t a, const size_t s1, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        if ( !graph_.reroot(a, s1) )
+            return sampleAction(s1, horizon, deadline, stats);
 
-        return runSimulation(s1, horizon);
+        return runSimulation(s1, horizon, &deadline, stats);
     }
 
     template <typename M>
-    size_t MCTS<M>::runSimulation(const size_t s, const unsigned horizon) {
+    size_t MCTS<M>::runSimulation(const size_t s, const unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats) {
+        if ( stats ) *stats = SearchStatistics();
         if ( !horizon ) return 0;
 
         maxDepth_ = horizon;
 
-        for (unsigned i = 0; i < iterations_; ++i )
-            simulate(graph_, s, 0);
+        SearchStatistics result;
+        size_t bestA = A;
+        ActionNode * edges;
 
-        auto begin = std::begin(graph_.children);
-        return std::distance(begin, findBestA(begin, std::end(graph_.children)));
+        if ( transpositions_.getCapacity() ) {
+            // A new generation, so that the nodes of older searches can be
+            // replaced, but not the ones we are going to use.
+            transpositions_.newGeneration();
+            auto root = transpositions_.find(s, horizon);
+            if ( root == Transpositions::None )
+                root = transpositions_.insert(s, horizon);
+            edges = transpositions_.getEdges(root);
+
+            Context ctx{rand_, graph_, nullptr, nullptr, nullptr};
+            ctx.simulations += runSimulations(iterations_, deadline, [&]{ simulateTransposed(root, s, 0, ctx); });
+            addStatistics(ctx, result);
+
+            bestA = std::distance(edges, findBestA(edges, edges + A));
+        } else {
+            // The new head may have never been expanded, and we need its
+            // actions even if we do not simulate at all.
+            graph_.expand(graph_.getRoot());
+            edges = graph_.getEdges(graph_.getRoot());
+        }
+
+        if constexpr (has_engine_sampling_v<M>) {
+            // With a deadline every thread simulates until it expires, so
+            // the iterations do not limit the number of threads.
+            const unsigned T = getNumThreads(threads_, deadline ? std::numeric_limits<size_t>::max() : iterations_);
+            if ( bestA == A && T > 1 ) {
+                if ( parallelism_ == MCTSParallelism::Root ) {
+                    bestA = runRootParallel(s, T, deadline, result);
+                } else {
+                    runTreeParallel(s, T, deadline, result);
+                    bestA = std::distance(edges, findBestA(edges, edges + A));
+                }
+            }
+        }
+
+        if ( bestA == A ) {
+            Context ctx{rand_, graph_, nullptr, nullptr, nullptr};
+            ctx.simulations += runSimulations(iterations_, deadline, [&]{ simulate<false, false>(graph_.getRoot(), s, 0, ctx); });
+            addStatistics(ctx, result);
+
+            bestA = std::distance(edges, findBestA(edges, edges + A));
+        }
+
+        if ( stats ) {
+            result.rootVisits.resize(A);
+            for ( size_t a = 0; a < A; ++a )
+                result.rootVisits[a] = edges[a].N;
+            *stats = std::move(result);
+        }
+        return bestA;
     }
 
     template <typename M>
-    double MCTS<M>::simulate(StateNode & sn, const size_t s, const unsigned depth) {
-        // Head update
-        sn.N++;
+    size_t MCTS<M>::runRootParallel(const size_t s, const unsigned T, const SearchClock::time_point * deadline, SearchStatistics & stats) {
+        // The first thread grows graph_, so that the tree can still be
+        // reused; the others grow private trees.
+        while ( helpers_.size() < T - 1 )
+            helpers_.emplace_back(A);
+        for ( unsigned t = 0; t < T - 1; ++t )
+            helpers_[t].reset();
+
+        // Seeds are drawn in thread order, so the outcome does not depend
+        // on scheduling.
+        std::vector<RandomEngine> engines;
+        engines.reserve(T);
+        for ( unsigned t = 0; t < T; ++t )
+            engines.emplace_back(rand_());
+
+        std::mutex policy;
+        std::vector<Context> contexts;
+        contexts.reserve(T);
+        for ( unsigned t = 0; t < T; ++t )
+            contexts.push_back(Context{engines[t], t == 0 ? graph_ : helpers_[t - 1], nullptr, nullptr, &policy});
+
+        parallelFor(deadline ? T : iterations_, T, [&](const size_t begin, const size_t end, const unsigned t) {
+            auto & ctx = contexts[t];
+            ctx.simulations += runSimulations(end - begin, deadline, [&]{ simulate<true, false>(ctx.graph.getRoot(), s, 0, ctx); });
+        });
+
+        for ( const auto & ctx : contexts )
+            addStatistics(ctx, stats);
+
+        // Merge the roots into graph_, as if all simulations had been run
+        // on it.
+        const auto root = graph_.getRoot();
+        const auto dstEdges = graph_.getEdges(root);
+        for ( unsigned t = 0; t < T - 1; ++t ) {
+            const auto & tree = helpers_[t];
+            const auto troot = tree.getRoot();
+            if ( !tree.isExpanded(troot) ) continue;
+
+            graph_.getNode(root).N += tree.getNode(troot).N;
+            const auto srcEdges = tree.getEdges(troot);
+            for ( size_t a = 0; a < A; ++a ) {
+                auto & dst = dstEdges[a];
+                const auto & src = srcEdges[a];
+                if ( !src.N ) continue;
 
-        auto begin = std::begin(sn.children);
-        const size_t a = std::distance(begin, findBestBonusA(begin, std::end(sn.children), sn.N));
+                dst.N += src.N;
+                dst.V += ( src.V - dst.V ) * ( src.N / static_cast<double>(dst.N) );
+            }
+        }
+
+        if ( rootMerge_ == MCTSRootMerge::Visits ) {
+            return std::distance(dstEdges, std::max_element(dstEdges, dstEdges + A,
+                [](const ActionNode & lhs, const ActionNode & rhs){ return lhs.N < rhs.N; }));
+        }
+        return std::distance(dstEdges, findBestA(dstEdges, dstEdges + A));
+    }
+
+    template <typename M>
+    void MCTS<M>::runTreeParallel(const size_t s, const unsigned T, const SearchClock::time_point * deadline, SearchStatistics & stats) {
+        // A fixed pool of locks; each node maps to one of them by index.
+        // Collisions only cost some contention.
+        std::vector<std::mutex> locks(64 * T);
+        std::mutex alloc;
+
+        std::vector<RandomEngine> engines;
+        engines.reserve(T);
+        for ( unsigned t = 0; t < T; ++t )
+            engines.emplace_back(rand_());
+
+        std::mutex policy;
+        std::vector<Context> contexts;
+        contexts.reserve(T);
+        for ( unsigned t = 0; t < T; ++t )
+            contexts.push_back(Context{engines[t], graph_, &locks, &alloc, &policy});
 
-        auto [s1, rew] = model_.sampleSR(s, a);
+        parallelFor(deadline ? T : iterations_, T, [&](const size_t begin, const size_t end, const unsigned t) {
+            auto & ctx = contexts[t];
+            ctx.simulations += runSimulations(end - begin, deadline, [&]{ simulate<true, true>(graph_.getRoot(), s, 0, ctx); });
+        });
 
-        auto & aNode = sn.children[a];
+        for ( const auto & ctx : contexts )
+            addStatistics(ctx, stats);
+    }
+
+    template <typename M>
+    void MCTS<M>::addStatistics(const Context & ctx, SearchStatistics & stats) {
+        stats.simulations += ctx.simulations;
+        stats.maxDepth = std::max(stats.maxDepth, ctx.depth);
+    }
+
+    template <typename M>
+    template <bool Parallel, bool Shared>
+    double MCTS<M>::simulate(const Index n, const size_t s, const unsigned depth, Context & ctx) {
+        ctx.depth = std::max(ctx.depth, depth);
+
+        auto & graph = ctx.graph;
+        auto & sn = graph.getNode(n);
+
+        ActionNode * edges;
+        size_t a;
+        {
+            auto lock = lockNode(n, ctx);
+
+            // Since most memory is allocated on the leaves, we do not
+            // allocate on node creation but only when we are actually
+            // descending into a node.
+            if ( !graph.isExpanded(n) ) {
+                auto allocLock = lockAlloc(ctx);
+                graph.expand(n);
+            }
+            edges = graph.getEdges(n);
+
+            // Head update
+            sn.N++;
+
+            a = std::distance(edges, findBestBonusA(edges, edges + A, sn.N));
+
+            if constexpr (Shared) edges[a].pending++;
+        }
+
+        auto [s1, rew] = sampleSR<Parallel>(s, a, ctx.rand);
+
+        auto & aNode = edges[a];
 
         // We only go deeper if needed (maxDepth_ is always at least 1).
         if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) ) {
-            const auto end = std::end(aNode.children);
-            auto it = aNode.children.find(s1);
+            Index child;
+            {
+                // The children of an action are protected by the lock of
+                // its parent state. References to them are stable, as
+                // the graph never moves its nodes.
+                auto lock = lockNode(n, ctx);
+                child = graph.findChild(n, a, s1);
+                if ( child == Graph::None ) {
+                    auto allocLock = lockAlloc(ctx);
+                    graph.addChild(n, a, s1);
+                }
+            }
 
             double futureRew;
-            if ( it == end ) {
-                // Touch node to create it
-                aNode.children[s1];
-                futureRew = rollout(s1, depth + 1);
-            }
-            else {
-                // Since most memory is allocated on the leaves,
-                // we do not allocate on node creation but only when
-                // we are actually descending into a node. If the node
-                // already has memory this should not do anything in
-                // any case.
-                it->second.children.resize(A);
-                futureRew = simulate( it->second, s1, depth + 1 );
-            }
+            if ( child == Graph::None )
+                futureRew = rollout<Parallel>(s1, depth + 1, ctx);
+            else
+                futureRew = simulate<Parallel, Shared>( child, s1, depth + 1, ctx );
 
             rew += model_.getDiscount() * futureRew;
         }
 
         // Action update
+        {
+            auto lock = lockNode(n, ctx);
+            if constexpr (Shared) aNode.pending--;
+
+            aNode.N++;
+            aNode.V += ( rew - aNode.V ) / static_cast<double>(aNode.N);
+        }
+
+        return rew;
+    }
+
+    template <typename M>
+    double MCTS<M>::simulateTransposed(const Index n, const size_t s, const unsigned depth, Context & ctx) {
+        ctx.depth = std::max(ctx.depth, depth);
+
+        auto & sn = transpositions_.getNode(n);
+        const auto edges = transpositions_.getEdges(n);
+
+        sn.N++;
+        const size_t a = std::distance(edges, findBestBonusA(edges, edges + A, sn.N));
+
+        auto [s1, rew] = sampleSR<false>(s, a, ctx.rand);
+
+        if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) ) {
+            const unsigned togo = maxDepth_ - depth - 1;
+            const auto child = transpositions_.find(s1, togo);
+
+            double futureRew;
+            if ( child == Transpositions::None ) {
+                // If there is no room the node is not stored, and the
+                // next simulation reaching it will try again.
+                transpositions_.insert(s1, togo);
+                futureRew = rollout<false>(s1, depth + 1, ctx);
+            } else {
+                futureRew = simulateTransposed(child, s1, depth + 1, ctx);
+            }
+
+            rew += model_.getDiscount() * futureRew;
+        }
+
+        auto & aNode = edges[a];
         aNode.N++;
         aNode.V += ( rew - aNode.V ) / static_cast<double>(aNode.N);
 
-        return rew;
+        // Other parents also update this node, so we back up its value
+        // rather than the return of this simulation; this keeps the
+        // values of all parents consistent with the statistics of
+        // the node.
+        double v = 0.0;
+        for ( size_t b = 0; b < A; ++b )
+            v += edges[b].N * edges[b].V;
+
+        return v / sn.N;
     }
 
     template <typename M>
-    double MCTS<M>::rollout(size_t s, unsigned depth) {
+    template <bool Parallel>
+    double MCTS<M>::rollout(size_t s, unsigned depth, Context & ctx) {
         double rew = 0.0, totalRew = 0.0, gamma = 1.0;
 
-        std::uniform_int_distribution<size_t> generator(0, A-1);
-        for ( ; depth < maxDepth_; ++depth ) {
-            std::tie( s, rew ) = model_.sampleSR( s, generator(rand_) );
+        const unsigned end = depth + std::min(rolloutDepth_, maxDepth_ - depth);
+        for ( ; depth < end; ++depth ) {
+            std::tie( s, rew ) = sampleSR<Parallel>( s, sampleRolloutAction<Parallel>(s, ctx), ctx.rand );
             totalRew += gamma * rew;
 
             if (model_.isTerminal(s))
@@ -282,9 +840,55 @@ namespace AIToolbox::MDP {
 
             gamma *= model_.getDiscount();
         }
+        // If we stopped before the horizon, we estimate the rest.
+        if ( depth < maxDepth_ && leafEvaluator_ )
+            totalRew += gamma * leafEvaluator_(s);
+
         return totalRew;
     }
 
+    template <typename M>
+    template <bool Parallel>
+    size_t MCTS<M>::sampleRolloutAction(const size_t s, Context & ctx) {
+        if ( !rolloutPolicy_ )
+            return std::uniform_int_distribution<size_t>(0, A-1)(ctx.rand);
+
+        if constexpr (Parallel) {
+            ctx.probs.resize(A);
+            {
+                std::lock_guard<std::mutex> lock(*ctx.policy);
+                rolloutPolicy_->getActionProbabilities(s, ctx.probs);
+            }
+            return sampleProbability(A, ctx.probs, ctx.rand);
+        } else {
+            return rolloutPolicy_->sampleAction(s);
+        }
+    }
+
+    template <typename M>
+    template <bool Parallel>
+    std::tuple<size_t, double> MCTS<M>::sampleSR(const size_t s, const size_t a, RandomEngine & rnd) const {
+        // Sequential search keeps using the model's own engine.
+        if constexpr (Parallel) return model_.sampleSR(s, a, rnd);
+        else return model_.sampleSR(s, a);
+    }
+
+    template <typename M>
+    std::unique_lock<std::mutex> MCTS<M>::lockNode(const Index n, Context & ctx) const {
+        if ( !ctx.locks ) return {};
+
+        auto & locks = *ctx.locks;
+        return std::unique_lock<std::mutex>(locks[n % locks.size()]);
+    }
+
+    template <typename M>
+    std::unique_lock<std::mutex> MCTS<M>::lockAlloc(Context & ctx) const {
+        // Always taken after the lock of a node, never before.
+        if ( !ctx.alloc ) return {};
+
+        return std::unique_lock<std::mutex>(*ctx.alloc);
+    }
+
     template <typename M>
     template <typename Iterator>
     Iterator MCTS<M>::findBestA(Iterator begin, Iterator end) {
@@ -300,7 +904,13 @@ namespace AIToolbox::MDP {
         // We use this function to produce a score for each action. This can be easily
         // substituted with something else to produce different POMCP variants.
         const auto evaluationFunction = [this, logCount](const ActionNode & an){
-            return an.V + exploration_ * std::sqrt( logCount / an.N );
+            if ( !an.pending )
+                return an.V + exploration_ * std::sqrt( logCount / an.N );
+
+            // Running simulations count as visits worth the virtual loss
+            // less than the current value.
+            const double n = an.N + an.pending;
+            return an.V - virtualLoss_ * an.pending / n + exploration_ * std::sqrt( logCount / n );
         };
 
         auto bestIterator = begin++;
@@ -327,16 +937,72 @@ namespace AIToolbox::MDP {
         exploration_ = exp;
     }
 
+    template <typename M>
+    void MCTS<M>::setThreads(const unsigned threads) {
+        threads_ = threads;
+    }
+
+    template <typename M>
+    void MCTS<M>::setParallelism(const MCTSParallelism p) {
+        parallelism_ = p;
+    }
+
+    template <typename M>
+    void MCTS<M>::setRootMerge(const MCTSRootMerge m) {
+        rootMerge_ = m;
+    }
+
+    template <typename M>
+    void MCTS<M>::setVirtualLoss(const double vl) {
+        if ( vl < 0.0 ) throw std::invalid_argument("Virtual loss must be >= 0");
+        virtualLoss_ = vl;
+    }
+
+    template <typename M>
+    void MCTS<M>::setRolloutPolicy(const PolicyInterface * p) {
+        if ( p && (p->getS() != S || p->getA() != A) )
+            throw std::invalid_argument("The rollout policy has a different state or action space than the model");
+        rolloutPolicy_ = p;
+    }
+
+    template <typename M>
+    void MCTS<M>::setLeafEvaluator(LeafEvaluator f) {
+        leafEvaluator_ = std::move(f);
+    }
+
+    template <typename M>
+    void MCTS<M>::setLeafEvaluator(const QFunction & q) {
+        if ( static_cast<size_t>(q.rows()) != S || static_cast<size_t>(q.cols()) != A )
+            throw std::invalid_argument("The QFunction has a different size than the model");
+
+        leafEvaluator_ = [v = Vector(q.rowwise().maxCoeff())](const size_t s) { return v[s]; };
+    }
+
+    template <typename M>
+    void MCTS<M>::setRolloutDepth(const unsigned depth) {
+        rolloutDepth_ = depth;
+    }
+
+    template <typename M>
+    void MCTS<M>::setTranspositionTableSize(const size_t size) {
+        transpositions_ = Transpositions(A, size);
+    }
+
     template <typename M>
     const M& MCTS<M>::getModel() const {
         return model_;
     }
 
     template <typename M>
-    const typename MCTS<M>::StateNode& MCTS<M>::getGraph() const {
+    const typename MCTS<M>::Graph& MCTS<M>::getGraph() const {
         return graph_;
     }
 
+    template <typename M>
+    const typename MCTS<M>::Transpositions& MCTS<M>::getTranspositionTable() const {
+        return transpositions_;
+    }
+
     template <typename M>
     unsigned MCTS<M>::getIterations() const {
         return iterations_;
@@ -346,6 +1012,46 @@ namespace AIToolbox::MDP {
     double MCTS<M>::getExploration() const {
         return exploration_;
     }
+
+    template <typename M>
+    unsigned MCTS<M>::getThreads() const {
+        return threads_;
+    }
+
+    template <typename M>
+    MCTSParallelism MCTS<M>::getParallelism() const {
+        return parallelism_;
+    }
+
+    template <typename M>
+    MCTSRootMerge MCTS<M>::getRootMerge() const {
+        return rootMerge_;
+    }
+
+    template <typename M>
+    double MCTS<M>::getVirtualLoss() const {
+        return virtualLoss_;
+    }
+
+    template <typename M>
+    const PolicyInterface * MCTS<M>::getRolloutPolicy() const {
+        return rolloutPolicy_;
+    }
+
+    template <typename M>
+    const typename MCTS<M>::LeafEvaluator & MCTS<M>::getLeafEvaluator() const {
+        return leafEvaluator_;
+    }
+
+    template <typename M>
+    unsigned MCTS<M>::getRolloutDepth() const {
+        return rolloutDepth_;
+    }
+
+    template <typename M>
+    size_t MCTS<M>::getTranspositionTableSize() const {
+        return transpositions_.getCapacity();
+    }
 }
 
 #endif
@@ -0,0 +1,316 @@
+#ifndef AI_TOOLBOX_MDP_MODIFIED_POLICY_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_MODIFIED_POLICY_ITERATION_HEADER_FILE
+
+#include <algorithm>
+#include <numeric>
+
+#include <AIToolbox/Impl/Logging.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/TypeTraits.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/Utils/Core.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class applies the modified policy iteration algorithm on a Model.
+     *
+     * This algorithm sits in between ValueIteration and PolicyIteration.
+     * At each iteration it performs a Bellman backup to find the greedy
+     * policy for the current values (the improvement step), and then
+     * partially evaluates that policy by applying its Bellman operator
+     * a fixed number of times. Evaluation sweeps only need a single
+     * action per state, so they are much cheaper than full backups.
+     *
+     * Additionally, when the discount is less than 1, this class can use
+     * the MacQueen bounds on the optimal values to permanently discard
+     * state-action pairs that cannot be optimal. Given the current values
+     * v and their backup Tv, the optimal values are bounded by
+     *
+     *     Tv + discount / (1 - discount) * min(Tv - v) <= v* <= Tv + discount / (1 - discount) * max(Tv - v)
+     *
+     * so any action whose backup, even with the upper bound, cannot reach
+     * the lower bound of its state is suboptimal. Eliminated actions are
+     * not backed up anymore during the improvement steps, which on models
+     * with many dominated actions greatly reduces the cost of each
+     * iteration.
+     *
+     * The returned QFunction is computed once at the end, from the final
+     * values, and so contains all actions, including the eliminated ones.
+     */
+    class ModifiedPolicyIteration {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * constructor will throw an std::invalid_argument. A
+             * tolerance of 0.0 forces ModifiedPolicyIteration to perform
+             * a number of improvement steps equal to the horizon
+             * specified. Otherwise, it will stop as soon as the maximum
+             * change in values during an improvement step is less than
+             * the tolerance specified.
+             *
+             * Note that the default value function size needs to match
+             * the number of states of the Model. Otherwise it will
+             * be ignored. An empty value function will be defaulted
+             * to all zeroes.
+             *
+             * @param horizon The maximum number of improvement steps to perform.
+             * @param tolerance The tolerance factor to stop the improvement loop.
+             * @param sweeps The number of evaluation sweeps after each improvement step.
+             * @param actionElimination Whether to discard provably suboptimal actions.
+             * @param v The initial value function from which to start the loop.
+             */
+            ModifiedPolicyIteration(unsigned horizon, double tolerance = 0.001, unsigned sweeps = 10, bool actionElimination = true, ValueFunction v = {Values(), Actions(0)});
+
+            /**
+             * @brief This function applies modified policy iteration on an MDP to solve it.
+             *
+             * The algorithm is constrained by the currently set parameters.
+             *
+             * @tparam M The type of the solvable MDP.
+             * @param m The MDP that needs to be solved.
+             *
+             * @return A tuple containing the maximum variation for the
+             *         ValueFunction, the ValueFunction and the QFunction for
+             *         the Model.
+             */
+            template <typename M, typename = std::enable_if_t<is_model_v<M>>>
+            std::tuple<double, ValueFunction, QFunction> operator()(const M & m);
+
+            /**
+             * @brief This function sets the tolerance parameter.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * function will throw an std::invalid_argument.
+             *
+             * @param e The new tolerance parameter.
+             */
+            void setTolerance(double e);
+
+            /**
+             * @brief This function sets the horizon parameter.
+             *
+             * @param h The new horizon parameter.
+             */
+            void setHorizon(unsigned h);
+
+            /**
+             * @brief This function sets the number of evaluation sweeps after each improvement step.
+             *
+             * With 0 sweeps this algorithm is equivalent to
+             * ValueIteration (with action elimination).
+             *
+             * @param sweeps The new number of evaluation sweeps.
+             */
+            void setEvaluationSweeps(unsigned sweeps);
+
+            /**
+             * @brief This function sets whether provably suboptimal actions are discarded.
+             *
+             * Action elimination is only performed when the discount of
+             * the Model is less than 1.
+             *
+             * @param actionElimination Whether to use action elimination.
+             */
+            void setActionElimination(bool actionElimination);
+
+            /**
+             * @brief This function sets the starting value function.
+             *
+             * An empty value function defaults to all zeroes. Note
+             * that the default value function size needs to match
+             * the number of states of the Model that needs to be
+             * solved. Otherwise it will be ignored.
+             *
+             * @param v The new starting value function.
+             */
+            void setValueFunction(ValueFunction v);
+
+            /**
+             * @brief This function will return the currently set tolerance parameter.
+             *
+             * @return The currently set tolerance parameter.
+             */
+            double getTolerance() const;
+
+            /**
+             * @brief This function will return the current horizon parameter.
+             *
+             * @return The currently set horizon parameter.
+             */
+            unsigned getHorizon() const;
+
+            /**
+             * @brief This function returns the number of evaluation sweeps after each improvement step.
+             *
+             * @return The currently set number of evaluation sweeps.
+             */
+            unsigned getEvaluationSweeps() const;
+
+            /**
+             * @brief This function returns whether provably suboptimal actions are discarded.
+             *
+             * @return Whether action elimination is enabled.
+             */
+            bool getActionElimination() const;
+
+            /**
+             * @brief This function will return the current set default value function.
+             *
+             * @return The currently set default value function.
+             */
+            const ValueFunction & getValueFunction() const;
+
+            /**
+             * @brief This function returns the number of improvement steps performed during the last solve.
+             *
+             * @return The number of improvement steps performed in the last call to operator().
+             */
+            unsigned getIterations() const;
+
+            /**
+             * @brief This function returns the number of state-action pairs eliminated during the last solve.
+             *
+             * @return The number of pairs eliminated in the last call to operator().
+             */
+            size_t getEliminatedActions() const;
+
+            /**
+             * @brief This function returns the number of state-action backups performed by the improvement steps of the last solve.
+             *
+             * Without action elimination each improvement step backs up
+             * all state-action pairs; eliminated pairs are skipped. The
+             * evaluation sweeps, which back up a single action per state,
+             * are not counted.
+             *
+             * @return The number of improvement backups in the last call to operator().
+             */
+            size_t getBackups() const;
+
+        private:
+            // Parameters
+            double tolerance_;
+            unsigned horizon_;
+            unsigned sweeps_;
+            bool actionElimination_;
+            ValueFunction vParameter_;
+
+            // Internals
+            ValueFunction v1_;
+            unsigned iterations_;
+            size_t eliminated_, backups_;
+    };
+
+    template <typename M, typename>
+    std::tuple<double, ValueFunction, QFunction> ModifiedPolicyIteration::operator()(const M & model) {
+        // Extract necessary knowledge from model so we don't have to pass it around
+        const size_t S = model.getS();
+        const size_t A = model.getA();
+        const double discount = model.getDiscount();
+
+        {
+            // Verify that parameter value function is compatible.
+            const size_t size = vParameter_.values.size();
+            if ( size != S ) {
+                if ( size != 0 ) {
+                    AI_LOGGER(AI_SEVERITY_WARNING, "Size of starting value function is incorrect, ignoring...");
+                }
+                // Defaulting
+                v1_ = makeValueFunction(S);
+            }
+            else
+                v1_ = vParameter_;
+        }
+
+        const auto & ir = [&]{
+            if constexpr (is_model_eigen_v<M>) return model.getRewardFunction();
+            else return computeImmediateRewards(model);
+        }();
+
+        iterations_ = 0;
+        eliminated_ = 0;
+        backups_ = 0;
+        double variation = tolerance_ * 2; // Make it bigger
+
+        auto & values = v1_.values;
+        auto & actions = v1_.actions;
+
+        // The actions which can still be optimal for each state.
+        std::vector<std::vector<size_t>> active(S, std::vector<size_t>(A));
+        for ( auto & acts : active )
+            std::iota(std::begin(acts), std::end(acts), 0);
+
+        // Each row holds the backups of the active actions of a state, in
+        // the same order as in active.
+        std::vector<std::vector<double>> backups(S, std::vector<double>(A));
+
+        const bool eliminate = actionElimination_ && discount < 1.0;
+        const double boundFactor = eliminate ? discount / (1.0 - discount) : 0.0;
+
+        Values val0;
+        const bool useTolerance = checkDifferentSmall(tolerance_, 0.0);
+        while ( iterations_ < horizon_ && (!useTolerance || variation > tolerance_) ) {
+            ++iterations_;
+            AI_LOGGER(AI_SEVERITY_DEBUG, "Processing iteration " << iterations_);
+
+            // Improvement step: greedy backup over the active actions.
+            val0 = values;
+            for ( size_t s = 0; s < S; ++s ) {
+                const auto & acts = active[s];
+                auto & bs = backups[s];
+
+                size_t best = 0;
+                for ( size_t i = 0; i < acts.size(); ++i ) {
+                    bs[i] = computeQValue(model, ir, val0, s, acts[i]);
+                    if ( bs[i] > bs[best] ) best = i;
+                }
+                backups_ += acts.size();
+                values[s] = bs[best];
+                actions[s] = acts[best];
+            }
+
+            const Values diff = values - val0;
+            variation = diff.cwiseAbs().maxCoeff();
+
+            if ( eliminate ) {
+                // MacQueen bounds: Q*(s,a) <= backup(s,a) + factor * max(diff),
+                // while V*(s) >= values(s) + factor * min(diff).
+                const double gap = boundFactor * (diff.maxCoeff() - diff.minCoeff());
+
+                for ( size_t s = 0; s < S; ++s ) {
+                    auto & acts = active[s];
+                    auto & bs = backups[s];
+                    const double threshold = values[s] - gap;
+
+                    size_t kept = 0;
+                    for ( size_t i = 0; i < acts.size(); ++i ) {
+                        // The greedy action is never eliminated.
+                        if ( acts[i] != actions[s] && bs[i] < threshold ) continue;
+                        acts[kept] = acts[i];
+                        bs[kept] = bs[i];
+                        ++kept;
+                    }
+                    eliminated_ += acts.size() - kept;
+                    acts.resize(kept);
+                }
+            }
+
+            if ( useTolerance && variation <= tolerance_ ) break;
+
+            // Partial evaluation of the greedy policy.
+            for ( unsigned k = 0; k < sweeps_; ++k ) {
+                val0 = values;
+                for ( size_t s = 0; s < S; ++s )
+                    values[s] = computeQValue(model, ir, val0, s, actions[s]);
+            }
+        }
+
+        // We only build the QFunction once, from the final values.
+        QFunction q = computeQFunction(model, values * discount, ir);
+
+        return std::make_tuple(useTolerance ? variation : 0.0, std::move(v1_), std::move(q));
+    }
+}
+
+#endif
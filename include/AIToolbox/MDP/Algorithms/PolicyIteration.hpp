@@ -21,16 +21,29 @@ namespace AIToolbox::MDP {
      *
      * When the policy does not change anymore, it is guaranteed to be
      * optimal, and the found QFunction is returned.
+     *
+     * For discounts close to 1, the evaluation of each policy can be done
+     * by directly solving the linear system of its values, rather than
+     * sweeping until convergence; see PolicyEvaluation::setLinearSolve().
+     * Each evaluation is warm-started from the values of the previous
+     * policy, which are usually very close to the new ones.
      */
     class PolicyIteration {
         public:
             /**
              * @brief Basic constructor.
              *
+             * If linearSolve is true, the horizon and tolerance are
+             * passed to the solver instead: the horizon is the maximum
+             * number of BiCGSTAB iterations per evaluation, and the
+             * tolerance its stopping relative residual. See
+             * PolicyEvaluation::setLinearSolve().
+             *
              * @param horizon The horizon parameter to use during the PolicyEvaluation phase.
              * @param tolerance The tolerance parameter to use during the PolicyEvaluation phase.
+             * @param linearSolve Whether PolicyEvaluation should solve for the values directly.
              */
-            PolicyIteration(unsigned horizon, double tolerance = 0.001);
+            PolicyIteration(unsigned horizon, double tolerance = 0.001, bool linearSolve = false);
 
             /**
              * @brief This function applies policy iteration on an MDP to solve it.
@@ -55,6 +68,15 @@ namespace AIToolbox::MDP {
              */
             void setHorizon(unsigned h);
 
+            /**
+             * @brief This function sets whether PolicyEvaluation should solve for the values directly.
+             *
+             * In this mode the horizon and tolerance are used as the
+             * maximum number of iterations and the relative residual of
+             * the linear solver.
+             */
+            void setLinearSolve(bool l);
+
             /**
              * @brief This function returns the currently set tolerance parameter.
              */
@@ -65,9 +87,15 @@ namespace AIToolbox::MDP {
              */
             unsigned getHorizon() const;
 
+            /**
+             * @brief This function returns whether PolicyEvaluation solves for the values directly.
+             */
+            bool getLinearSolve() const;
+
         private:
             unsigned horizon_;
             double tolerance_;
+            bool linearSolve_;
     };
 
     template <typename M, typename>
@@ -76,6 +104,7 @@ namespace AIToolbox::MDP {
         const auto A = m.getA();
 
         PolicyEvaluation<M> eval(m, horizon_, tolerance_);
+        eval.setLinearSolve(linearSolve_);
 
         auto qfun = makeQFunction(m.getS(), m.getA());
         QGreedyPolicy p(qfun);
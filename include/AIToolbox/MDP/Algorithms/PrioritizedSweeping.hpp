@@ -1,16 +1,15 @@
 #ifndef AI_TOOLBOX_MDP_PRIORITIZED_SWEEPING_HEADER_FILE
 #define AI_TOOLBOX_MDP_PRIORITIZED_SWEEPING_HEADER_FILE
 
-#include <tuple>
-#include <unordered_map>
-
-#include <boost/heap/fibonacci_heap.hpp>
+#include <vector>
+#include <algorithm>
 
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
 
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/IndexedHeap.hpp>
 
 namespace AIToolbox::MDP {
     /**
@@ -37,6 +36,14 @@ namespace AIToolbox::MDP {
      * determine which state-action pairs are actually useful, so there's
      * no need to compute it manually.
      *
+     * To find the parents of an updated state quickly, this class keeps
+     * an index of the predecessors of each state, i.e. the state-action
+     * pairs that can transition to it. The index is built from the model
+     * on construction, and the row of each pair passed to stepUpdateQ()
+     * is re-scanned so that new transitions in learned models (like
+     * MaximumLikelihoodModel) are picked up automatically. If the model
+     * changes in other ways, call updatePredecessors().
+     *
      * Given how this algorithm updates the QFunction, the only problems
      * supported by this approach are ones with an infinite horizon.
      */
@@ -61,6 +68,10 @@ namespace AIToolbox::MDP {
              * whether any parent couple that can lead to this state is worth pushing
              * into the queue.
              *
+             * The predecessor index is refreshed for the input pair
+             * before the update, so this function should be called after
+             * the model has been synced with the new experience.
+             *
              * @param s The previous state.
              * @param a The action performed.
              */
@@ -77,6 +88,29 @@ namespace AIToolbox::MDP {
              */
             void batchUpdateQ();
 
+            /**
+             * @brief This function rebuilds the predecessor index from the model.
+             *
+             * This function scans the whole transition function of the
+             * model, so it should only be called when the model changed in
+             * ways that stepUpdateQ() cannot detect by itself.
+             */
+            void updatePredecessors();
+
+            /**
+             * @brief This function adds the transitions of the input pair to the predecessor index.
+             *
+             * This function scans the transitions from the input
+             * state-action pair, and registers the pair as a predecessor of
+             * all the states it can reach. Entries for transitions which
+             * have since become impossible are left in place, as they are
+             * harmless.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             */
+            void updatePredecessors(size_t s, size_t a);
+
             /**
              * @brief This function sets the theta parameter.
              *
@@ -129,6 +163,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function allows you to set the value of the internal QFunction.
              *
@@ -148,41 +193,52 @@ namespace AIToolbox::MDP {
             const ValueFunction & getValueFunction() const;
 
         private:
+            void updateQ(size_t s, size_t a);
+            void addPredecessor(size_t s, size_t a, size_t s1);
+
             size_t S, A;
             unsigned N;
             double theta_;
 
             const M & model_;
             QFunction qfun_;
+            size_t version_;
             ValueFunction vfun_;
 
-            struct PriorityQueueElement {
-                double priority;
-                std::pair<size_t, size_t> stateAction;
-                bool operator<(const PriorityQueueElement& arg2) const {
-                    return priority < arg2.priority;
-                }
-            };
+            // For each state, the sorted list of the state-action pairs
+            // (as s * A + a) that can lead to it.
+            std::vector<std::vector<size_t>> predecessors_;
 
-            using QueueType = boost::heap::fibonacci_heap<PriorityQueueElement>;
-
-            QueueType queue_;
-
-            std::unordered_map<std::pair<size_t, size_t>, typename QueueType::handle_type, boost::hash<std::pair<size_t, size_t>>> queueHandles_;
+            // Queue of the state-action pairs (as s * A + a) to update.
+            IndexedHeap<> queue_;
     };
 
     template <typename M>
     PrioritizedSweeping<M>::PrioritizedSweeping(const M & m, const double theta, const unsigned n) :
             S(m.getS()), A(m.getA()), N(n), theta_(theta), model_(m),
-            qfun_(makeQFunction(S,A)), vfun_(makeValueFunction(S)) {}
+            qfun_(makeQFunction(S,A)), version_(0), vfun_(makeValueFunction(S)), queue_(S*A)
+    {
+        updatePredecessors();
+    }
 
     template <typename M>
     void PrioritizedSweeping<M>::stepUpdateQ(const size_t s, const size_t a) {
+        updatePredecessors(s, a);
+        updateQ(s, a);
+    }
+
+    template <typename M>
+    void PrioritizedSweeping<M>::updateQ(const size_t s, const size_t a) {
         auto & values = vfun_.values;
 
         // Update q[s][a]
-        if constexpr(is_model_eigen_v<M>) {
-            qfun_(s,a) = model_.getRewardFunction().coeff(s, a) + model_.getTransitionFunction(a).row(s).dot(values * model_.getDiscount());
+        if constexpr(is_model_stacked_v<M>) {
+            if ( model_.isStackedTransitionsEnabled() )
+                qfun_(s,a) = model_.getRewardFunction().coeff(s, a) + model_.getDiscount() * model_.getStackedTransitionFunction().row(s * A + a).template cast<double>().dot(values);
+            else
+                qfun_(s,a) = model_.getRewardFunction().coeff(s, a) + model_.getDiscount() * model_.getTransitionFunction(a).row(s).template cast<double>().dot(values);
+        } else if constexpr(is_model_eigen_v<M>) {
+            qfun_(s,a) = model_.getRewardFunction().coeff(s, a) + model_.getTransitionFunction(a).row(s).template cast<double>().dot(values * model_.getDiscount());
         } else {
             double newQValue = 0;
             for ( size_t s1 = 0; s1 < S; ++s1 ) {
@@ -193,6 +249,8 @@ namespace AIToolbox::MDP {
             qfun_(s, a) = newQValue;
         }
 
+        ++version_;
+
         double p = values[s];
         {
             // Update value and action
@@ -201,27 +259,62 @@ namespace AIToolbox::MDP {
 
         p = std::fabs(values[s] - p);
 
-        for ( size_t ss = 0; ss < S; ++ss ) {
-            for ( size_t a = 0; a < A; ++a ) {
-                const double delta = p * model_.getTransitionProbability(ss,a,s);
-                // If it changed enough, we're going to update its parents.
-                if ( delta > theta_ ) {
-                    const auto pair = std::make_pair(ss, a);
-                    auto it = queueHandles_.find(pair);
-
-                    if (it != std::end(queueHandles_)) {
-                        if ((*it->second).priority < delta) {
-                            (*it->second).priority = delta;
-                            queue_.increase(it->second);
-                        }
-                    } else {
-                        queueHandles_[pair] = queue_.emplace(PriorityQueueElement{delta, pair});
-                    }
-                }
+        // If nothing can change enough we can skip looking at the parents.
+        if ( p <= theta_ ) return;
+
+        for ( const auto sa : predecessors_[s] ) {
+            const double delta = p * model_.getTransitionProbability(sa / A, sa % A, s);
+            // If it changed enough, we're going to update its parents.
+            if ( delta > theta_ )
+                queue_.pushOrIncrease(sa, delta);
+        }
+    }
+
+    template <typename M>
+    void PrioritizedSweeping<M>::updatePredecessors() {
+        predecessors_.clear();
+        predecessors_.resize(S);
+
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                updatePredecessors(s, a);
+    }
+
+    template <typename M>
+    void PrioritizedSweeping<M>::updatePredecessors(const size_t s, const size_t a) {
+        if constexpr(is_model_eigen_v<M>) {
+            using T = std::remove_cv_t<std::remove_reference_t<decltype(model_.getTransitionFunction(a))>>;
+            const auto & t = model_.getTransitionFunction(a);
+            if constexpr(std::is_base_of_v<Eigen::SparseMatrixBase<T>, T>) {
+                for ( typename T::InnerIterator it(t, s); it; ++it )
+                    if ( it.value() > 0.0 )
+                        addPredecessor(s, a, it.col());
+            } else {
+                for ( size_t s1 = 0; s1 < S; ++s1 )
+                    if ( t(s, s1) > 0.0 )
+                        addPredecessor(s, a, s1);
             }
+        } else {
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                if ( model_.getTransitionProbability(s, a, s1) > 0.0 )
+                    addPredecessor(s, a, s1);
         }
     }
 
+    template <typename M>
+    void PrioritizedSweeping<M>::addPredecessor(const size_t s, const size_t a, const size_t s1) {
+        auto & preds = predecessors_[s1];
+        const size_t sa = s * A + a;
+
+        // Pairs mostly arrive in order, so we check the back first.
+        if ( preds.empty() || preds.back() < sa ) {
+            preds.push_back(sa);
+            return;
+        }
+        const auto it = std::lower_bound(std::begin(preds), std::end(preds), sa);
+        if ( *it != sa ) preds.insert(it, sa);
+    }
+
     template <typename M>
     void PrioritizedSweeping<M>::batchUpdateQ() {
         for ( unsigned i = 0; i < N; ++i ) {
@@ -229,13 +322,10 @@ namespace AIToolbox::MDP {
 
             // The state we extract has been processed already
             // So it is the future we have to backtrack from.
-            auto [p, pair] = queue_.top();
-            (void)p;
-
+            const auto sa = queue_.top().key;
             queue_.pop();
-            queueHandles_.erase(pair);
 
-            stepUpdateQ(pair.first, pair.second);
+            updateQ(sa / A, sa % A);
         }
     }
 
@@ -278,6 +368,12 @@ namespace AIToolbox::MDP {
     template <typename M>
     void PrioritizedSweeping<M>::setQFunction(const QFunction & qfun) {
         qfun_ = qfun;
+        ++version_;
+    }
+
+    template <typename M>
+    const size_t & PrioritizedSweeping<M>::getQFunctionVersion() const {
+        return version_;
     }
 
     template <typename M>
@@ -135,8 +135,10 @@ namespace AIToolbox::MDP {
              * @param a The action performed.
              * @param s1 The new state.
              * @param rew The reward obtained.
+             *
+             * @return The temporal difference error of the update.
              */
-            void stepUpdateQ(size_t s, size_t a, size_t s1, double rew);
+            double stepUpdateQ(size_t s, size_t a, size_t s1, double rew);
 
             /**
              * @brief This function returns the number of states on which QLearning is working.
@@ -162,6 +164,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function allows to directly set the internal QFunction.
              *
@@ -181,6 +194,7 @@ namespace AIToolbox::MDP {
             double discount_;
 
             QFunction q_;
+            size_t version_;
     };
 
     template <typename M, typename>
@@ -0,0 +1,303 @@
+#ifndef AI_TOOLBOX_MDP_REPLAY_BUFFER_HEADER_FILE
+#define AI_TOOLBOX_MDP_REPLAY_BUFFER_HEADER_FILE
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <AIToolbox/Types.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class stores past transitions and replays them on a tabular learner.
+     *
+     * The buffer has a fixed capacity: once full, each new transition
+     * overwrites the oldest one. Transitions are stored as separate arrays
+     * of states, actions, next states, next actions and rewards.
+     *
+     * On each batchUpdateQ() call a minibatch of N transitions is sampled
+     * and passed, in order, to the stepUpdateQ() of the input learner. Any
+     * learner with a stepUpdateQ(s, a, s1, rew) or stepUpdateQ(s, a, s1, a1,
+     * rew) method works, such as QLearning, DoubleQLearning, SARSA,
+     * ExpectedSARSA, HystereticQLearning and RLearning. For learners that
+     * need the next action, transitions must be recorded with it.
+     *
+     * With a priority exponent of 0 transitions are sampled uniformly.
+     * Otherwise each transition is sampled with probability proportional
+     * to its priority raised to the exponent, where the priority is the
+     * absolute temporal difference error returned by the learner the last
+     * time it was replayed. New transitions get the highest priority seen
+     * so far, so that each is replayed at least once. Priorities are kept
+     * in a sum tree, so sampling and updating are logarithmic in the
+     * capacity. The minibatch is stratified: the total priority is split
+     * in N equal segments, and one transition is sampled in each.
+     *
+     * Note that no importance sampling correction is applied, since the
+     * tabular learners have no per-sample learning rate.
+     */
+    class ReplayBuffer {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * The capacity must be greater than 0, and the exponent must be
+             * >= 0.0, otherwise the constructor will throw an
+             * std::invalid_argument.
+             *
+             * @param capacity The maximum number of stored transitions.
+             * @param exponent The priority exponent; 0 means uniform sampling.
+             * @param n The number of transitions replayed on each batchUpdateQ().
+             */
+            ReplayBuffer(size_t capacity, double exponent = 0.0, unsigned n = 32);
+
+            /**
+             * @brief This function stores a new transition.
+             *
+             * @param s The previous state.
+             * @param a The action performed.
+             * @param s1 The new state.
+             * @param rew The reward obtained.
+             */
+            void record(size_t s, size_t a, size_t s1, double rew);
+
+            /**
+             * @brief This function stores a new transition with the next action.
+             *
+             * @param s The previous state.
+             * @param a The action performed.
+             * @param s1 The new state.
+             * @param a1 The action performed in the new state.
+             * @param rew The reward obtained.
+             */
+            void record(size_t s, size_t a, size_t s1, size_t a1, double rew);
+
+            /**
+             * @brief This function replays a minibatch of stored transitions on a learner.
+             *
+             * If prioritized, the priority of each replayed transition is
+             * updated with the temporal difference error returned by the
+             * learner.
+             *
+             * @tparam L The type of the learner.
+             * @param learner The learner to update.
+             */
+            template <typename L>
+            void batchUpdateQ(L & learner);
+
+            /**
+             * @brief This function removes all stored transitions.
+             */
+            void clear();
+
+            /**
+             * @brief This function sets the number of transitions replayed on each batchUpdateQ().
+             *
+             * @param n The new minibatch size.
+             */
+            void setN(unsigned n);
+
+            /**
+             * @brief This function returns the number of transitions replayed on each batchUpdateQ().
+             *
+             * @return The minibatch size.
+             */
+            unsigned getN() const;
+
+            /**
+             * @brief This function returns the maximum number of stored transitions.
+             *
+             * @return The capacity of the buffer.
+             */
+            size_t getCapacity() const;
+
+            /**
+             * @brief This function returns the number of stored transitions.
+             *
+             * @return The number of stored transitions.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns the priority exponent.
+             *
+             * @return The priority exponent.
+             */
+            double getExponent() const;
+
+            /**
+             * @brief This function returns the sampling weight of a stored transition.
+             *
+             * Transitions are stored in insertion order, wrapping around
+             * once the buffer is full. With uniform sampling all weights are
+             * 1.0.
+             *
+             * @param i The position of the transition in the buffer.
+             *
+             * @return The priority of the transition raised to the exponent.
+             */
+            double getWeight(size_t i) const;
+
+        private:
+            /**
+             * @brief This function stores the priority of a transition in the sum tree.
+             *
+             * @param i The position of the transition in the buffer.
+             * @param priority The absolute temporal difference error of the transition.
+             */
+            void setPriority(size_t i, double priority);
+
+            /**
+             * @brief This function finds the transition at the input point of the cumulative priorities.
+             *
+             * @param u A value in [0, total priority).
+             *
+             * @return The position of the transition.
+             */
+            size_t findPriority(double u) const;
+
+            /**
+             * @brief This function fills batch_ with the positions of the transitions to replay.
+             */
+            void sampleBatch();
+
+            // Checks the call itself, so overloaded stepUpdateQ methods work too.
+            template <typename L, typename = void>
+            struct needs_next_action : std::false_type {};
+            template <typename L>
+            struct needs_next_action<L, std::void_t<decltype(std::declval<L&>().stepUpdateQ(size_t{}, size_t{}, size_t{}, size_t{}, double{}))>> : std::true_type {};
+
+            // Keeps transitions with zero error replayable.
+            static constexpr double minPriority = 1e-6;
+
+            size_t capacity_, size_, next_;
+            double exponent_, maxPriority_;
+            unsigned N;
+
+            std::vector<size_t> s_, a_, s1_, a1_;
+            std::vector<double> rew_;
+
+            // The leaves of the sum tree start at index leaves_.
+            size_t leaves_;
+            std::vector<double> tree_;
+
+            std::vector<size_t> batch_;
+            RandomEngine rand_;
+    };
+
+    inline ReplayBuffer::ReplayBuffer(const size_t capacity, const double exponent, const unsigned n) :
+            capacity_(capacity), size_(0), next_(0), exponent_(exponent), maxPriority_(1.0), N(n),
+            s_(capacity), a_(capacity), s1_(capacity), a1_(capacity), rew_(capacity),
+            leaves_(1), rand_(Impl::Seeder::getSeed())
+    {
+        if ( capacity_ == 0 ) throw std::invalid_argument("Replay buffer capacity must be greater than 0");
+        if ( exponent_ < 0.0 ) throw std::invalid_argument("Priority exponent must be >= 0");
+
+        if ( exponent_ > 0.0 ) {
+            while ( leaves_ < capacity_ ) leaves_ *= 2;
+            tree_.resize(2 * leaves_, 0.0);
+        }
+        batch_.reserve(N);
+    }
+
+    inline void ReplayBuffer::record(const size_t s, const size_t a, const size_t s1, const double rew) {
+        record(s, a, s1, 0, rew);
+    }
+
+    inline void ReplayBuffer::record(const size_t s, const size_t a, const size_t s1, const size_t a1, const double rew) {
+        s_[next_] = s;
+        a_[next_] = a;
+        s1_[next_] = s1;
+        a1_[next_] = a1;
+        rew_[next_] = rew;
+
+        if ( exponent_ > 0.0 )
+            setPriority(next_, maxPriority_);
+
+        next_ = (next_ + 1) % capacity_;
+        size_ = std::min(size_ + 1, capacity_);
+    }
+
+    template <typename L>
+    void ReplayBuffer::batchUpdateQ(L & learner) {
+        if ( !size_ ) return;
+        sampleBatch();
+
+        for ( const auto i : batch_ ) {
+            double error;
+            if constexpr (needs_next_action<L>::value)
+                error = learner.stepUpdateQ(s_[i], a_[i], s1_[i], a1_[i], rew_[i]);
+            else
+                error = learner.stepUpdateQ(s_[i], a_[i], s1_[i], rew_[i]);
+
+            if ( exponent_ > 0.0 ) {
+                const double priority = std::fabs(error);
+                maxPriority_ = std::max(maxPriority_, priority);
+                setPriority(i, priority);
+            }
+        }
+    }
+
+    inline void ReplayBuffer::sampleBatch() {
+        batch_.clear();
+        if ( exponent_ == 0.0 ) {
+            std::uniform_int_distribution<size_t> dist(0, size_ - 1);
+            for ( unsigned i = 0; i < N; ++i )
+                batch_.push_back(dist(rand_));
+            return;
+        }
+
+        const double segment = tree_[1] / N;
+        std::uniform_real_distribution<double> dist(0.0, segment);
+        for ( unsigned i = 0; i < N; ++i )
+            batch_.push_back(findPriority(i * segment + dist(rand_)));
+    }
+
+    inline void ReplayBuffer::setPriority(size_t i, const double priority) {
+        i += leaves_;
+        tree_[i] = std::pow(priority + minPriority, exponent_);
+        for ( i /= 2; i > 0; i /= 2 )
+            tree_[i] = tree_[2 * i] + tree_[2 * i + 1];
+    }
+
+    inline size_t ReplayBuffer::findPriority(double u) const {
+        size_t i = 1;
+        while ( i < leaves_ ) {
+            if ( u < tree_[2 * i] ) {
+                i = 2 * i;
+            } else {
+                u -= tree_[2 * i];
+                i = 2 * i + 1;
+            }
+        }
+        // Rounding can push us past the last stored transition.
+        return std::min(i - leaves_, size_ - 1);
+    }
+
+    inline void ReplayBuffer::clear() {
+        size_ = 0;
+        next_ = 0;
+        maxPriority_ = 1.0;
+        std::fill(std::begin(tree_), std::end(tree_), 0.0);
+    }
+
+    inline void ReplayBuffer::setN(const unsigned n) {
+        N = n;
+        batch_.reserve(N);
+    }
+
+    inline unsigned ReplayBuffer::getN() const { return N; }
+    inline size_t ReplayBuffer::getCapacity() const { return capacity_; }
+    inline size_t ReplayBuffer::size() const { return size_; }
+    inline double ReplayBuffer::getExponent() const { return exponent_; }
+
+    inline double ReplayBuffer::getWeight(const size_t i) const {
+        if ( exponent_ == 0.0 ) return 1.0;
+        return tree_[leaves_ + i];
+    }
+}
+
+#endif
@@ -6,8 +6,12 @@
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/EligibilityTraces.hpp>
 
 namespace AIToolbox::MDP {
+    template <typename M>
+    class Dyna2;
+
     /**
      * @brief This class represents the SARSAL algorithm.
      *
@@ -36,8 +40,8 @@ namespace AIToolbox::MDP {
      */
     class SARSAL {
         public:
-            using Trace = std::tuple<size_t, size_t, double>;
-            using Traces = std::vector<Trace>;
+            using Trace = EligibilityTraces::Trace;
+            using Traces = EligibilityTraces::Traces;
             /**
              * @brief Basic constructor.
              *
@@ -199,7 +203,7 @@ namespace AIToolbox::MDP {
              *
              * @return The currently set traces.
              */
-            const Traces & getTraces() const;
+            Traces getTraces() const;
 
             /**
              * @brief This function sets the currently set traces.
@@ -236,6 +240,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function allows to directly set the internal QFunction.
              *
@@ -250,6 +265,11 @@ namespace AIToolbox::MDP {
             void setQFunction(const QFunction & qfun);
 
         private:
+            // Dyna2 merges the results of its parallel simulations
+            // directly into the QFunction.
+            template <typename M>
+            friend class Dyna2;
+
             size_t S, A;
             double alpha_;
             double discount_;
@@ -258,7 +278,8 @@ namespace AIToolbox::MDP {
             double gammaL_;
 
             QFunction q_;
-            Traces traces_;
+            size_t version_;
+            EligibilityTraces traces_;
     };
 
     template <typename M, typename>
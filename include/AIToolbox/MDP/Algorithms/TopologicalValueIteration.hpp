@@ -0,0 +1,299 @@
+#ifndef AI_TOOLBOX_MDP_TOPOLOGICAL_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_TOPOLOGICAL_VALUE_ITERATION_HEADER_FILE
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <AIToolbox/Impl/Logging.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/TypeTraits.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/Utils/Core.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class applies the topological value iteration algorithm on a Model.
+     *
+     * Many MDPs are mostly acyclic: most states can only be visited once,
+     * and cycles are confined to small groups of states. ValueIteration
+     * does not exploit this, and keeps sweeping all states until the whole
+     * ValueFunction has converged.
+     *
+     * This algorithm instead decomposes the transition graph of the Model
+     * (where an edge s -> s' exists if any action can lead from s to s')
+     * into its strongly connected components. The values of the states in
+     * a component only depend on the states of that component and of the
+     * components reachable from it. Thus, components are solved one at a
+     * time, in reverse topological order, each one until convergence,
+     * using Gauss-Seidel backups. Components made of a single state
+     * without a self-loop are solved with a single backup.
+     *
+     * The decomposition only depends on which transitions are possible, so
+     * it is computed on the first solve and then cached. Models that only
+     * differ in rewards (or in the values of non-zero transition
+     * probabilities) can thus be solved again without recomputing it. If
+     * the structure of the transitions changes, call computeComponents()
+     * or clearComponents().
+     */
+    class TopologicalValueIteration {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * constructor will throw an std::invalid_argument. A tolerance
+             * of 0.0 forces TopologicalValueIteration to perform a number
+             * of sweeps equal to the horizon specified on each cyclic
+             * component. Otherwise, each component is swept until the
+             * maximum change in its values is less than the tolerance
+             * specified.
+             *
+             * Note that the default value function size needs to match
+             * the number of states of the Model. Otherwise it will
+             * be ignored. An empty value function will be defaulted
+             * to all zeroes.
+             *
+             * @param horizon The maximum number of sweeps to perform on each component.
+             * @param tolerance The tolerance factor to stop the sweeps.
+             * @param v The initial value function from which to start the loop.
+             */
+            TopologicalValueIteration(unsigned horizon, double tolerance = 0.001, ValueFunction v = {Values(), Actions(0)});
+
+            /**
+             * @brief This function applies topological value iteration on an MDP to solve it.
+             *
+             * If no decomposition is cached, or if the cached one has a
+             * different number of states than the input Model, the
+             * components are computed before solving.
+             *
+             * @tparam M The type of the solvable MDP.
+             * @param m The MDP that needs to be solved.
+             *
+             * @return A tuple containing the maximum variation for the
+             *         ValueFunction, the ValueFunction and the QFunction for
+             *         the Model.
+             */
+            template <typename M, typename = std::enable_if_t<is_model_v<M>>>
+            std::tuple<double, ValueFunction, QFunction> operator()(const M & m);
+
+            /**
+             * @brief This function computes and caches the strongly connected components of the input Model.
+             *
+             * @tparam M The type of the MDP.
+             * @param m The MDP to decompose.
+             */
+            template <typename M, typename = std::enable_if_t<is_model_v<M>>>
+            void computeComponents(const M & m);
+
+            /**
+             * @brief This function clears the cached decomposition.
+             *
+             * The next solve will recompute it.
+             */
+            void clearComponents();
+
+            /**
+             * @brief This function sets the tolerance parameter.
+             *
+             * The tolerance parameter must be >= 0.0, otherwise the
+             * function will throw an std::invalid_argument.
+             *
+             * @param e The new tolerance parameter.
+             */
+            void setTolerance(double e);
+
+            /**
+             * @brief This function sets the horizon parameter.
+             *
+             * @param h The new horizon parameter.
+             */
+            void setHorizon(unsigned h);
+
+            /**
+             * @brief This function sets the starting value function.
+             *
+             * An empty value function defaults to all zeroes. Note
+             * that the default value function size needs to match
+             * the number of states of the Model that needs to be
+             * solved. Otherwise it will be ignored.
+             *
+             * @param v The new starting value function.
+             */
+            void setValueFunction(ValueFunction v);
+
+            /**
+             * @brief This function will return the currently set tolerance parameter.
+             *
+             * @return The currently set tolerance parameter.
+             */
+            double getTolerance() const;
+
+            /**
+             * @brief This function will return the current horizon parameter.
+             *
+             * @return The currently set horizon parameter.
+             */
+            unsigned getHorizon() const;
+
+            /**
+             * @brief This function will return the current set default value function.
+             *
+             * @return The currently set default value function.
+             */
+            const ValueFunction & getValueFunction() const;
+
+            /**
+             * @brief This function returns the cached strongly connected components.
+             *
+             * Components are sorted in reverse topological order, so that
+             * no component can reach any of the ones after it.
+             *
+             * @return The states of each component.
+             */
+            const std::vector<std::vector<size_t>> & getComponents() const;
+
+            /**
+             * @brief This function returns the number of sweeps performed on each component during the last solve.
+             *
+             * @return The number of sweeps per component, in the same order as getComponents().
+             */
+            const std::vector<unsigned> & getComponentIterations() const;
+
+        private:
+            /**
+             * @brief This function computes the strongly connected components of a graph.
+             *
+             * This uses an iterative version of Tarjan's algorithm, which
+             * outputs components in reverse topological order.
+             *
+             * @param graph The successors of each node, without duplicates.
+             */
+            void decompose(const std::vector<std::vector<size_t>> & graph);
+
+            // Parameters
+            double tolerance_;
+            unsigned horizon_;
+            ValueFunction vParameter_;
+
+            // Cached decomposition
+            std::vector<std::vector<size_t>> components_;
+            std::vector<bool> cyclic_; // Per state, whether its component has a cycle.
+
+            // Internals
+            ValueFunction v1_;
+            std::vector<unsigned> iterations_;
+    };
+
+    template <typename M, typename>
+    std::tuple<double, ValueFunction, QFunction> TopologicalValueIteration::operator()(const M & model) {
+        // Extract necessary knowledge from model so we don't have to pass it around
+        const size_t S = model.getS();
+
+        {
+            // Verify that parameter value function is compatible.
+            const size_t size = vParameter_.values.size();
+            if ( size != S ) {
+                if ( size != 0 ) {
+                    AI_LOGGER(AI_SEVERITY_WARNING, "Size of starting value function is incorrect, ignoring...");
+                }
+                // Defaulting
+                v1_ = makeValueFunction(S);
+            }
+            else
+                v1_ = vParameter_;
+        }
+
+        if ( components_.empty() || cyclic_.size() != S )
+            computeComponents(model);
+
+        const auto & ir = [&]{
+            if constexpr (is_model_eigen_v<M>) return model.getRewardFunction();
+            else return computeImmediateRewards(model);
+        }();
+
+        auto & values = v1_.values;
+        auto & actions = v1_.actions;
+
+        iterations_.assign(components_.size(), 0);
+
+        const bool useTolerance = checkDifferentSmall(tolerance_, 0.0);
+        double maxVariation = 0.0;
+
+        for ( size_t c = 0; c < components_.size(); ++c ) {
+            const auto & component = components_[c];
+            auto & iterations = iterations_[c];
+
+            // All successors of an acyclic state have already been
+            // solved, so a single backup gives its final value.
+            if ( !cyclic_[component[0]] ) {
+                const auto s = component[0];
+                std::tie(actions[s], values[s]) = bellmanBackup(model, ir, values, s);
+                iterations = 1;
+                continue;
+            }
+
+            double variation = tolerance_ * 2; // Make it bigger
+            while ( iterations < horizon_ && (!useTolerance || variation > tolerance_) ) {
+                ++iterations;
+
+                variation = 0.0;
+                for ( const auto s : component ) {
+                    const auto [a, v] = bellmanBackup(model, ir, values, s);
+                    variation = std::max(variation, std::fabs(v - values[s]));
+
+                    values[s] = v;
+                    actions[s] = a;
+                }
+            }
+            AI_LOGGER(AI_SEVERITY_DEBUG, "Solved component " << c << " of size " << component.size() << " in " << iterations << " sweeps");
+
+            maxVariation = std::max(maxVariation, variation);
+        }
+
+        // We only build the QFunction once, from the final values.
+        QFunction q = computeQFunction(model, values * model.getDiscount(), ir);
+
+        return std::make_tuple(useTolerance ? maxVariation : 0.0, std::move(v1_), std::move(q));
+    }
+
+    template <typename M, typename>
+    void TopologicalValueIteration::computeComponents(const M & model) {
+        const size_t S = model.getS();
+        const size_t A = model.getA();
+
+        std::vector<std::vector<size_t>> graph(S);
+        for ( size_t a = 0; a < A; ++a ) {
+            if constexpr (is_model_eigen_v<M>) {
+                using T = std::remove_cv_t<std::remove_reference_t<decltype(model.getTransitionFunction(a))>>;
+                const auto & t = model.getTransitionFunction(a);
+                for ( size_t s = 0; s < S; ++s ) {
+                    if constexpr (std::is_base_of_v<Eigen::SparseMatrixBase<T>, T>) {
+                        for ( typename T::InnerIterator it(t, s); it; ++it )
+                            if ( it.value() > 0.0 )
+                                graph[s].push_back(it.col());
+                    } else {
+                        for ( size_t s1 = 0; s1 < S; ++s1 )
+                            if ( t(s, s1) > 0.0 )
+                                graph[s].push_back(s1);
+                    }
+                }
+            } else {
+                for ( size_t s = 0; s < S; ++s )
+                    for ( size_t s1 = 0; s1 < S; ++s1 )
+                        if ( model.getTransitionProbability(s, a, s1) > 0.0 )
+                            graph[s].push_back(s1);
+            }
+        }
+        for ( auto & succ : graph ) {
+            std::sort(std::begin(succ), std::end(succ));
+            succ.erase(std::unique(std::begin(succ), std::end(succ)), std::end(succ));
+        }
+
+        decompose(graph);
+    }
+}
+
+#endif
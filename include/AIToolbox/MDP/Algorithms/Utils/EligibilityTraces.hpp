@@ -0,0 +1,167 @@
+#ifndef AI_TOOLBOX_MDP_ELIGIBILITY_TRACES_HEADER_FILE
+#define AI_TOOLBOX_MDP_ELIGIBILITY_TRACES_HEADER_FILE
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <AIToolbox/MDP/Types.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class stores the capped eligibility traces of a set of state/action pairs.
+     *
+     * Methods like SARSAL and the off-policy family keep a list of recently
+     * visited state/action pairs, all of which are updated at every step
+     * with a coefficient that decays over time. A plain list needs a linear
+     * scan to find the current pair, and must decay each element
+     * separately.
+     *
+     * This class instead indexes the traces with a hash table, so the
+     * current pair is found in constant time, and stores all eligibilities
+     * relative to a single global scale. Decaying all traces thus only
+     * multiplies the scale, and the scale is folded back into the stored
+     * values whenever it gets too small or too large to be represented
+     * precisely.
+     *
+     * The pairs and their relative eligibilities are kept in two contiguous
+     * arrays, so that the QFunction update is a single tight loop, during
+     * which traces below the cutoff are also removed.
+     */
+    class EligibilityTraces {
+        public:
+            using Trace = std::tuple<size_t, size_t, double>;
+            using Traces = std::vector<Trace>;
+
+            /**
+             * @brief Basic constructor.
+             *
+             * @param A The size of the action space.
+             */
+            EligibilityTraces(size_t A);
+
+            /**
+             * @brief This function updates the traces and the QFunction with a new transition.
+             *
+             * All traces are decayed by the input discount, and the trace
+             * of the input pair is reset to 1.0. Then every trace is used
+             * to update the QFunction, with coefficient error times its
+             * eligibility. Traces whose eligibility falls below the
+             * tolerance are removed, except for the one of the input pair.
+             *
+             * @param q The QFunction to update.
+             * @param s The state we were before.
+             * @param a The action we did.
+             * @param error The error used to update the QFunction.
+             * @param traceDiscount The discount for all traces in memory.
+             * @param tolerance The cutoff point for eligibility traces.
+             */
+            void update(QFunction & q, size_t s, size_t a, double error, double traceDiscount, double tolerance);
+
+            /**
+             * @brief This function updates the traces with a new transition, passing each eligibility to a callback.
+             *
+             * This is the same as the other update(), but rather than
+             * updating a QFunction it calls the input function once per
+             * surviving trace, as f(id, eligibility), where id is s * A + a.
+             * This allows updating other representations of a QFunction,
+             * such as a sparse set of changes.
+             *
+             * @param s The state we were before.
+             * @param a The action we did.
+             * @param traceDiscount The discount for all traces in memory.
+             * @param tolerance The cutoff point for eligibility traces.
+             * @param f The function to call on each trace.
+             */
+            template <typename F>
+            void update(size_t s, size_t a, double traceDiscount, double tolerance, F f);
+
+            /**
+             * @brief This function removes all traces.
+             */
+            void clear();
+
+            /**
+             * @brief This function returns the number of stored traces.
+             *
+             * @return The number of stored traces.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns the stored traces with their current eligibilities.
+             *
+             * @return The stored traces.
+             */
+            Traces getTraces() const;
+
+            /**
+             * @brief This function replaces the stored traces.
+             *
+             * If the same pair appears more than once, only the last
+             * eligibility is kept.
+             *
+             * @param t The new traces.
+             */
+            void setTraces(const Traces & t);
+
+        private:
+            // Past these the relative eligibilities start losing precision, so
+            // we fold the scale back into them.
+            static constexpr double minScale = 1e-64;
+            static constexpr double maxScale = 1e64;
+
+            /**
+             * @brief This function folds the global scale into the stored eligibilities.
+             */
+            void renormalize();
+
+            /**
+             * @brief This function removes a trace by swapping it with the last one.
+             *
+             * @param i The position of the trace to remove.
+             */
+            void remove(size_t i);
+
+            size_t A;
+            double scale_;
+            std::vector<size_t> ids_;     // s * A + a, so they index a row-major QFunction directly.
+            std::vector<double> traces_;  // Eligibilities, divided by scale_.
+            std::unordered_map<size_t, size_t> index_;
+    };
+
+    template <typename F>
+    void EligibilityTraces::update(const size_t s, const size_t a, const double traceDiscount, const double tolerance, F f) {
+        // A zero discount kills every old trace at once.
+        if (traceDiscount <= 0.0) {
+            clear();
+        } else {
+            scale_ *= traceDiscount;
+            if (scale_ < minScale || scale_ > maxScale)
+                renormalize();
+        }
+
+        const size_t id = s * A + a;
+        if (const auto it = index_.find(id); it != index_.end()) {
+            traces_[it->second] = 1.0 / scale_;
+        } else {
+            index_.emplace(id, ids_.size());
+            ids_.push_back(id);
+            traces_.push_back(1.0 / scale_);
+        }
+
+        // Everything is relative to the scale, so we compare against the
+        // scaled cutoff.
+        const double cutoff = tolerance / scale_;
+        for (size_t i = 0; i < ids_.size(); ) {
+            if (traces_[i] < cutoff && ids_[i] != id) {
+                remove(i);
+                continue;
+            }
+            f(ids_[i], traces_[i] * scale_);
+            ++i;
+        }
+    }
+}
+
+#endif
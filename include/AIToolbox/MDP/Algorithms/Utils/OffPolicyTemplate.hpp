@@ -2,6 +2,7 @@
 #define AI_TOOLBOX_MDP_OFF_POLICY_TEMPLATE_HEADER_FILE
 
 #include <AIToolbox/MDP/Policies/PolicyInterface.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/EligibilityTraces.hpp>
 #include <AIToolbox/MDP/Types.hpp>
 
 namespace AIToolbox::MDP {
@@ -10,8 +11,8 @@ namespace AIToolbox::MDP {
      */
     class OffPolicyBase {
         public:
-            using Trace = std::tuple<size_t, size_t, double>;
-            using Traces = std::vector<Trace>;
+            using Trace = EligibilityTraces::Trace;
+            using Traces = EligibilityTraces::Traces;
 
             /**
              * @brief Basic construtor.
@@ -103,7 +104,7 @@ namespace AIToolbox::MDP {
              *
              * @return The currently set traces.
              */
-            const Traces & getTraces() const;
+            Traces getTraces() const;
 
             /**
              * @brief This function sets the currently set traces.
@@ -140,6 +141,17 @@ namespace AIToolbox::MDP {
              */
             const QFunction & getQFunction() const;
 
+            /**
+             * @brief This function returns a reference to the version counter of the QFunction.
+             *
+             * The counter is incremented every time the QFunction is
+             * modified, so that policies can cache values computed from
+             * it; see for example QGreedyPolicy::enableCache().
+             *
+             * @return A reference to the version counter.
+             */
+            const size_t & getQFunctionVersion() const;
+
             /**
              * @brief This function allows to directly set the internal QFunction.
              *
@@ -169,7 +181,8 @@ namespace AIToolbox::MDP {
             void updateTraces(size_t s, size_t a, double error, double traceDiscount);
 
             QFunction q_;
-            Traces traces_;
+            size_t version_;
+            EligibilityTraces traces_;
     };
 
     /**
@@ -243,6 +256,10 @@ namespace AIToolbox::MDP {
 
         protected:
             const PolicyInterface & target_;
+
+        private:
+            // To avoid reallocating a vector every time for the expectation.
+            Vector probs_;
     };
 
     /**
@@ -351,9 +368,8 @@ namespace AIToolbox::MDP {
 
     template <typename Derived>
     void OffPolicyEvaluation<Derived>::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
-        auto expectedQ = 0.0;
-        for (size_t a = 0; a < A; ++a)
-            expectedQ += q_(s1, a) * target_.getActionProbability(s1, a);
+        target_.getActionProbabilities(s1, probs_);
+        const auto expectedQ = q_.row(s1).dot(probs_);
 
         const auto error = alpha_ * ( rew + discount_ * expectedQ - q_(s, a) );
         const auto traceDiscount = discount_ * static_cast<Derived*>(this)->getTraceDiscount(s, a, s1, rew);
@@ -395,7 +411,7 @@ namespace AIToolbox::MDP {
         const double discount, const double alpha, const double tolerance
     ) :
         Parent(target.getS(), target.getA(), discount, alpha, tolerance),
-        target_(target) {}
+        target_(target), probs_(A) {}
 
     template <typename Derived>
     OffPolicyControl<Derived>::OffPolicyControl(
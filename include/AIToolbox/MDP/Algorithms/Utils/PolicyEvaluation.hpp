@@ -3,6 +3,10 @@
 
 #include <tuple>
 #include <iterator>
+#include <type_traits>
+
+#include <Eigen/SparseCore>
+#include <Eigen/IterativeLinearSolvers>
 
 #include <AIToolbox/Impl/Logging.hpp>
 #include <AIToolbox/MDP/Types.hpp>
@@ -18,6 +22,17 @@ namespace AIToolbox::MDP {
      * Policy Evaluation computes the values and QFunction for a particular
      * policy used on a given Model.
      *
+     * By default the values are computed by repeatedly applying the
+     * Bellman equation for the policy, until the horizon is reached or the
+     * values change less than the tolerance. For discounts close to 1 this
+     * may require a very high number of sweeps.
+     *
+     * Alternatively, this class can compute the values by directly solving
+     * the linear system (I - discount * P) v = r, where P is the transition
+     * matrix of the policy, and r its expected immediate rewards. The system
+     * is solved with the BiCGSTAB iterative solver on a sparse P, using the
+     * currently set values as the starting guess (see setLinearSolve()).
+     *
      * This class is setup so it is easy to reuse on multiple policies
      * using the same Model, so that no redundant computations have to be
      * performed.
@@ -45,6 +60,12 @@ namespace AIToolbox::MDP {
              * be ignored. An empty value function will be defaulted
              * to all zeroes.
              *
+             * The horizon and tolerance have a different meaning when
+             * the linear solve mode is enabled: the horizon becomes the
+             * maximum number of solver iterations, and the tolerance the
+             * relative residual at which the solver stops (see
+             * setLinearSolve()).
+             *
              * @param m The MDP to evaluate a policy for.
              * @param horizon The maximum number of iterations to perform.
              * @param tolerance The tolerance factor to stop the policy evaluation loop.
@@ -98,6 +119,28 @@ namespace AIToolbox::MDP {
              */
             void setValues(Values v);
 
+            /**
+             * @brief This function sets whether to solve for the values directly.
+             *
+             * When enabled, the values of the policy are obtained by
+             * solving (I - discount * P) v = r with BiCGSTAB, rather than
+             * by repeated Bellman sweeps. In this mode the horizon is the
+             * maximum number of solver iterations, and the tolerance is
+             * the relative residual at which the solver stops (a tolerance
+             * of 0.0 uses Eigen's default). The values set with
+             * setValues() are used as the starting guess.
+             *
+             * Since each solver iteration costs about two sweeps, this is
+             * much faster when the discount is close to 1. When the
+             * discount is exactly 1 the system may be singular, in which
+             * case the solver may fail to converge. If the solver does not
+             * converge within the horizon, its result is discarded and
+             * the values are computed with the normal sweeps instead.
+             *
+             * @param l Whether to solve for the values directly.
+             */
+            void setLinearSolve(bool l);
+
             /**
              * @brief This function will return the currently set tolerance parameter.
              *
@@ -119,11 +162,32 @@ namespace AIToolbox::MDP {
              */
             const Values & getValues() const;
 
+            /**
+             * @brief This function returns whether the values are computed by solving the linear system directly.
+             *
+             * @return Whether the linear solve mode is enabled.
+             */
+            bool getLinearSolve() const;
+
         private:
+            /**
+             * @brief This function solves for the values of the policy with BiCGSTAB.
+             *
+             * v1_ must already contain the starting guess.
+             *
+             * @param p The policy to evaluate.
+             * @param ir The immediate rewards of the Model.
+             *
+             * @return Whether the solver converged; if not, v1_ is left unchanged.
+             */
+            template <typename IR>
+            bool linearSolve(const Matrix2D & p, const IR & ir);
+
             // Parameters
             double tolerance_;
             unsigned horizon_;
             Values vParameter_;
+            bool linearSolve_;
             const M & model_;
 
             // Internals
@@ -134,7 +198,7 @@ namespace AIToolbox::MDP {
 
     template <typename M>
     PolicyEvaluation<M>::PolicyEvaluation(const M & m, const unsigned horizon, const double tolerance, Values v) :
-            horizon_(horizon), vParameter_(std::move(v)), model_(m), S(0), A(0)
+            horizon_(horizon), vParameter_(std::move(v)), linearSolve_(false), model_(m), S(0), A(0)
     {
         setTolerance(tolerance);
 
@@ -171,6 +235,32 @@ namespace AIToolbox::MDP {
         QFunction q = makeQFunction(S, A);
         const auto p = policy.getPolicy();
 
+        bool solved = false;
+        if ( linearSolve_ ) {
+            if constexpr(is_model_eigen_v<M>)
+                solved = linearSolve(p, model_.getRewardFunction());
+            else
+                solved = linearSolve(p, immediateRewards_);
+        }
+
+        if ( solved ) {
+            // We do one last backup to get the QFunction, which also
+            // tells us how far the solution is from the fixed point.
+            val0 = v1_;
+            v1_ *= model_.getDiscount();
+            if constexpr(is_model_eigen_v<M>)
+                q = computeQFunction(model_, v1_, model_.getRewardFunction());
+            else
+                q = computeQFunction(model_, v1_, immediateRewards_);
+
+            for ( size_t s = 0; s < S; ++s )
+                v1_(s) = q.row(s) * p.row(s).transpose();
+
+            variation = (v1_ - val0).cwiseAbs().maxCoeff();
+            return std::make_tuple(variation, std::move(v1_), std::move(q));
+        }
+
+        // Without the linear solve, or if the solver failed, we sweep.
         const bool useTolerance = checkDifferentSmall(tolerance_, 0.0);
         while ( timestep < horizon_ && (!useTolerance || variation > tolerance_) ) {
             ++timestep;
@@ -202,6 +292,64 @@ namespace AIToolbox::MDP {
         return std::make_tuple(useTolerance ? variation : 0.0, std::move(v1_), std::move(q));
     }
 
+    template <typename M>
+    template <typename IR>
+    bool PolicyEvaluation<M>::linearSolve(const Matrix2D & p, const IR & ir) {
+        // Build the transition matrix of the policy.
+        SparseMatrix2D pt(S, S);
+        if constexpr(is_model_eigen_v<M>) {
+            using T = std::remove_cv_t<std::remove_reference_t<decltype(model_.getTransitionFunction(0))>>;
+            if constexpr(std::is_base_of_v<Eigen::SparseMatrixBase<T>, T>) {
+                for ( size_t a = 0; a < A; ++a )
+                    pt += p.col(a).asDiagonal() * model_.getTransitionFunction(a).template cast<double>();
+            } else {
+                Matrix2D dense = Matrix2D::Zero(S, S);
+                for ( size_t a = 0; a < A; ++a )
+                    dense.noalias() += p.col(a).asDiagonal() * model_.getTransitionFunction(a).template cast<double>();
+                pt = dense.sparseView();
+            }
+        } else {
+            std::vector<Eigen::Triplet<double>> triplets;
+            for ( size_t s = 0; s < S; ++s ) {
+                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                    double prob = 0.0;
+                    for ( size_t a = 0; a < A; ++a )
+                        prob += p(s, a) * model_.getTransitionProbability(s, a, s1);
+                    if ( checkDifferentSmall(prob, 0.0) )
+                        triplets.emplace_back(s, s1, prob);
+                }
+            }
+            pt.setFromTriplets(std::begin(triplets), std::end(triplets));
+        }
+
+        // Expected immediate rewards of the policy.
+        Vector r(S);
+        for ( size_t s = 0; s < S; ++s ) {
+            r[s] = 0.0;
+            for ( size_t a = 0; a < A; ++a )
+                r[s] += p(s, a) * ir.coeff(s, a);
+        }
+
+        // We solve (I - discount * P) v = r, starting from the current values.
+        SparseMatrix2D I(S, S);
+        I.setIdentity();
+        const SparseMatrix2D system = I - model_.getDiscount() * pt;
+
+        Eigen::BiCGSTAB<SparseMatrix2D, Eigen::DiagonalPreconditioner<double>> solver;
+        solver.setMaxIterations(horizon_);
+        if ( checkDifferentSmall(tolerance_, 0.0) )
+            solver.setTolerance(tolerance_);
+        solver.compute(system);
+
+        Values solution = solver.solveWithGuess(r, v1_);
+        if ( solver.info() != Eigen::Success ) {
+            AI_LOGGER(AI_SEVERITY_WARNING, "BiCGSTAB did not converge, error is " << solver.error() << "; falling back to sweeps.");
+            return false;
+        }
+        v1_ = std::move(solution);
+        return true;
+    }
+
     template <typename M>
     void PolicyEvaluation<M>::setTolerance(const double t) {
         if ( t < 0.0 ) throw std::invalid_argument("Tolerance must be >= 0");
@@ -218,6 +366,11 @@ namespace AIToolbox::MDP {
         vParameter_ = std::move(v);
     }
 
+    template <typename M>
+    void PolicyEvaluation<M>::setLinearSolve(const bool l) {
+        linearSolve_ = l;
+    }
+
     template <typename M>
     double PolicyEvaluation<M>::getTolerance()   const { return tolerance_; }
 
@@ -226,6 +379,9 @@ namespace AIToolbox::MDP {
 
     template <typename M>
     const Values & PolicyEvaluation<M>::getValues() const { return vParameter_; }
+
+    template <typename M>
+    bool PolicyEvaluation<M>::getLinearSolve() const { return linearSolve_; }
 }
 
 #endif
@@ -0,0 +1,152 @@
+#ifndef AI_TOOLBOX_MDP_VISITED_PAIRS_HEADER_FILE
+#define AI_TOOLBOX_MDP_VISITED_PAIRS_HEADER_FILE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class keeps track of the visited state-action pairs with a dense bitset.
+     *
+     * The bitset takes S*A bits, allocated on construction, which gives
+     * constant time insertion without hashing. The visited pairs are also
+     * appended, in order of first visit, to a vector of flat indices so
+     * that they can be sampled uniformly in constant time.
+     *
+     * This is the right choice unless S*A bits do not comfortably fit in
+     * memory; in that case see PagedVisitedPairs.
+     */
+    class DenseVisitedPairs {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * @param S The number of states.
+             * @param A The number of actions.
+             */
+            DenseVisitedPairs(size_t S, size_t A);
+
+            /**
+             * @brief This function marks a pair as visited.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             *
+             * @return True if the pair had not been visited before.
+             */
+            bool insert(size_t s, size_t a);
+
+            /**
+             * @brief This function returns whether a pair has been visited.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             *
+             * @return True if the pair has been visited.
+             */
+            bool contains(size_t s, size_t a) const;
+
+            /**
+             * @brief This function returns the number of visited pairs.
+             *
+             * @return The number of visited pairs.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns a visited pair, in order of first visit.
+             *
+             * @param i The index of the pair, lower than size().
+             *
+             * @return The state and action of the pair.
+             */
+            std::pair<size_t, size_t> operator[](size_t i) const;
+
+        private:
+            size_t A;
+            std::vector<std::uint64_t> bits_;
+            std::vector<size_t> pairs_; // s * A + a
+    };
+
+    /**
+     * @brief This class keeps track of the visited state-action pairs with a paged bitmap.
+     *
+     * The bitmap is split in pages of 4096 bits, which are only allocated
+     * once a pair within them is visited, and are looked up through a hash
+     * table. Memory thus grows with the number of visited regions of the
+     * state-action space rather than with S*A, which makes this class
+     * suitable for very large models where only a small part of the space
+     * is ever visited.
+     *
+     * As in DenseVisitedPairs, visited pairs are also kept in a vector for
+     * constant time uniform sampling.
+     */
+    class PagedVisitedPairs {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * @param S The number of states.
+             * @param A The number of actions.
+             */
+            PagedVisitedPairs(size_t S, size_t A);
+
+            /**
+             * @brief This function marks a pair as visited.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             *
+             * @return True if the pair had not been visited before.
+             */
+            bool insert(size_t s, size_t a);
+
+            /**
+             * @brief This function returns whether a pair has been visited.
+             *
+             * @param s The state of the pair.
+             * @param a The action of the pair.
+             *
+             * @return True if the pair has been visited.
+             */
+            bool contains(size_t s, size_t a) const;
+
+            /**
+             * @brief This function returns the number of visited pairs.
+             *
+             * @return The number of visited pairs.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns a visited pair, in order of first visit.
+             *
+             * @param i The index of the pair, lower than size().
+             *
+             * @return The state and action of the pair.
+             */
+            std::pair<size_t, size_t> operator[](size_t i) const;
+
+            /**
+             * @brief This function returns the number of allocated pages.
+             *
+             * @return The number of allocated pages.
+             */
+            size_t getPages() const;
+
+        private:
+            static constexpr size_t PageWords = 64;
+            static constexpr size_t PageBits = PageWords * 64;
+            using Page = std::array<std::uint64_t, PageWords>;
+
+            size_t A;
+            std::unordered_map<size_t, Page> pages_;
+            std::vector<size_t> pairs_; // s * A + a
+    };
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/Parallel.hpp>
 
 namespace AIToolbox::MDP {
     /**
@@ -23,6 +24,19 @@ namespace AIToolbox::MDP {
      *
      * This implementation in particular is ported from the MATLAB
      * MDPToolbox (although it is simplified).
+     *
+     * When solving models that expose their transition and reward
+     * functions as Eigen matrices (see is_model_eigen), this class can
+     * split each Bellman backup across multiple threads. The state space
+     * is partitioned in contiguous row blocks, and each thread computes
+     * both the QFunction rows and the max over actions for its own block.
+     * The results are the same as the serial version, up to the order of
+     * floating point operations within the matrix products.
+     *
+     * The worker threads are spawned once per call to operator(), and
+     * reused for every iteration. Even so, each backup needs to wake up
+     * and wait for all threads, so for small models the serial version
+     * (threads = 1) is usually faster.
      */
     class ValueIteration {
         public:
@@ -45,8 +59,9 @@ namespace AIToolbox::MDP {
              * @param horizon The maximum number of iterations to perform.
              * @param tolerance The tolerance factor to stop the value iteration loop.
              * @param v The initial value function from which to start the loop.
+             * @param threads The number of threads to use, 0 for all available ones.
              */
-            ValueIteration(unsigned horizon, double tolerance = 0.001, ValueFunction v = {Values(), Actions(0)});
+            ValueIteration(unsigned horizon, double tolerance = 0.001, ValueFunction v = {Values(), Actions(0)}, unsigned threads = 1);
 
             /**
              * @brief This function applies value iteration on an MDP to solve it.
@@ -97,6 +112,18 @@ namespace AIToolbox::MDP {
              */
             void setValueFunction(ValueFunction v);
 
+            /**
+             * @brief This function sets the number of threads to use.
+             *
+             * Multithreading is only used with models that satisfy the
+             * is_model_eigen interface; other models are always solved
+             * serially. A value of 0 uses all available hardware
+             * threads, while 1 disables multithreading.
+             *
+             * @param threads The new number of threads.
+             */
+            void setThreads(unsigned threads);
+
             /**
              * @brief This function will return the currently set tolerance parameter.
              *
@@ -118,11 +145,37 @@ namespace AIToolbox::MDP {
              */
             const ValueFunction & getValueFunction() const;
 
+            /**
+             * @brief This function returns the currently set number of threads.
+             *
+             * @return The currently set number of threads.
+             */
+            unsigned getThreads() const;
+
         private:
+            /**
+             * @brief This function performs a full Bellman backup, splitting it across threads.
+             *
+             * The output QFunction and ValueFunction are written row block
+             * by row block, where each thread owns a contiguous range of
+             * states.
+             *
+             * @param model The model to solve.
+             * @param ir The immediate rewards of the model.
+             * @param v The discounted values of the previous iteration.
+             * @param q The output QFunction.
+             * @param pool The threads to split the backup across.
+             *
+             * @return The max variation between the old and new values.
+             */
+            template <typename M, typename IR>
+            double parallelBellmanBackup(const M & model, const IR & ir, const Values & v, QFunction & q, ThreadPool & pool);
+
             // Parameters
             double tolerance_;
             unsigned horizon_;
             ValueFunction vParameter_;
+            unsigned threads_;
 
             // Internals
             ValueFunction v1_;
@@ -161,6 +214,24 @@ namespace AIToolbox::MDP {
         QFunction q = makeQFunction(S, A);
 
         const bool useTolerance = checkDifferentSmall(tolerance_, 0.0);
+
+        if constexpr (is_model_eigen_v<M>) {
+            if ( const auto T = getNumThreads(threads_, S); T > 1 ) {
+                ThreadPool pool(T);
+                while ( timestep < horizon_ && (!useTolerance || variation > tolerance_) ) {
+                    ++timestep;
+                    AI_LOGGER(AI_SEVERITY_DEBUG, "Processing timestep " << timestep);
+
+                    // Here val0 holds the discounted values that all
+                    // threads read, while each thread writes its own
+                    // block of val1.
+                    val0 = val1 * model.getDiscount();
+                    variation = parallelBellmanBackup(model, ir, val0, q, pool);
+                }
+                return std::make_tuple(useTolerance ? variation : 0.0, std::move(v1_), std::move(q));
+            }
+        }
+
         while ( timestep < horizon_ && (!useTolerance || variation > tolerance_) ) {
             ++timestep;
             AI_LOGGER(AI_SEVERITY_DEBUG, "Processing timestep " << timestep);
@@ -184,6 +255,49 @@ namespace AIToolbox::MDP {
         // as we stop as within the given tolerance.
         return std::make_tuple(useTolerance ? variation : 0.0, std::move(v1_), std::move(q));
     }
+
+    template <typename M, typename IR>
+    double ValueIteration::parallelBellmanBackup(const M & model, const IR & ir, const Values & v, QFunction & q, ThreadPool & pool) {
+        const size_t S = model.getS();
+        const size_t A = model.getA();
+
+        auto & values  = v1_.values;
+        auto & actions = v1_.actions;
+
+        std::vector<double> variations(pool.size(), 0.0);
+
+        pool.parallelFor(S, [&](const size_t begin, const size_t end, const unsigned id) {
+            const auto rows = static_cast<Eigen::Index>(end - begin);
+
+            // Both Model and SparseModel store their matrices in row-major
+            // order, so taking a block of rows is cheap and contiguous.
+            q.middleRows(begin, rows) = ir.middleRows(begin, rows);
+
+            bool stacked = false;
+            if constexpr (is_model_stacked_v<M>) {
+                // The rows of the stacked matrix for our states are
+                // contiguous, and map directly onto our block of q.
+                if ( model.isStackedTransitionsEnabled() ) {
+                    const auto & t = model.getStackedTransitionFunction();
+                    Eigen::Map<Vector>(q.row(begin).data(), rows * A).noalias() += t.middleRows(begin * A, rows * A).template cast<double>() * v;
+                    stacked = true;
+                }
+            }
+            if ( !stacked )
+                for ( size_t a = 0; a < A; ++a )
+                    q.middleRows(begin, rows).col(a).noalias() += model.getTransitionFunction(a).middleRows(begin, rows).template cast<double>() * v;
+
+            double variation = 0.0;
+            for ( size_t s = begin; s < end; ++s ) {
+                const double old = values(s);
+                values(s) = q.row(s).maxCoeff(&actions[s]);
+                variation = std::max(variation, std::fabs(values(s) - old));
+            }
+            variations[id] = variation;
+        });
+
+        return *std::max_element(std::begin(variations), std::end(variations));
+    }
 }
 
 #endif
@@ -0,0 +1,101 @@
+#ifndef AI_TOOLBOX_MDP_CONCURRENT_RECORDER_HEADER_FILE
+#define AI_TOOLBOX_MDP_CONCURRENT_RECORDER_HEADER_FILE
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <AIToolbox/MDP/Experience.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class allows multiple threads to record into the same Experience.
+     *
+     * Experience::record() is not thread-safe, so sharing an Experience
+     * between threads normally requires each of them to keep a private
+     * copy, and to merge them afterwards. For large state spaces this
+     * wastes a lot of memory.
+     *
+     * This class instead protects a single Experience with a set of
+     * striped locks: each state-action pair is assigned to one of the
+     * stripes, and recording an event only locks the stripe of its pair.
+     * Since all data modified by a record is indexed by the state-action
+     * pair, threads recording different pairs only rarely contend.
+     *
+     * The number of timesteps is counted atomically, and it is added to
+     * the Experience on flush() and on destruction. At the same time the
+     * Experience version is increased once, and the state-action pairs
+     * modified in each stripe are added to its dirty pairs (see
+     * Experience::getDirtyPairs()) with that version, as if all records
+     * since the last flush had been a single recordBatch().
+     *
+     * Reading from the Experience (for example syncing a
+     * MaximumLikelihoodModel or a ThompsonModel) while other threads are
+     * recording is not safe; it should be done after all threads are done.
+     */
+    class ConcurrentRecorder {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * @param exp The Experience to record into.
+             * @param stripes The number of locks to use.
+             */
+            ConcurrentRecorder(Experience & exp, size_t stripes = 64);
+
+            /**
+             * @brief Destructor.
+             *
+             * This calls flush().
+             */
+            ~ConcurrentRecorder();
+
+            /**
+             * @brief This function adds a new event to the recordings.
+             *
+             * This function can be called concurrently from multiple
+             * threads.
+             *
+             * @param s     Old state.
+             * @param a     Performed action.
+             * @param s1    New state.
+             * @param rew   Obtained reward.
+             */
+            void record(size_t s, size_t a, size_t s1, double rew);
+
+            /**
+             * @brief This function adds the timesteps and modified pairs recorded so far to the Experience.
+             *
+             * This function should not be called while other threads are
+             * reading the timesteps of the underlying Experience.
+             */
+            void flush();
+
+            /**
+             * @brief This function returns the number of locks used.
+             *
+             * @return The number of stripes.
+             */
+            size_t getStripes() const;
+
+            /**
+             * @brief This function returns the underlying Experience.
+             *
+             * @return The Experience being recorded into.
+             */
+            const Experience & getExperience() const;
+
+        private:
+            // Each mutex gets its own cache line to avoid false sharing.
+            struct alignas(64) Stripe {
+                std::mutex mutex;
+                std::vector<std::pair<size_t, size_t>> dirty;
+            };
+
+            Experience & exp_;
+            std::vector<Stripe> stripes_;
+            std::atomic<unsigned long> timesteps_;
+    };
+}
+
+#endif
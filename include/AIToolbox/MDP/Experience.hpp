@@ -2,10 +2,13 @@
 #define AI_TOOLBOX_MDP_EXPERIENCE_HEADER_FILE
 
 #include <iosfwd>
+#include <utility>
+#include <vector>
 
 #include <AIToolbox/Types.hpp>
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/Utils/Core.hpp>
+#include <AIToolbox/Impl/DirtySync.hpp>
 
 namespace AIToolbox::MDP {
     /**
@@ -109,6 +112,44 @@ namespace AIToolbox::MDP {
              */
             void record(size_t s, size_t a, size_t s1, double rew);
 
+            /**
+             * @brief This function adds all the data recorded in another Experience to this one.
+             *
+             * Visits and timesteps are summed, while rewards and M2s are
+             * combined with the parallel variant of Welford's algorithm, so
+             * that the result is the same as if all events had been
+             * recorded in this Experience.
+             *
+             * This is useful to combine experiences gathered separately
+             * (for example by different threads).
+             *
+             * The input Experience must have the same S and A as this one,
+             * or the function will throw an std::invalid_argument.
+             *
+             * @param other The Experience to merge into this one.
+             */
+            void merge(const Experience & other);
+
+            /**
+             * @brief This function adds a batch of events to the recordings.
+             *
+             * The events are passed as four parallel arrays, so that logged
+             * data can be ingested without copies. Events are grouped by
+             * state-action pair, and each group is merged into the recorded
+             * data at once using the parallel variant of Welford's
+             * algorithm.
+             *
+             * The result is the same as calling record() on each event, up
+             * to floating point rounding.
+             *
+             * @param n     The number of events.
+             * @param s     The old states.
+             * @param a     The performed actions.
+             * @param s1    The new states.
+             * @param rew   The obtained rewards.
+             */
+            void recordBatch(size_t n, const size_t * s, const size_t * a, const size_t * s1, const double * rew);
+
             /**
              * @brief This function resets all experienced rewards, transitions and M2s.
              */
@@ -121,6 +162,67 @@ namespace AIToolbox::MDP {
              */
             unsigned long getTimesteps() const;
 
+            /**
+             * @brief This function returns the current version of the Experience.
+             *
+             * The version is a counter which increases every time the
+             * Experience is modified. Together with getVersion(size_t,
+             * size_t), it allows users (like MaximumLikelihoodModel) to
+             * find out which state-action pairs changed since they last
+             * looked at the Experience.
+             *
+             * @return The current version.
+             */
+            unsigned long getVersion() const;
+
+            /**
+             * @brief This function returns the version at which a state-action pair was last modified.
+             *
+             * If the returned value is higher than a version previously
+             * obtained from getVersion(), the pair has been modified since
+             * then.
+             *
+             * @param s Old state.
+             * @param a Performed action.
+             *
+             * @return The version of the last modification of the pair.
+             */
+            unsigned long getVersion(size_t s, size_t a) const;
+
+            /**
+             * @brief This function returns the current epoch of the Experience.
+             *
+             * A new epoch starts whenever all state-action pairs are
+             * modified at once: on construction, reset(), the table
+             * setters and when reading from a stream. Epochs are unique
+             * across all instances, so a different epoch means that the
+             * whole Experience must be considered modified. A copy (made
+             * through construction or assignment) always starts a new
+             * epoch, as its data may differ from its previous one.
+             *
+             * @return The current epoch.
+             */
+            unsigned long getEpoch() const;
+
+            /**
+             * @brief This function returns the state-action pairs modified after the input version.
+             *
+             * Each pair appears at most once, in the order of its last
+             * modification. Changes to all pairs at once are not listed,
+             * but start a new epoch (see getEpoch()); the input version
+             * should then come from the current epoch.
+             *
+             * This function does not modify the Experience, so any number
+             * of users (like MaximumLikelihoodModel) can track it, each
+             * with the version returned by getVersion() at the time of
+             * their last look.
+             *
+             * @param version A version previously obtained from getVersion().
+             *
+             * @return The modified state-action pairs.
+             */
+            std::vector<std::pair<size_t, size_t>> getDirtyPairs(unsigned long version) const;
+
             /**
              * @brief This function returns the current recorded visits for a transition.
              *
@@ -216,7 +318,29 @@ namespace AIToolbox::MDP {
             Matrix2D M2s_;
             unsigned long timesteps_;
 
+            /**
+             * @brief This function marks a state-action pair as modified at the input version.
+             *
+             * @param s Old state.
+             * @param a Performed action.
+             * @param version The version of the modification.
+             */
+            void markDirty(size_t s, size_t a, unsigned long version);
+
+            /**
+             * @brief This function marks all state-action pairs as modified, starting a new epoch.
+             */
+            void markAllDirty();
+
+            // Modification tracking; resetVersion_ is the version of the
+            // last change that touched all pairs at once.
+            unsigned long version_, resetVersion_;
+            Impl::Epoch epoch_;
+            Table2D pairVersions_;
+            Impl::DirtyLog dirty_;
+
             friend std::istream& operator>>(std::istream &is, Experience &);
+            friend class ConcurrentRecorder;
     };
 
     template <typename V>
@@ -230,6 +354,8 @@ namespace AIToolbox::MDP {
                 }
             }
         }
+
+        markAllDirty();
     }
 
     template <typename R>
@@ -237,6 +363,8 @@ namespace AIToolbox::MDP {
         for ( size_t s = 0; s < S; ++s )
             for ( size_t a = 0; a < A; ++a )
                 rewards_(s, a) = r[s][a];
+
+        markAllDirty();
     }
 
     template <typename MM>
@@ -244,6 +372,8 @@ namespace AIToolbox::MDP {
         for ( size_t s = 0; s < S; ++s )
             for ( size_t a = 0; a < A; ++a )
                 M2s_(s, a) = m[s][a];
+
+        markAllDirty();
     }
 }
 
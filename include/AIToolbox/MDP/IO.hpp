@@ -7,6 +7,7 @@
 #include <AIToolbox/MDP/Policies/PolicyInterface.hpp>
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 
 namespace AIToolbox::MDP {
     /**
@@ -140,6 +141,81 @@ namespace AIToolbox::MDP {
      */
     std::istream& operator>>(std::istream &is, Model & m);
 
+    /**
+     * @brief This function writes an MDP::Model to a stream in binary format.
+     *
+     * The binary format stores the transition and reward matrices as they
+     * are laid out in memory, so that they can be loaded back without any
+     * parsing with loadBinaryModel(). The stream should be opened in
+     * binary mode.
+     *
+     * Files are only portable between machines with the same byte order.
+     *
+     * @param os The output stream.
+     * @param m The model to write.
+     *
+     * @return The output stream.
+     */
+    std::ostream& writeBinary(std::ostream &os, const Model & m);
+
+    /**
+     * @brief This function writes an MDP::SparseModelT to a stream in binary format.
+     *
+     * The transition and reward matrices are stored in CSR form, exactly
+     * as they are kept in memory, and the file records the scalar type of
+     * the transition function. The file can be loaded back with
+     * loadBinarySparseModel() using the same scalar type. The stream
+     * should be opened in binary mode.
+     *
+     * @tparam Scalar The scalar type of the transition function (double or float).
+     * @param os The output stream.
+     * @param m The model to write.
+     *
+     * @return The output stream.
+     */
+    template <typename Scalar>
+    std::ostream& writeBinary(std::ostream &os, const SparseModelT<Scalar> & m);
+
+    /**
+     * @brief This function loads an MDP::Model from a binary file.
+     *
+     * Each matrix is read from the file directly into the new Model. The
+     * data is assumed to be a valid model, and it is not checked again,
+     * except for the discount. Only sparse models can be memory-mapped
+     * (see MappedSparseModelT), so every process that loads a dense model
+     * holds its own copy of it.
+     *
+     * This function throws std::runtime_error if the file cannot be read,
+     * or if it does not contain an MDP::Model written by writeBinary().
+     *
+     * @param filename The name of the file to load.
+     *
+     * @return The loaded model.
+     */
+    Model loadBinaryModel(const std::string & filename);
+
+    /**
+     * @brief This function loads an MDP::SparseModelT from a binary file.
+     *
+     * Each CSR array is read from the file directly into the new
+     * SparseModelT. The data is assumed to be a valid model, and it is not
+     * checked again, except for the sparse indices and the discount.
+     *
+     * The loaded model owns its data. To share a single read-only copy of
+     * the file between processes, map it with MappedSparseModelT instead.
+     *
+     * This function throws std::runtime_error if the file cannot be read,
+     * or if it does not contain an MDP::SparseModelT with the same scalar
+     * type written by writeBinary().
+     *
+     * @tparam Scalar The scalar type of the transition function (double or float).
+     * @param filename The name of the file to load.
+     *
+     * @return The loaded model.
+     */
+    template <typename Scalar = double>
+    SparseModelT<Scalar> loadBinarySparseModel(const std::string & filename);
+
     class Policy;
     /**
      * @brief This function implements input from stream for the MDP::Model class.
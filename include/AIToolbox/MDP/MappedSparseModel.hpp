@@ -0,0 +1,180 @@
+#ifndef AI_TOOLBOX_MDP_MAPPED_SPARSE_MODEL_HEADER_FILE
+#define AI_TOOLBOX_MDP_MAPPED_SPARSE_MODEL_HEADER_FILE
+
+#include <string>
+#include <tuple>
+
+#include <AIToolbox/Types.hpp>
+#include <AIToolbox/Impl/BinaryModelFormat.hpp>
+
+namespace AIToolbox::MDP {
+    /**
+     * @brief This class represents a read-only MDP mapped from a binary file.
+     *
+     * This class offers the same read interface as SparseModelT, but
+     * rather than owning its data it maps a file written with
+     * writeBinary() from a SparseModelT with the same scalar type. The
+     * transition and reward functions are Eigen maps over the CSR arrays
+     * in the file, so nothing is parsed or copied.
+     *
+     * Since the file is mapped read-only, any number of processes on the
+     * same host can map the same file and share a single copy of it in
+     * memory, and creating a model is about as fast as validating its
+     * sparse indices. The model can be used wherever a read-only sparse
+     * MDP model is expected, for example with the planning algorithms.
+     *
+     * The data is assumed to be a valid model, and it is not checked,
+     * except for the sparse indices and the discount. As the model
+     * cannot be modified, it has no sampling index nor stacked transition
+     * matrix; sampleSR() simply scans the row of the input pair.
+     *
+     * Copies of a MappedSparseModelT share the same mapping, which is
+     * released when the last of them is destroyed. The file must not be
+     * modified or truncated while it is mapped.
+     *
+     * @tparam Scalar The scalar type of the transition function (double or float).
+     */
+    template <typename Scalar>
+    class MappedSparseModelT {
+        public:
+            using TransitionMatrix   = std::vector<Eigen::Map<const SparseMatrix2DT<Scalar>>>;
+            using RewardMatrix       = Eigen::Map<const SparseMatrix2D>;
+
+            /**
+             * @brief Basic constructor.
+             *
+             * This constructor maps the input file.
+             *
+             * This function throws std::runtime_error if the file cannot
+             * be mapped, or if it does not contain an MDP::SparseModelT
+             * with the same scalar type written by writeBinary().
+             *
+             * @param filename The name of the file to map.
+             */
+            explicit MappedSparseModelT(const std::string & filename);
+
+            /**
+             * @brief This function samples the MDP for the specified state action pair.
+             *
+             * This function samples the model for simulated experience.
+             * The transition and reward functions are used to produce,
+             * from the state action pair inserted as arguments, a possible
+             * new state with respective reward.
+             *
+             * @param s The state that needs to be sampled.
+             * @param a The action that needs to be sampled.
+             *
+             * @return A tuple containing a new state and a reward.
+             */
+            std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
+
+            /**
+             * @brief This function samples the MDP with the specified state action pair and random engine.
+             *
+             * This function is equivalent to sampleSR(size_t, size_t), but
+             * draws its randomness from the input engine rather than from
+             * the one of the model. Concurrent calls with different
+             * engines are thread-safe.
+             *
+             * @param s The state that needs to be sampled.
+             * @param a The action that needs to be sampled.
+             * @param rnd The random engine to use.
+             *
+             * @return A tuple containing a new state and a reward.
+             */
+            std::tuple<size_t, double> sampleSR(size_t s, size_t a, RandomEngine & rnd) const;
+
+            /**
+             * @brief This function returns the number of states of the world.
+             *
+             * @return The total number of states.
+             */
+            size_t getS() const;
+
+            /**
+             * @brief This function returns the number of available actions to the agent.
+             *
+             * @return The total number of actions.
+             */
+            size_t getA() const;
+
+            /**
+             * @brief This function returns the discount factor stored in the file.
+             *
+             * @return The discount factor.
+             */
+            double getDiscount() const;
+
+            /**
+             * @brief This function returns the stored transition probability for the specified transition.
+             *
+             * @param s The initial state of the transition.
+             * @param a The action performed in the transition.
+             * @param s1 The final state of the transition.
+             *
+             * @return The probability of the specified transition.
+             */
+            double getTransitionProbability(size_t s, size_t a, size_t s1) const;
+
+            /**
+             * @brief This function returns the stored expected reward for the specified transition.
+             *
+             * @param s The initial state of the transition.
+             * @param a The action performed in the transition.
+             * @param s1 The final state of the transition.
+             *
+             * @return The expected reward of the specified transition.
+             */
+            double getExpectedReward(size_t s, size_t a, size_t s1) const;
+
+            /**
+             * @brief This function returns the transition matrix for inspection.
+             *
+             * @return The transition matrix.
+             */
+            const TransitionMatrix & getTransitionFunction() const;
+
+            /**
+             * @brief This function returns the transition function for a given action.
+             *
+             * @param a The action requested.
+             *
+             * @return The transition function for the input action.
+             */
+            const Eigen::Map<const SparseMatrix2DT<Scalar>> & getTransitionFunction(size_t a) const;
+
+            /**
+             * @brief This function returns the rewards matrix for inspection.
+             *
+             * @return The rewards matrix.
+             */
+            const RewardMatrix & getRewardFunction() const;
+
+            /**
+             * @brief This function returns whether a given state is a terminal.
+             *
+             * @param s The state examined.
+             *
+             * @return True if the input state is a terminal, false otherwise.
+             */
+            bool isTerminal(size_t s) const;
+
+        private:
+            Impl::BinaryModelMapping mapping_;
+
+            size_t S, A;
+            double discount_;
+
+            TransitionMatrix transitions_;
+            RewardMatrix rewards_;
+
+            mutable RandomEngine rand_;
+    };
+
+    using MappedSparseModel = MappedSparseModelT<double>;
+
+    extern template class MappedSparseModelT<double>;
+    extern template class MappedSparseModelT<float>;
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <AIToolbox/MDP/TypeTraits.hpp>
 #include <AIToolbox/Utils/Core.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/SamplingIndex.hpp>
 
 namespace AIToolbox::MDP {
     /**
@@ -239,6 +240,36 @@ namespace AIToolbox::MDP {
              */
             void setDiscount(double d);
 
+            /**
+             * @brief This function enables or disables the sampling index of the Model.
+             *
+             * By default, sampleSR() samples new states by scanning the
+             * transition row of the input state-action pair, which takes
+             * time linear in the size of the row. When the sampling index
+             * is enabled, the Model instead keeps a VoseAliasSampler for
+             * each state-action pair, built over the non-zero transitions
+             * only, so that each sample takes constant time.
+             *
+             * The index can be built eagerly (immediately, for all
+             * state-action pairs), or lazily (each pair is built the first
+             * time it is sampled). The index is automatically discarded
+             * whenever the transition function is changed; if eager, it is
+             * then rebuilt.
+             *
+             * Note that a lazy index is built from within sampleSR(), so
+             * concurrent calls to sampleSR() on the same instance are not
+             * thread-safe. If the model is sampled from multiple threads,
+             * use an eager index (or none), and the sampleSR() overload
+             * that takes a random engine, with one engine per thread.
+             *
+             * Disabling the index frees all its memory. The memory used by
+             * the index can be inspected with getSamplingIndexMemory().
+             *
+             * @param enabled Whether sampleSR() should use the sampling index.
+             * @param eager Whether the index should be built immediately.
+             */
+            void setSamplingIndex(bool enabled, bool eager = false);
+
             /**
              * @brief This function samples the MDP with the specified state action pair.
              *
@@ -252,6 +283,10 @@ namespace AIToolbox::MDP {
              * the reward is the corresponding reward contained in the
              * reward function.
              *
+             * This function is not thread-safe if the sampling index is
+             * enabled and lazy, as it may build the index of the input
+             * pair; see setSamplingIndex().
+             *
              * @param s The state that needs to be sampled.
              * @param a The action that needs to be sampled.
              *
@@ -259,6 +294,23 @@ namespace AIToolbox::MDP {
              */
             std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
 
+            /**
+             * @brief This function samples the MDP with the specified state action pair and random engine.
+             *
+             * This function is equivalent to sampleSR(size_t, size_t), but
+             * draws its randomness from the input engine rather than from
+             * the one of the Model. Concurrent calls with different engines
+             * are thread-safe, as long as the sampling index is disabled or
+             * eager.
+             *
+             * @param s The state that needs to be sampled.
+             * @param a The action that needs to be sampled.
+             * @param rnd The random engine to use.
+             *
+             * @return A tuple containing a new state and a reward.
+             */
+            std::tuple<size_t, double> sampleSR(size_t s, size_t a, RandomEngine & rnd) const;
+
             /**
              * @brief This function returns the number of states of the world.
              *
@@ -334,13 +386,38 @@ namespace AIToolbox::MDP {
              */
             bool isTerminal(size_t s) const;
 
+            /**
+             * @brief This function returns whether sampleSR() uses the sampling index.
+             *
+             * @return True if the sampling index is enabled, false otherwise.
+             */
+            bool isSamplingIndexEnabled() const;
+
+            /**
+             * @brief This function returns the memory currently used by the sampling index, in bytes.
+             *
+             * @return The number of bytes used by the sampling index.
+             */
+            size_t getSamplingIndexMemory() const;
+
         private:
+            /**
+             * @brief This function discards the sampling index, and rebuilds it if needed.
+             *
+             * This function must be called whenever the transition
+             * function is modified.
+             */
+            void resetSamplingIndex();
+
             size_t S, A;
             double discount_;
 
             TransitionMatrix transitions_;
             RewardMatrix rewards_;
 
+            bool useSamplingIndex_, eagerSamplingIndex_;
+            mutable SamplingIndex samplingIndex_;
+
             mutable RandomEngine rand_;
 
             friend std::istream& operator>>(std::istream &is, Model &);
@@ -349,7 +426,8 @@ namespace AIToolbox::MDP {
     template <typename T, typename R>
     Model::Model(const size_t s, const size_t a, const T & t, const R & r, const double d) :
             S(s), A(a), transitions_(A, Matrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            rand_(Impl::Seeder::getSeed())
     {
         setDiscount(d);
         setTransitionFunction(t);
@@ -359,7 +437,8 @@ namespace AIToolbox::MDP {
     template <typename M, typename>
     Model::Model(const M& model) :
             S(model.getS()), A(model.getA()), transitions_(A, Matrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            rand_(Impl::Seeder::getSeed())
     {
         setDiscount(model.getDiscount());
         rewards_.setZero();
@@ -386,6 +465,8 @@ namespace AIToolbox::MDP {
             for ( size_t a = 0; a < A; ++a )
                 for ( size_t s1 = 0; s1 < S; ++s1 )
                     transitions_[a](s, s1) = t[s][a][s1];
+
+        resetSamplingIndex();
     }
 
     template <typename R>
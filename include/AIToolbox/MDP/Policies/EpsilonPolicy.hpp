@@ -23,6 +23,17 @@ namespace AIToolbox::MDP {
              */
             EpsilonPolicy(const PolicyInterface & p, double epsilon = 0.1);
 
+            /**
+             * @brief This function writes the probabilities of all actions in the specified state.
+             *
+             * This asks the underlying policy for all its probabilities at
+             * once, and then mixes them with the random ones.
+             *
+             * @param s The selected state.
+             * @param out The output vector, of size getA().
+             */
+            virtual void getActionProbabilities(const size_t & s, Vector & out) const override;
+
             /**
              * @brief This function returns a matrix containing all probabilities of the policy.
              *
@@ -12,6 +12,20 @@ namespace AIToolbox::MDP {
         public:
             using Base = AIToolbox::PolicyInterface<size_t, size_t, size_t>;
 
+            /**
+             * @brief This function writes the probabilities of all actions in the specified state.
+             *
+             * This is equivalent to calling getActionProbability() for
+             * every action, which is what the default implementation does.
+             * Derived classes override it whenever the whole row can be
+             * computed at once, avoiding one virtual call per action and
+             * any work that would be repeated in each of them.
+             *
+             * @param s The selected state.
+             * @param out The output vector, of size getA().
+             */
+            virtual void getActionProbabilities(const size_t & s, Vector & out) const;
+
             /**
              * @brief This function returns a matrix containing all probabilities of the policy.
              *
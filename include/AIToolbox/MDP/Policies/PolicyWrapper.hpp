@@ -58,6 +58,16 @@ namespace AIToolbox::MDP {
              */
             virtual double getActionProbability(const size_t & s, const size_t & a) const override;
 
+            /**
+             * @brief This function writes the probabilities of all actions in the specified state.
+             *
+             * This copies the row of the wrapped matrix.
+             *
+             * @param s The selected state.
+             * @param out The output vector, of size getA().
+             */
+            virtual void getActionProbabilities(const size_t & s, Vector & out) const override;
+
             /**
              * @brief This function enables inspection of the internal policy.
              *
@@ -9,6 +9,11 @@ namespace AIToolbox::MDP {
      *
      * This class allows you to select effortlessly the best greedy actions
      * from a given QFunction.
+     *
+     * By default every call scans the row of the QFunction for the input
+     * state. When the same states are sampled many times between changes
+     * to the QFunction, the greedy actions of each state can instead be
+     * cached; see enableCache().
      */
     class QGreedyPolicy : public QPolicyInterface {
         public:
@@ -45,6 +50,17 @@ namespace AIToolbox::MDP {
              */
             virtual double getActionProbability(const size_t & s, const size_t & a) const override;
 
+            /**
+             * @brief This function writes the probabilities of all actions in the specified state.
+             *
+             * This scans the row of the QFunction once, or reads the
+             * cache if it is enabled.
+             *
+             * @param s The selected state.
+             * @param out The output vector, of size getA().
+             */
+            virtual void getActionProbabilities(const size_t & s, Vector & out) const override;
+
             /**
              * @brief This function returns a matrix containing all probabilities of the policy.
              *
@@ -59,9 +75,60 @@ namespace AIToolbox::MDP {
              */
             virtual Matrix2D getPolicy() const override;
 
+            /**
+             * @brief This function enables caching of the greedy actions of each state.
+             *
+             * The greedy actions of a state are computed the first time
+             * the state is queried, and then reused until the input
+             * counter changes value. Learning methods provide such a
+             * counter through their getQFunctionVersion() method, and
+             * increment it on every change to their QFunction.
+             *
+             * With the cache, sampling an action takes constant time and
+             * gives the same results as without it, as long as the counter
+             * is incremented after every change to the QFunction.
+             *
+             * The counter is kept by reference, so it must outlive this
+             * policy, or the cache must be disabled before it is
+             * destroyed.
+             *
+             * @param version The version counter of the QFunction.
+             */
+            void enableCache(const size_t & version);
+
+            /**
+             * @brief This function disables the cache and frees its memory.
+             */
+            void disableCache();
+
+            /**
+             * @brief This function returns whether the cache is enabled.
+             *
+             * @return Whether the cache is enabled.
+             */
+            bool isCacheEnabled() const;
+
         private:
+            /**
+             * @brief This function returns the number of greedy actions of a state, updating the cache if needed.
+             *
+             * The greedy actions are then stored in cachedActions_, from s * A.
+             *
+             * @param s The state to look up.
+             *
+             * @return The number of greedy actions of the state.
+             */
+            unsigned getCachedActions(size_t s) const;
+
             // To avoid reallocating a vector every time for sampling.
             mutable std::vector<size_t> bestActions_;
+
+            // Cache of the greedy actions per state, valid while the stamp
+            // of the state equals the version counter plus one.
+            const size_t * version_;
+            mutable std::vector<size_t> cacheStamps_;
+            mutable std::vector<unsigned> cachedCounts_;
+            mutable std::vector<size_t> cachedActions_;
     };
 }
 
@@ -42,7 +42,8 @@ namespace AIToolbox::MDP {
              *      P(a) = \frac{e^{(Q(s,a)/t)})}{\sum_b{e^{(Q(s,b)/t)}}}
              * \f]
              *
-             * where t is the temperature. This value is not cached anywhere, so
+             * where t is the temperature. Unless the cache is enabled (see
+             * enableCache()) this value is recomputed at every call, so
              * continuous sampling may not be extremely fast.
              *
              * @param s The sampled state of the policy.
@@ -63,6 +64,17 @@ namespace AIToolbox::MDP {
              */
             virtual double getActionProbability(const size_t & s, const size_t & a) const override;
 
+            /**
+             * @brief This function writes the probabilities of all actions in the specified state.
+             *
+             * This computes the exponentials of the row once, or reads the
+             * cache if it is enabled.
+             *
+             * @param s The selected state.
+             * @param out The output vector, of size getA().
+             */
+            virtual void getActionProbabilities(const size_t & s, Vector & out) const override;
+
             /**
              * @brief This function returns a matrix containing all probabilities of the policy.
              *
@@ -101,11 +113,70 @@ namespace AIToolbox::MDP {
              */
             double getTemperature() const;
 
+            /**
+             * @brief This function enables caching of the action distribution of each state.
+             *
+             * The cumulative distribution of the actions of a state is
+             * computed the first time the state is queried, and then
+             * reused until the input counter changes value. Learning
+             * methods provide such a counter through their
+             * getQFunctionVersion() method, and increment it on every
+             * change to their QFunction. Changing the temperature also
+             * clears the cache.
+             *
+             * With the cache, sampling an action only needs a binary
+             * search over the cumulative distribution, with no
+             * exponentials, and follows the same distribution as without
+             * it, as long as the counter is incremented after every change
+             * to the QFunction.
+             *
+             * The counter is kept by reference, so it must outlive this
+             * policy, or the cache must be disabled before it is
+             * destroyed.
+             *
+             * @param version The version counter of the QFunction.
+             */
+            void enableCache(const size_t & version);
+
+            /**
+             * @brief This function disables the cache and frees its memory.
+             */
+            void disableCache();
+
+            /**
+             * @brief This function returns whether the cache is enabled.
+             *
+             * @return Whether the cache is enabled.
+             */
+            bool isCacheEnabled() const;
+
         private:
+            /**
+             * @brief This function updates the cache of a state if needed.
+             *
+             * If the returned count is zero the distribution of the state
+             * is stored in cachedCdf_ from s * A. Otherwise the state
+             * samples uniformly between that many actions, which are
+             * stored in cachedActions_ from s * A.
+             *
+             * @param s The state to look up.
+             *
+             * @return The number of equiprobable actions of the state, or zero.
+             */
+            unsigned getCachedActions(size_t s) const;
+
             double temperature_;
             // To avoid reallocating a vector every time for sampling.
             mutable std::vector<size_t> bestActions_;
             mutable Vector vbuffer_;
+
+            // Cache of the distribution per state, valid while the stamp
+            // of the state equals the version counter plus one.
+            const size_t * version_;
+            mutable std::vector<size_t> cacheStamps_;
+            mutable std::vector<unsigned> cachedCounts_;
+            mutable std::vector<size_t> cachedActions_;
+            mutable std::vector<double> cachedCdf_;
     };
 }
 
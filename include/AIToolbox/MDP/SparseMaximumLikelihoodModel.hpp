@@ -3,7 +3,10 @@
 
 #include <tuple>
 #include <random>
+#include <utility>
+#include <vector>
 
+#include <AIToolbox/Impl/DirtySync.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 #include <AIToolbox/Types.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
@@ -159,6 +162,28 @@ namespace AIToolbox::MDP {
              */
             void sync(size_t s, size_t a, size_t s1);
 
+            /**
+             * @brief This function syncs all state action pairs that changed in the underlying Experience since the last call.
+             *
+             * This function asks the underlying Experience for the state
+             * action pairs modified since the version of the last call,
+             * and only syncs those. This avoids renormalizing the
+             * transition rows of pairs which did not receive any new data,
+             * and its cost only depends on the number of modified pairs.
+             *
+             * The first call syncs all pairs. Afterwards, all pairs are
+             * synced whenever the Experience starts a new epoch (for
+             * example after a reset, or when it is replaced through
+             * assignment). The Experience is not modified, so any number
+             * of models can call this function on the same Experience.
+             *
+             * This function requires the Experience to provide
+             * getEpoch(), getVersion() and getDirtyPairs().
+             *
+             * @return The state action pairs that have been synced.
+             */
+            std::vector<std::pair<size_t, size_t>> syncDirty();
+
             /**
              * @brief This function samples the MDP for the specified state action pair.
              *
@@ -268,13 +293,15 @@ namespace AIToolbox::MDP {
             TransitionMatrix transitions_;
             RewardMatrix rewards_;
 
+            unsigned long syncedEpoch_, syncedVersion_;
+
             mutable RandomEngine rand_;
     };
 
     template <typename E>
     SparseMaximumLikelihoodModel<E>::SparseMaximumLikelihoodModel(const E & exp, const double discount, const bool toSync) :
             S(exp.getS()), A(exp.getA()), experience_(exp), transitions_(A, SparseMatrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+            rewards_(S, A), syncedEpoch_(0), syncedVersion_(0), rand_(Impl::Seeder::getSeed())
     {
         setDiscount(discount);
 
@@ -343,6 +370,11 @@ namespace AIToolbox::MDP {
         }
     }
 
+    template <typename E>
+    std::vector<std::pair<size_t, size_t>> SparseMaximumLikelihoodModel<E>::syncDirty() {
+        return Impl::syncDirty(*this, experience_, syncedEpoch_, syncedVersion_);
+    }
+
     template <typename E>
     void SparseMaximumLikelihoodModel<E>::sync(const size_t s, const size_t a, const size_t s1) {
         const auto visitSum = experience_.getVisitsSum(s, a);
@@ -7,8 +7,16 @@
 #include <AIToolbox/MDP/TypeTraits.hpp>
 
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/SamplingIndex.hpp>
 
 namespace AIToolbox::MDP {
+    template <typename Scalar>
+    class SparseModelT;
+
+    // Declaration to warn the compiler that this is a template function
+    template <typename Scalar>
+    std::istream& operator>>(std::istream &is, SparseModelT<Scalar> & m);
+
     /**
      * @brief This class represents a Markov Decision Process.
      *
@@ -73,10 +81,21 @@ namespace AIToolbox::MDP {
      * SxAxS. It also of course incredibly reduces memory consumption in
      * such cases, which may also improve speed by effect of improved
      * caching.
+     *
+     * The transition function can be stored in a different precision
+     * than double via the Scalar template parameter. For very large
+     * models, storing transitions as float halves their memory footprint
+     * and the memory bandwidth needed by planning algorithms, which still
+     * accumulate their results in double. The reward function is always
+     * stored as double. MDP::SparseModel is the double version of this
+     * class.
+     *
+     * @tparam Scalar The type used to store the transition function.
      */
-    class SparseModel {
+    template <typename Scalar>
+    class SparseModelT {
         public:
-            using TransitionMatrix   = SparseMatrix3D;
+            using TransitionMatrix   = SparseMatrix3DT<Scalar>;
             using RewardMatrix       = SparseMatrix2D;
 
             /**
@@ -93,7 +112,7 @@ namespace AIToolbox::MDP {
              * @param a The number of actions available to the agent.
              * @param discount The discount factor for the MDP.
              */
-            SparseModel(size_t s, size_t a, double discount = 1.0);
+            SparseModelT(size_t s, size_t a, double discount = 1.0);
 
             /**
              * @brief Basic constructor.
@@ -137,7 +156,7 @@ namespace AIToolbox::MDP {
              * @param d The discount factor for the MDP.
              */
             template <typename T, typename R>
-            SparseModel(size_t s, size_t a, const T & t, const R & r, double d = 1.0);
+            SparseModelT(size_t s, size_t a, const T & t, const R & r, double d = 1.0);
 
             /**
              * @brief Copy constructor from any valid MDP model.
@@ -152,7 +171,7 @@ namespace AIToolbox::MDP {
              * @param model The model that needs to be copied.
              */
             template <typename M, typename = std::enable_if_t<is_model_v<M>>>
-            SparseModel(const M& model);
+            SparseModelT(const M& model);
 
             /**
              * @brief Unchecked constructor.
@@ -171,7 +190,7 @@ namespace AIToolbox::MDP {
              * @param r The reward function to be used in the SparseModel.
              * @param d The discount factor for the SparseModel.
              */
-            SparseModel(NoCheck, size_t s, size_t a, TransitionMatrix && t, RewardMatrix && r, double d);
+            SparseModelT(NoCheck, size_t s, size_t a, TransitionMatrix && t, RewardMatrix && r, double d);
 
             /**
              * @brief This function replaces the transition function with the one provided.
@@ -270,6 +289,72 @@ namespace AIToolbox::MDP {
              */
             void setDiscount(double d);
 
+            /**
+             * @brief This function enables or disables the sampling index of the Model.
+             *
+             * By default, sampleSR() samples new states by scanning the
+             * transition row of the input state-action pair, which takes
+             * time linear in the size of the row. When the sampling index
+             * is enabled, the Model instead keeps a VoseAliasSampler for
+             * each state-action pair, built over the non-zero transitions
+             * only, so that each sample takes constant time.
+             *
+             * The index can be built eagerly (immediately, for all
+             * state-action pairs), or lazily (each pair is built the first
+             * time it is sampled). The index is automatically discarded
+             * whenever the transition function is changed; if eager, it is
+             * then rebuilt.
+             *
+             * Note that a lazy index is built from within sampleSR(), so
+             * concurrent calls to sampleSR() on the same instance are not
+             * thread-safe. If the model is sampled from multiple threads,
+             * use an eager index (or none), and the sampleSR() overload
+             * that takes a random engine, with one engine per thread.
+             *
+             * Disabling the index frees all its memory. The memory used by
+             * the index can be inspected with getSamplingIndexMemory().
+             *
+             * @param enabled Whether sampleSR() should use the sampling index.
+             * @param eager Whether the index should be built immediately.
+             */
+            void setSamplingIndex(bool enabled, bool eager = false);
+
+            /**
+             * @brief This function enables or disables the stacked transition matrix of the SparseModel.
+             *
+             * By default, the transition function is stored as A separate
+             * SxS sparse matrices, so that computing a full QFunction from
+             * a ValueFunction requires A separate sparse matrix-vector
+             * products.
+             *
+             * When enabled, the SparseModel additionally keeps a single
+             * (S*A)xS sparse matrix where the row for each state-action
+             * pair is stored at index s * A + a. Since QFunctions are
+             * stored in row-major order, a full Bellman backup becomes a
+             * single product whose output maps directly onto the
+             * QFunction, and which streams through the transition data
+             * only once.
+             *
+             * Algorithms which support it (ValueIteration,
+             * PolicyEvaluation, PrioritizedSweeping, ...) automatically
+             * use the stacked matrix when it is enabled.
+             *
+             * Note that the stacked matrix is a copy of the per-action
+             * matrices, so enabling it doubles the memory used to store the
+             * transition function. The per-action matrices cannot be
+             * replaced by views over the stacked one: its rows interleave
+             * all actions, so the rows of any single action are not
+             * contiguous, and getTransitionFunction() must keep returning
+             * a plain SxS matrix for existing callers.
+             *
+             * The stacked matrix is automatically rebuilt whenever the
+             * transition function is changed. Disabling it frees all its
+             * memory.
+             *
+             * @param enabled Whether the stacked transition matrix should be kept.
+             */
+            void setStackedTransitions(bool enabled);
+
             /**
              * @brief This function samples the MDP for the specified state action pair.
              *
@@ -283,6 +368,10 @@ namespace AIToolbox::MDP {
              * the reward is the corresponding reward contained in the
              * reward function.
              *
+             * This function is not thread-safe if the sampling index is
+             * enabled and lazy, as it may build the index of the input
+             * pair; see setSamplingIndex().
+             *
              * @param s The state that needs to be sampled.
              * @param a The action that needs to be sampled.
              *
@@ -290,6 +379,23 @@ namespace AIToolbox::MDP {
              */
             std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
 
+            /**
+             * @brief This function samples the MDP with the specified state action pair and random engine.
+             *
+             * This function is equivalent to sampleSR(size_t, size_t), but
+             * draws its randomness from the input engine rather than from
+             * the one of the Model. Concurrent calls with different engines
+             * are thread-safe, as long as the sampling index is disabled or
+             * eager.
+             *
+             * @param s The state that needs to be sampled.
+             * @param a The action that needs to be sampled.
+             * @param rnd The random engine to use.
+             *
+             * @return A tuple containing a new state and a reward.
+             */
+            std::tuple<size_t, double> sampleSR(size_t s, size_t a, RandomEngine & rnd) const;
+
             /**
              * @brief This function returns the number of states of the world.
              *
@@ -347,7 +453,21 @@ namespace AIToolbox::MDP {
              *
              * @return The transition function for the input action.
              */
-            const SparseMatrix2D & getTransitionFunction(size_t a) const;
+            const SparseMatrix2DT<Scalar> & getTransitionFunction(size_t a) const;
+
+            /**
+             * @brief This function returns the stacked transition matrix.
+             *
+             * The matrix is (S*A)xS, and the row for the state-action
+             * pair (s,a) is at index s * A + a.
+             *
+             * This matrix is empty unless setStackedTransitions() has been
+             * used to enable it. When enabled, it takes as much memory as
+             * all the per-action transition matrices combined.
+             *
+             * @return The stacked transition matrix.
+             */
+            const SparseMatrix2DT<Scalar> & getStackedTransitionFunction() const;
 
             /**
              * @brief This function returns the rewards matrix for inspection.
@@ -365,32 +485,79 @@ namespace AIToolbox::MDP {
              */
             bool isTerminal(size_t s) const;
 
+            /**
+             * @brief This function returns whether sampleSR() uses the sampling index.
+             *
+             * @return True if the sampling index is enabled, false otherwise.
+             */
+            bool isSamplingIndexEnabled() const;
+
+            /**
+             * @brief This function returns the memory currently used by the sampling index, in bytes.
+             *
+             * @return The number of bytes used by the sampling index.
+             */
+            size_t getSamplingIndexMemory() const;
+
+            /**
+             * @brief This function returns whether the stacked transition matrix is enabled.
+             *
+             * @return True if the stacked transition matrix is kept, false otherwise.
+             */
+            bool isStackedTransitionsEnabled() const;
+
         private:
+            /**
+             * @brief This function discards the sampling index, and rebuilds it if needed.
+             *
+             * This function must be called whenever the transition
+             * function is modified.
+             */
+            void resetSamplingIndex();
+
+            /**
+             * @brief This function rebuilds the stacked transition matrix, if needed.
+             *
+             * This function must be called whenever the transition
+             * function is modified.
+             */
+            void resetStackedTransitions();
+
             size_t S, A;
             double discount_;
 
             TransitionMatrix transitions_;
             RewardMatrix rewards_;
 
+            bool useSamplingIndex_, eagerSamplingIndex_;
+            mutable SamplingIndex samplingIndex_;
+
+            bool useStackedTransitions_;
+            SparseMatrix2DT<Scalar> stacked_;
+
             mutable RandomEngine rand_;
 
-            friend std::istream& operator>>(std::istream &is, SparseModel &);
+            friend std::istream& operator>> <Scalar>(std::istream &is, SparseModelT<Scalar> &);
     };
 
+    template <typename Scalar>
     template <typename T, typename R>
-    SparseModel::SparseModel(const size_t s, const size_t a, const T & t, const R & r, const double d) :
-            S(s), A(a), transitions_(A, SparseMatrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+    SparseModelT<Scalar>::SparseModelT(const size_t s, const size_t a, const T & t, const R & r, const double d) :
+            S(s), A(a), transitions_(A, SparseMatrix2DT<Scalar>(S, S)),
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            useStackedTransitions_(false), rand_(Impl::Seeder::getSeed())
     {
         setDiscount(d);
         setTransitionFunction(t);
         setRewardFunction(r);
     }
 
+    template <typename Scalar>
     template <typename M, typename>
-    SparseModel::SparseModel(const M& model) :
-            S(model.getS()), A(model.getA()), transitions_(A, SparseMatrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+    SparseModelT<Scalar>::SparseModelT(const M& model) :
+            S(model.getS()), A(model.getA()), transitions_(A, SparseMatrix2DT<Scalar>(S, S)),
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            useStackedTransitions_(false), rand_(Impl::Seeder::getSeed())
     {
         setDiscount(model.getDiscount());
         for ( size_t s = 0; s < S; ++s )
@@ -404,7 +571,7 @@ namespace AIToolbox::MDP {
                 const double r = model.getExpectedReward(s, a, s1);
                 if ( checkDifferentSmall(0.0, r) ) rewards_.coeffRef(s, a) += r * p;
             }
-            if ( checkDifferentSmall(1.0, transitions_[a].row(s).sum()) )
+            if ( checkDifferentSmall(1.0, transitions_[a].row(s).template cast<double>().sum()) )
                 throw std::invalid_argument("Input transition matrix contains an invalid row.");
         }
 
@@ -413,8 +580,9 @@ namespace AIToolbox::MDP {
         rewards_.makeCompressed();
     }
 
+    template <typename Scalar>
     template <typename T>
-    void SparseModel::setTransitionFunction(const T & t) {
+    void SparseModelT<Scalar>::setTransitionFunction(const T & t) {
         // First we verify data, without modifying anything...
         for ( size_t s = 0; s < S; ++s )
             for ( size_t a = 0; a < A; ++a )
@@ -432,10 +600,13 @@ namespace AIToolbox::MDP {
             }
             transitions_[a].makeCompressed();
         }
+        resetSamplingIndex();
+        resetStackedTransitions();
     }
 
+    template <typename Scalar>
     template <typename R>
-    void SparseModel::setRewardFunction( const R & r ) {
+    void SparseModelT<Scalar>::setRewardFunction( const R & r ) {
         rewards_.setZero();
         for ( size_t a = 0; a < A; ++a ) {
             for ( size_t s = 0; s < S; ++s )
@@ -447,6 +618,11 @@ namespace AIToolbox::MDP {
         }
         rewards_.makeCompressed();
     }
+
+    using SparseModel = SparseModelT<double>;
+
+    extern template class SparseModelT<double>;
+    extern template class SparseModelT<float>;
 }
 
 #endif
@@ -46,6 +46,40 @@ namespace AIToolbox::MDP {
     template <typename M>
     inline constexpr bool is_generative_model_v = is_generative_model<M>::value;
 
+    /**
+     * @brief This struct represents the interface of a generative MDP which can be sampled with an external random engine.
+     *
+     * In addition to the generative MDP interface, the class must implement:
+     *
+     * - std::tuple<size_t, double> sampleSR(size_t s, size_t a, RandomEngine & rnd) const : Returns a sampled state-reward pair from (s,a), using the input engine.
+     *
+     * Such models can be sampled from multiple threads at once, each with
+     * its own engine.
+     *
+     * has_engine_sampling<M>::value will be equal to true is M implements the interface,
+     * and false otherwise.
+     *
+     * @tparam M The class to test for the interface.
+     */
+    template <typename M>
+    struct has_engine_sampling {
+        private:
+            template <typename Z> static constexpr auto test(int) -> decltype(
+
+                    static_cast<std::tuple<size_t, double> (Z::*)(size_t,size_t,RandomEngine&) const>     (&Z::sampleSR),
+
+                    bool()
+            ) { return true; }
+
+            template <typename Z> static constexpr auto test(...) -> bool
+            { return false; }
+
+        public:
+            enum { value = is_generative_model_v<M> && test<M>(0) };
+    };
+    template <typename M>
+    inline constexpr bool has_engine_sampling_v = has_engine_sampling<M>::value;
+
     /**
      * @brief This struct represents the required interface for a full MDP.
      *
@@ -164,6 +198,64 @@ namespace AIToolbox::MDP {
     template <typename M>
     inline constexpr bool is_model_not_eigen_v = is_model_not_eigen<M>::value;
 
+    /**
+     * @brief This struct represents the required interface for a model with a stacked transition matrix.
+     *
+     * This struct is used to check interfaces of classes in templates.
+     * In particular, this struct tests for the interface of an eigen
+     * model which can optionally store its transition function as a
+     * single (S*A)xS Eigen sparse matrix, where the row for each
+     * state-action pair (s,a) is at index s * A + a.
+     *
+     * Since the stacked matrix is optional, algorithms must check at
+     * runtime whether it is actually available via
+     * isStackedTransitionsEnabled().
+     *
+     * The interface must be implemented and be public in the parameter
+     * class. The interface is the following:
+     *
+     * - const T & getStackedTransitionFunction() const : Returns the stacked transition matrix, where T is some Eigen sparse matrix type.
+     * - bool isStackedTransitionsEnabled() const : Returns whether the stacked matrix is available.
+     *
+     * In addition the MDP needs to respect the interface for the Eigen MDP model.
+     *
+     * \sa MDP::is_model_eigen
+     *
+     * is_model_stacked<M>::value will be equal to true is M implements the interface,
+     * and false otherwise.
+     *
+     * @tparam M The class to test for the interface.
+     */
+    template <typename M>
+    struct is_model_stacked {
+        private:
+            template <typename Z> static auto stackedRetType(Z* z) ->
+                                                remove_cv_ref_t<decltype(z->getStackedTransitionFunction())>;
+
+            template <typename Z> static auto stackedRetType(...) -> int;
+
+            using F = decltype(stackedRetType<const M>(0));
+
+            template <typename Z> static constexpr auto test(int) -> decltype(
+
+                    static_cast<const F & (Z::*)() const>   (&Z::getStackedTransitionFunction),
+                    static_cast<bool (Z::*)() const>        (&Z::isStackedTransitionsEnabled),
+
+                    bool()
+            ) { return true; }
+
+            template <typename> static constexpr auto test(...) -> bool
+            { return false; }
+
+        public:
+            enum {
+                value = is_model_eigen_v<M> && test<M>(0) &&
+                        std::is_base_of_v<Eigen::SparseMatrixBase<F>, F>
+            };
+    };
+    template <typename M>
+    inline constexpr bool is_model_stacked_v = is_model_stacked<M>::value;
+
     /**
      * @brief This struct represents the required interface for an experience recorder.
      *
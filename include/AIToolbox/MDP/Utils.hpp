@@ -2,6 +2,8 @@
 #define AI_TOOLBOX_MDP_UTILS_HEADER_FILE
 
 #include <stddef.h>
+#include <utility>
+
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/TypeTraits.hpp>
 
@@ -94,7 +96,13 @@ namespace AIToolbox::MDP {
     /**
      * @brief This function computes the Model's QFunction from the values of a ValueFunction.
      *
-     * Note that this function is more efficient with eigen models.
+     * Note that this function is more efficient with eigen models, and
+     * even more so with models that have a stacked transition matrix
+     * enabled.
+     *
+     * Models that store their transitions in a precision lower than
+     * double are supported; the products are still accumulated in
+     * double.
      *
      * @param model The MDP that needs to be solved.
      * @param v The values of the ValueFunction for the future of the QFunction.
@@ -106,9 +114,18 @@ namespace AIToolbox::MDP {
     QFunction computeQFunction(const M & model, const Values & v, QFunction ir) {
         const auto A = model.getA();
 
+        if constexpr(is_model_stacked_v<M>) {
+            // Since the QFunction is row-major, its storage is already
+            // ordered as the rows of the stacked matrix, so we can do the
+            // whole backup with a single product.
+            if ( model.isStackedTransitionsEnabled() ) {
+                Eigen::Map<Vector>(ir.data(), ir.size()).noalias() += model.getStackedTransitionFunction().template cast<double>() * v;
+                return ir;
+            }
+        }
         if constexpr(is_model_eigen_v<M>) {
             for ( size_t a = 0; a < A; ++a )
-                ir.col(a).noalias() += model.getTransitionFunction(a) * v;
+                ir.col(a).noalias() += model.getTransitionFunction(a).template cast<double>() * v;
         } else {
             const auto S = model.getS();
             for ( size_t s = 0; s < S; ++s )
@@ -118,6 +135,64 @@ namespace AIToolbox::MDP {
         }
         return ir;
     }
+
+    /**
+     * @brief This function computes the discounted backup of a single state-action pair.
+     *
+     * This is the value ir(s,a) + discount * sum_s' T(s,a,s') v(s'). It
+     * only reads a single row of the transition function, so it is useful
+     * for algorithms that update few pairs at a time, like in-place
+     * (Gauss-Seidel) sweeps.
+     *
+     * @param model The MDP that needs to be solved.
+     * @param ir The immediate rewards of the model, as created by computeImmediateRewards()
+     * @param v The values of the ValueFunction for the future of the pair.
+     * @param s The state of the pair.
+     * @param a The action of the pair.
+     *
+     * @return The backed up value of the pair.
+     */
+    template <typename M, typename IR, std::enable_if_t<is_model_v<M>, int> = 0>
+    double computeQValue(const M & model, const IR & ir, const Values & v, const size_t s, const size_t a) {
+        double retval;
+        if constexpr(is_model_eigen_v<M>) {
+            retval = model.getTransitionFunction(a).row(s).template cast<double>().dot(v);
+        } else {
+            const auto S = model.getS();
+            retval = 0.0;
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                retval += model.getTransitionProbability(s, a, s1) * v[s1];
+        }
+        return ir.coeff(s, a) + model.getDiscount() * retval;
+    }
+
+    /**
+     * @brief This function computes the best discounted backup for a single state.
+     *
+     * Ties are broken in favour of the lowest action.
+     *
+     * @param model The MDP that needs to be solved.
+     * @param ir The immediate rewards of the model, as created by computeImmediateRewards()
+     * @param v The values of the ValueFunction for the future of the state.
+     * @param s The state to backup.
+     *
+     * @return A pair containing the best action and its value.
+     */
+    template <typename M, typename IR, std::enable_if_t<is_model_v<M>, int> = 0>
+    std::pair<size_t, double> bellmanBackup(const M & model, const IR & ir, const Values & v, const size_t s) {
+        const auto A = model.getA();
+
+        size_t bestAction = 0;
+        double bestValue = computeQValue(model, ir, v, s, 0);
+        for ( size_t a = 1; a < A; ++a ) {
+            const double value = computeQValue(model, ir, v, s, a);
+            if ( value > bestValue ) {
+                bestAction = a;
+                bestValue = value;
+            }
+        }
+        return {bestAction, bestValue};
+    }
 }
 
 #endif
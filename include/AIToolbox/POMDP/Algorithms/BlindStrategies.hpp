@@ -141,7 +141,7 @@ namespace AIToolbox::POMDP {
             while ( timestep < horizon_ && ( !useTolerance || variation > tolerance_ ) ) {
                 ++timestep;
                 if constexpr(is_model_eigen_v<M>) {
-                    newAlpha = ir.row(a) + (m.getDiscount() * m.getTransitionFunction(a) * oldAlpha).transpose();
+                    newAlpha = ir.row(a) + (m.getDiscount() * m.getTransitionFunction(a).template cast<double>() * oldAlpha).transpose();
                 } else {
                     newAlpha = ir.row(a);
                     for (size_t s = 0; s < m.getS(); ++s) {
@@ -3,11 +3,10 @@
 
 #include <algorithm>
 
-#include <boost/heap/fibonacci_heap.hpp>
-
 #include <AIToolbox/Impl/Logging.hpp>
 
 #include <AIToolbox/Utils/Polytope.hpp>
+#include <AIToolbox/Utils/IndexedHeap.hpp>
 
 #include <AIToolbox/POMDP/Types.hpp>
 #include <AIToolbox/POMDP/TypeTraits.hpp>
@@ -137,15 +136,9 @@ namespace AIToolbox::POMDP {
         private:
             using IntermediatePOMDP = Model<MDP::Model>;
 
-            // Queue sorted by gap.         belief,    gap,   prob,    lb,    ub,    depth,       path
+            // Queue elements, sorted by gap.  belief,    gap,   prob,    lb,    ub,    depth,       path
             using QueueElement = std::tuple<Belief, double, double, double, double, unsigned, std::vector<Belief>>;
 
-            struct QueueElementLess {
-                bool operator() (const QueueElement& arg1, const QueueElement& arg2) const;
-            };
-
-            using QueueType = boost::heap::fibonacci_heap<QueueElement, boost::heap::compare<QueueElementLess>>;
-
             /**
              * @brief This function collects beliefs in order to reduce the gap.
              *
@@ -465,7 +458,13 @@ namespace AIToolbox::POMDP {
         size_t overwriteCounter = 0;
         visitedBeliefs.reserve(maxVisitedBeliefs);
 
-        QueueType queue;
+        // The heap is keyed on the position of each element in the
+        // elements vector. Slots of popped elements are recycled, so that
+        // both the vector and the heap keys stay bounded by the maximum
+        // size of the queue.
+        std::vector<QueueElement> queueElements;
+        std::vector<size_t> freeIds;
+        IndexedHeap<> queue;
         unsigned newBeliefs = 0;
 
         // From the original code, a limitation on how many new beliefs we find.
@@ -478,14 +477,18 @@ namespace AIToolbox::POMDP {
             const auto rend   = std::end  (lbVList);
             findBestAtPoint(initialBelief, rbegin, rend, &currentLowerBound, unwrap);
             const double currentUpperBound = std::get<0>(LPInterpolation(initialBelief, ubQ, ubV));
-            queue.emplace(QueueElement(initialBelief, 0.0, 1.0, currentLowerBound, currentUpperBound, 1, {}));
+            queueElements.emplace_back(initialBelief, 0.0, 1.0, currentLowerBound, currentUpperBound, 1, std::vector<Belief>{});
+            queue.push(0, 0.0);
         }
 
         while (!queue.empty() && newBeliefs < maxNewBeliefs) {
-            const auto [belief, gap, beliefProbability, currentLowerBound, currentUpperBound, depth, path] = queue.top();
-            (void)gap; // ignore gap variable
+            const auto id = queue.top().key;
             queue.pop();
 
+            const auto [belief, gap, beliefProbability, currentLowerBound, currentUpperBound, depth, path] = std::move(queueElements[id]);
+            (void)gap; // ignore gap variable
+            freeIds.push_back(id);
+
             // We add the new belief in the history, to avoid adding to the
             // queue the same belief multiple times. We also limit the size of
             // the history to avoid the check taking too much time, we tend to
@@ -611,10 +614,10 @@ namespace AIToolbox::POMDP {
                     const auto nextBeliefOverallProbability = nextBeliefProbability * beliefProbability * pomdp.getDiscount();
                     const auto nextBeliefGap = nextBeliefOverallProbability * (ubValue - lbValue);
 
-                    const auto qcheck = [&nextBelief](const QueueElement & qe){ return checkEqualProbability(nextBelief, std::get<0>(qe)); };
+                    const auto qcheck = [&nextBelief, &queueElements](const auto & e){ return checkEqualProbability(nextBelief, std::get<0>(queueElements[e.key])); };
                     const auto it = std::find_if(std::begin(queue), std::end(queue), qcheck);
                     if (it == std::end(queue)) {
-                        queue.emplace(
+                        QueueElement qe(
                                 std::move(nextBelief),
                                 nextBeliefGap,
                                 nextBeliefOverallProbability,
@@ -623,12 +626,23 @@ namespace AIToolbox::POMDP {
                                 depth+1,
                                 newPath
                         );
+                        size_t qid;
+                        if (freeIds.empty()) {
+                            qid = queueElements.size();
+                            queueElements.emplace_back(std::move(qe));
+                        } else {
+                            qid = freeIds.back();
+                            freeIds.pop_back();
+                            queueElements[qid] = std::move(qe);
+                        }
+                        queue.push(qid, nextBeliefGap);
                     } else {
-                        auto handle = QueueType::s_handle_from_iterator(it);
-                        std::get<1>(*handle) += nextBeliefGap;
-                        std::get<2>(*handle) += nextBeliefOverallProbability;
-                        std::get<5>(*handle) = std::min(std::get<5>(*handle), depth+1);
-                        queue.increase(handle);
+                        const auto qid = it->key;
+                        auto & qe = queueElements[qid];
+                        std::get<1>(qe) += nextBeliefGap;
+                        std::get<2>(qe) += nextBeliefOverallProbability;
+                        std::get<5>(qe) = std::min(std::get<5>(qe), depth+1);
+                        queue.increase(qid, std::get<1>(qe));
                     }
                 }
             }
@@ -1,11 +1,15 @@
 #ifndef AI_TOOLBOX_POMDP_POMCP_HEADER_FILE
 #define AI_TOOLBOX_POMDP_POMCP_HEADER_FILE
 
-#include <unordered_map>
+#include <functional>
+#include <limits>
 
 #include <AIToolbox/Impl/Logging.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/SearchStatistics.hpp>
+#include <AIToolbox/Utils/SearchTree.hpp>
+#include <AIToolbox/MDP/Policies/PolicyInterface.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 #include <AIToolbox/POMDP/TypeTraits.hpp>
 
@@ -39,12 +43,24 @@ namespace AIToolbox::POMDP {
      * is used to approximate the values for all nodes visited in this
      * rollout inside the tree, before leaving it.
      *
+     * Since rollouts only deal with states, the random rollout policy can
+     * be replaced by any MDP policy (for example one computed with QMDP),
+     * and rollouts can be truncated after a fixed number of steps, using
+     * a leaf evaluator to estimate the value of the rest of the episode
+     * (for example from the QFunction of QMDP or FastInformedBound). See
+     * setRolloutPolicy(), setRolloutDepth() and setLeafEvaluator().
+     *
      * Since POMCP expands a tree, it can reuse work it has done if
      * multiple action requests are done in order. To do so, it simply asks
      * for the action that has been performed and its respective obtained
      * observation. Then it simply makes that root branch the new root, and
      * starts again.
      *
+     * The tree is stored in a SearchTree, which keeps all nodes in a
+     * single arena. Pruning the tree when reusing it is O(1), and the
+     * memory of the discarded branches, particle beliefs included, is
+     * recycled by the following searches rather than freed.
+     *
      * In order to avoid performing belief updates between each
      * action/observation pair, which can be expensive, POMCP uses particle
      * beliefs. These approximate the beliefs at every step, and are used
@@ -64,23 +80,13 @@ namespace AIToolbox::POMDP {
         public:
             using SampleBelief = std::vector<size_t>;
 
-            struct BeliefNode;
-            using BeliefNodes = std::unordered_map<size_t, BeliefNode>;
+            // Nodes are keyed by observation, and store their particle belief.
+            using Graph = SearchTree<SampleBelief>;
+            using Index = typename Graph::Index;
+            using ActionNode = typename Graph::Edge;
 
-            struct ActionNode {
-                BeliefNodes children;
-                double V = 0.0;
-                unsigned N = 0;
-            };
-            using ActionNodes = std::vector<ActionNode>;
-
-            struct BeliefNode {
-                BeliefNode() : N(0) {}
-                BeliefNode(size_t s) : belief(1, s), N(0) {}
-                ActionNodes children;
-                SampleBelief belief;
-                unsigned N;
-            };
+            // Estimates the value of a state, for truncated rollouts.
+            using LeafEvaluator = std::function<double(size_t)>;
 
             /**
              * @brief Basic constructor.
@@ -131,6 +137,44 @@ namespace AIToolbox::POMDP {
              */
             size_t sampleAction(size_t a, size_t o, unsigned horizon);
 
+            /**
+             * @brief This function resets the internal graph and samples for the provided belief until a deadline.
+             *
+             * This function works as sampleAction(const Belief &,
+             * unsigned), but rather than running a fixed number of
+             * iterations it keeps running simulations until the deadline
+             * expires. At least one simulation is always run; each
+             * simulation is completed before the deadline is checked
+             * again, so the function may return after the deadline by up
+             * to the duration of a single simulation.
+             *
+             * @param b The initial belief for the environment.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(const Belief& b, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
+            /**
+             * @brief This function uses the internal graph to plan until a deadline.
+             *
+             * This function works as sampleAction(size_t, size_t,
+             * unsigned), but it simulates until the deadline as
+             * sampleAction(const Belief &, unsigned,
+             * SearchClock::time_point, SearchStatistics *).
+             *
+             * @param a The action taken in the last timestep.
+             * @param o The observation received in the last timestep.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(size_t a, size_t o, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
             /**
              * @brief This function sets the new size for initial beliefs created from sampleAction().
              *
@@ -162,6 +206,53 @@ namespace AIToolbox::POMDP {
              */
             void setExploration(double exp);
 
+            /**
+             * @brief This function sets the policy used to pick actions during rollouts.
+             *
+             * By default rollouts pick actions uniformly at random. The
+             * policy is not copied, and must outlive its use in this
+             * class; nullptr restores random rollouts.
+             *
+             * @param p The new rollout policy, or nullptr.
+             */
+            void setRolloutPolicy(const MDP::PolicyInterface * p);
+
+            /**
+             * @brief This function sets the function used to estimate the value of truncated rollouts.
+             *
+             * When a rollout is truncated before the horizon (see
+             * setRolloutDepth()), the evaluator is called on the last
+             * state reached, and its discounted result is added to the
+             * return of the rollout. An empty function stops the
+             * estimation, so that truncated rollouts only return the
+             * rewards collected.
+             *
+             * @param f The new leaf evaluator.
+             */
+            void setLeafEvaluator(LeafEvaluator f);
+
+            /**
+             * @brief This function sets the leaf evaluator to the greedy value of a QFunction.
+             *
+             * The value of each state is the maximum of its row of the
+             * QFunction, as computed for example by QMDP or
+             * FastInformedBound. The values are copied.
+             *
+             * @param q The QFunction to use, of size S x A.
+             */
+            void setLeafEvaluator(const MDP::QFunction & q);
+
+            /**
+             * @brief This function sets the maximum number of steps of each rollout.
+             *
+             * Rollouts never go past the horizon, so by default they are
+             * not truncated. With a depth of zero, new leaves are only
+             * valued by the leaf evaluator.
+             *
+             * @param depth The new maximum rollout depth.
+             */
+            void setRolloutDepth(unsigned depth);
+
             /**
              * @brief This function returns the POMDP generative model being used.
              *
@@ -172,9 +263,13 @@ namespace AIToolbox::POMDP {
             /**
              * @brief This function returns a reference to the internal graph structure holding the results of rollouts.
              *
+             * The root of the graph is the belief of the last search; its
+             * children are keyed by observation, and the data of each
+             * node is its particle belief.
+             *
              * @return The internal graph.
              */
-            const BeliefNode& getGraph() const;
+            const Graph& getGraph() const;
 
             /**
              * @brief This function returns the initial particle size for converted Beliefs.
@@ -197,14 +292,38 @@ namespace AIToolbox::POMDP {
              */
             double getExploration() const;
 
+            /**
+             * @brief This function returns the policy used to pick actions during rollouts.
+             *
+             * @return The rollout policy, or nullptr for random rollouts.
+             */
+            const MDP::PolicyInterface * getRolloutPolicy() const;
+
+            /**
+             * @brief This function returns the function used to estimate the value of truncated rollouts.
+             *
+             * @return The leaf evaluator.
+             */
+            const LeafEvaluator & getLeafEvaluator() const;
+
+            /**
+             * @brief This function returns the maximum number of steps of each rollout.
+             *
+             * @return The maximum rollout depth.
+             */
+            unsigned getRolloutDepth() const;
+
         private:
             const M& model_;
             size_t S, A, beliefSize_;
-            unsigned iterations_, maxDepth_;
+            unsigned iterations_, maxDepth_, reachedDepth_;
             double exploration_;
 
-            SampleBelief sampleBelief_;
-            BeliefNode graph_;
+            const MDP::PolicyInterface * rolloutPolicy_;
+            LeafEvaluator leafEvaluator_;
+            unsigned rolloutDepth_;
+
+            Graph graph_;
 
             mutable RandomEngine rand_;
 
@@ -212,16 +331,29 @@ namespace AIToolbox::POMDP {
              * @brief This function starts the simulation process.
              *
              * This function simply calls simulate() for the number of
-             * times specified by POMCP's parameters. While doing so it
-             * builds a tree of explored outcomes, from which POMCP will
-             * then extract the best expected action for the current
-             * belief.
+             * times specified by POMCP's parameters, or until the input
+             * deadline. While doing so it builds a tree of explored
+             * outcomes, from which POMCP will then extract the best
+             * expected action for the current belief.
              *
              * @param horizon The horizon for which to plan.
+             * @param deadline If not null, the time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
              *
              * @return The best action to take given the final built tree.
              */
-            size_t runSimulation(unsigned horizon);
+            size_t runSimulation(unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats);
+
+            /**
+             * @brief This function makes the input branch the root of the graph.
+             *
+             * If the branch does not exist, or its particle belief is
+             * empty, the graph is reset to a uniform belief instead.
+             *
+             * @param a The action taken in the last timestep.
+             * @param o The observation received in the last timestep.
+             */
+            void rerootGraph(size_t a, size_t o);
 
             /**
              * @brief This function recursively simulates the model while building the tree.
@@ -239,13 +371,13 @@ namespace AIToolbox::POMDP {
              * update particle beliefs within the tree and the value
              * estimations for those beliefs.
              *
-             * @param b The tree node to simulate from.
+             * @param b The index of the tree node to simulate from.
              * @param s The state from which we are simulating, possibly a particle of a previous particle belief.
              * @param horizon The depth within the tree already reached.
              *
              * @return The discounted reward obtained from the simulation performed from here to the end.
              */
-            double simulate(BeliefNode & b, size_t s, unsigned horizon);
+            double simulate(Index b, size_t s, unsigned horizon);
 
             /**
              * @brief This function implements the rollout policy for POMCP.
@@ -266,6 +398,10 @@ namespace AIToolbox::POMDP {
              * again, while at the same time still getting an estimate for
              * the rest of the simulation.
              *
+             * Rollouts follow the rollout policy if one is set, and
+             * otherwise pick actions at random. If they are truncated
+             * before the horizon, the leaf evaluator estimates the rest.
+             *
              * @param s The state from which to start the rollout.
              * @param horizon The horizon already reached while simulating inside the tree.
              *
@@ -306,109 +442,130 @@ namespace AIToolbox::POMDP {
             /**
              * @brief This function samples a given belief in order to produce a particle approximation of it.
              *
-             * @param b The belief to be approximated.
+             * The particles are written into an existing particle belief,
+             * so that its memory can be reused.
              *
-             * @return A particle belief approximating the input belief.
+             * @param b The belief to be approximated.
+             * @param belief The particle belief to fill, which is cleared first.
              */
-            SampleBelief makeSampledBelief(const Belief & b);
+            void makeSampledBelief(const Belief & b, SampleBelief & belief);
     };
 
     template <typename M>
     POMCP<M>::POMCP(const M& m, const size_t beliefSize, const unsigned iter, const double exp) :
             model_(m), S(model_.getS()), A(model_.getA()), beliefSize_(beliefSize),
-            iterations_(iter), exploration_(exp), graph_(), rand_(Impl::Seeder::getSeed()) {}
+            iterations_(iter), exploration_(exp), rolloutPolicy_(nullptr),
+            rolloutDepth_(std::numeric_limits<unsigned>::max()), graph_(A), rand_(Impl::Seeder::getSeed()) {}
 
     template <typename M>
     size_t POMCP<M>::sampleAction(const Belief& b, const unsigned horizon) {
-        // Reset graph
-        graph_ = BeliefNode(A);
-        graph_.children.resize(A);
-        graph_.belief = makeSampledBelief(b);
+        graph_.reset();
+        makeSampledBelief(b, graph_.getNode(graph_.getRoot()).data);
 
-        return runSimulation(horizon);
+        return runSimulation(horizon, nullptr, nullptr);
+    }
+
+    template <typename M>
+    size_t POMCP<M>::sampleAction(const Belief& b, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        graph_.reset();
+        makeSampledBelief(b, graph_.getNode(graph_.getRoot()).data);
+
+        return runSimulation(horizon, &deadline, stats);
     }
 
     template <typename M>
     size_t POMCP<M>::sampleAction(const size_t a, const size_t o, const unsigned horizon) {
-        const auto & obs = graph_.children[a].children;
+        rerootGraph(a, o);
 
-        auto it = obs.find(o);
-        if ( it == obs.end() ) {
-            AI_LOGGER(AI_SEVERITY_WARNING, "Observation " << o << " never experienced in simulation, restarting with uniform belief..");
-            auto b = Belief(S); b.fill(1.0/S);
-            return sampleAction(b, horizon);
-        }
+        return runSimulation(horizon, nullptr, nullptr);
+    }
 
-        // Here we need an additional step, because *it is contained by graph_.
-        // If we just move assign, graph_ is first going to delete everything it
-        // contains (included *it), and then we are going to move unallocated memory
-        // into graph_! So we move *it outside of the graph_ hierarchy, so that
-        // we can then assign safely.
-        { auto tmp = std::move(it->second); graph_ = std::move(tmp); }
+    template <typename M>
+    size_t POMCP<M>::sampleAction(const size_t a, const size_t o, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        rerootGraph(a, o);
 
-        if ( ! graph_.belief.size() ) {
+        return runSimulation(horizon, &deadline, stats);
+    }
+
+    template <typename M>
+    void POMCP<M>::rerootGraph(const size_t a, const size_t o) {
+        if ( !graph_.reroot(a, o) ) {
+            AI_LOGGER(AI_SEVERITY_WARNING, "Observation " << o << " never experienced in simulation, restarting with uniform belief..");
+        } else if ( ! graph_.getNode(graph_.getRoot()).data.size() ) {
             AI_LOGGER(AI_SEVERITY_WARNING, "POMCP lost track of the belief, restarting with uniform..");
-            auto b = Belief(S); b.fill(1.0/S);
-            return sampleAction(b, horizon);
+        } else {
+            return;
         }
 
-        // We resize here in case we didn't have time to sample the new
-        // head node. In this case, the new head may not have children.
-        // This would break the UCT call.
-        graph_.children.resize(A);
-
-        return runSimulation(horizon);
+        auto b = Belief(S); b.fill(1.0/S);
+        graph_.reset();
+        makeSampledBelief(b, graph_.getNode(graph_.getRoot()).data);
     }
 
     template <typename M>
-    size_t POMCP<M>::runSimulation(const unsigned horizon) {
+    size_t POMCP<M>::runSimulation(const unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats) {
+        if ( stats ) *stats = SearchStatistics();
         if ( !horizon ) return 0;
 
         maxDepth_ = horizon;
-        std::uniform_int_distribution<size_t> generator(0, graph_.belief.size()-1);
+        reachedDepth_ = 0;
+
+        // The new head may have never been expanded, and we need its
+        // actions even if we do not simulate at all.
+        const auto root = graph_.getRoot();
+        graph_.expand(root);
+
+        const auto & belief = graph_.getNode(root).data;
+        std::uniform_int_distribution<size_t> generator(0, belief.size()-1);
 
-        for (unsigned i = 0; i < iterations_; ++i )
-            simulate(graph_, graph_.belief.at(generator(rand_)), 0);
+        const auto simulations = runSimulations(iterations_, deadline, [&]{ simulate(root, belief.at(generator(rand_)), 0); });
 
-        auto begin = std::begin(graph_.children);
-        return std::distance(begin, findBestA(begin, std::end(graph_.children)));
+        const auto edges = graph_.getEdges(root);
+        if ( stats ) {
+            stats->simulations = simulations;
+            stats->maxDepth = reachedDepth_;
+            stats->rootVisits.resize(A);
+            for ( size_t a = 0; a < A; ++a )
+                stats->rootVisits[a] = edges[a].N;
+        }
+        return std::distance(edges, findBestA(edges, edges + A));
     }
 
     template <typename M>
-    double POMCP<M>::simulate(BeliefNode & b, const size_t s, const unsigned depth) {
-        b.N++;
+    double POMCP<M>::simulate(const Index b, const size_t s, const unsigned depth) {
+        reachedDepth_ = std::max(reachedDepth_, depth);
+
+        // Since most memory is allocated on the leaves, we do not allocate
+        // on node creation but only when we are actually descending into
+        // a node. If the node already has memory this does not do
+        // anything.
+        graph_.expand(b);
 
-        auto begin = std::begin(b.children);
-        const size_t a = std::distance(begin, findBestBonusA(begin, std::end(b.children), b.N));
+        auto & bNode = graph_.getNode(b);
+        bNode.N++;
+
+        const auto edges = graph_.getEdges(b);
+        const size_t a = std::distance(edges, findBestBonusA(edges, edges + A, bNode.N));
 
         auto [s1, o, rew] = model_.sampleSOR(s, a);
 
-        auto & aNode = b.children[a];
+        auto & aNode = edges[a];
 
         {
             double futureRew = 0.0;
             // We need to append the node anyway to perform the belief
             // update for the next timestep.
-            auto ot = aNode.children.find(o);
-            if ( ot == std::end(aNode.children) ) {
-                aNode.children.emplace(std::piecewise_construct,
-                                       std::forward_as_tuple(o),
-                                       std::forward_as_tuple(s1));
+            const auto child = graph_.findChild(b, a, o);
+            if ( child == Graph::None ) {
+                graph_.getNode(graph_.addChild(b, a, o)).data.push_back(s1);
                 // This stops automatically if we go out of depth
                 futureRew = rollout(s1, depth + 1);
             }
             else {
-                ot->second.belief.push_back(s1);
+                graph_.getNode(child).data.push_back(s1);
                 // We only go deeper if needed (maxDepth_ is always at least 1).
-                if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) ) {
-                    // Since most memory is allocated on the leaves,
-                    // we do not allocate on node creation but only when
-                    // we are actually descending into a node. If the node
-                    // already has memory this should not do anything in
-                    // any case.
-                    ot->second.children.resize(A);
-                    futureRew = simulate( ot->second, s1, depth + 1 );
-                }
+                if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) )
+                    futureRew = simulate( child, s1, depth + 1 );
             }
 
             rew += model_.getDiscount() * futureRew;
@@ -426,8 +583,10 @@ namespace AIToolbox::POMDP {
         double rew = 0.0, totalRew = 0.0, gamma = 1.0;
 
         std::uniform_int_distribution<size_t> generator(0, A-1);
-        for ( ; depth < maxDepth_; ++depth ) {
-            std::tie( s, rew ) = model_.sampleSR( s, generator(rand_) );
+        const unsigned end = depth + std::min(rolloutDepth_, maxDepth_ - depth);
+        for ( ; depth < end; ++depth ) {
+            const size_t a = rolloutPolicy_ ? rolloutPolicy_->sampleAction(s) : generator(rand_);
+            std::tie( s, rew ) = model_.sampleSR( s, a );
             totalRew += gamma * rew;
 
             if (model_.isTerminal(s))
@@ -435,6 +594,10 @@ namespace AIToolbox::POMDP {
 
             gamma *= model_.getDiscount();
         }
+        // If we stopped before the horizon, we estimate the rest.
+        if ( depth < maxDepth_ && leafEvaluator_ )
+            totalRew += gamma * leafEvaluator_(s);
+
         return totalRew;
     }
 
@@ -471,14 +634,12 @@ namespace AIToolbox::POMDP {
     }
 
     template <typename M>
-    typename POMCP<M>::SampleBelief POMCP<M>::makeSampledBelief(const Belief & b) {
-        SampleBelief belief;
+    void POMCP<M>::makeSampledBelief(const Belief & b, SampleBelief & belief) {
+        belief.clear();
         belief.reserve(beliefSize_);
 
         for ( size_t i = 0; i < beliefSize_; ++i )
             belief.push_back(sampleProbability(S, b, rand_));
-
-        return belief;
     }
 
     template <typename M>
@@ -496,13 +657,38 @@ namespace AIToolbox::POMDP {
         exploration_ = exp;
     }
 
+    template <typename M>
+    void POMCP<M>::setRolloutPolicy(const MDP::PolicyInterface * p) {
+        if ( p && (p->getS() != S || p->getA() != A) )
+            throw std::invalid_argument("The rollout policy has a different state or action space than the model");
+        rolloutPolicy_ = p;
+    }
+
+    template <typename M>
+    void POMCP<M>::setLeafEvaluator(LeafEvaluator f) {
+        leafEvaluator_ = std::move(f);
+    }
+
+    template <typename M>
+    void POMCP<M>::setLeafEvaluator(const MDP::QFunction & q) {
+        if ( static_cast<size_t>(q.rows()) != S || static_cast<size_t>(q.cols()) != A )
+            throw std::invalid_argument("The QFunction has a different size than the model");
+
+        leafEvaluator_ = [v = Vector(q.rowwise().maxCoeff())](const size_t s) { return v[s]; };
+    }
+
+    template <typename M>
+    void POMCP<M>::setRolloutDepth(const unsigned depth) {
+        rolloutDepth_ = depth;
+    }
+
     template <typename M>
     const M& POMCP<M>::getModel() const {
         return model_;
     }
 
     template <typename M>
-    const typename POMCP<M>::BeliefNode& POMCP<M>::getGraph() const {
+    const typename POMCP<M>::Graph& POMCP<M>::getGraph() const {
         return graph_;
     }
 
@@ -520,6 +706,21 @@ namespace AIToolbox::POMDP {
     double POMCP<M>::getExploration() const {
         return exploration_;
     }
+
+    template <typename M>
+    const MDP::PolicyInterface * POMCP<M>::getRolloutPolicy() const {
+        return rolloutPolicy_;
+    }
+
+    template <typename M>
+    const typename POMCP<M>::LeafEvaluator & POMCP<M>::getLeafEvaluator() const {
+        return leafEvaluator_;
+    }
+
+    template <typename M>
+    unsigned POMCP<M>::getRolloutDepth() const {
+        return rolloutDepth_;
+    }
 }
 
 #endif
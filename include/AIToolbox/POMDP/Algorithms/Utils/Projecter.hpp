@@ -112,7 +112,7 @@ namespace AIToolbox::POMDP {
                 // if we performed action a and obtained observation o.
                 // vproj_{a,o}[s] = R(s,a) / |O| + discount * sum_{s'} ( T(s,a,s') * O(s',a,o) * v_{t-1}(s') )
                 if constexpr(is_model_eigen_v<M>) {
-                    vproj = model_.getTransitionFunction(a) * (v.cwiseProduct(model_.getObservationFunction(a).col(o)));
+                    vproj = model_.getTransitionFunction(a).template cast<double>() * (v.cwiseProduct(model_.getObservationFunction(a).col(o)));
                 } else {
                     vproj.setZero();
                     for ( size_t s = 0; s < S; ++s )
@@ -6,6 +6,7 @@
 #include <AIToolbox/Impl/Logging.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 #include <AIToolbox/Utils/Probability.hpp>
+#include <AIToolbox/Utils/SearchStatistics.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 #include <AIToolbox/POMDP/TypeTraits.hpp>
 
@@ -111,6 +112,44 @@ namespace AIToolbox::POMDP {
              */
             size_t sampleAction(size_t a, size_t o, unsigned horizon);
 
+            /**
+             * @brief This function resets the internal graph and samples for the provided belief until a deadline.
+             *
+             * This function works as sampleAction(const Belief &,
+             * unsigned), but rather than running a fixed number of
+             * iterations it keeps running simulations until the deadline
+             * expires. At least one simulation is always run; each
+             * simulation is completed before the deadline is checked
+             * again, so the function may return after the deadline by up
+             * to the duration of a single simulation.
+             *
+             * @param b The initial belief for the environment.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(const Belief& b, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
+            /**
+             * @brief This function uses the internal graph to plan until a deadline.
+             *
+             * This function works as sampleAction(size_t, size_t,
+             * unsigned), but it simulates until the deadline as
+             * sampleAction(const Belief &, unsigned,
+             * SearchClock::time_point, SearchStatistics *).
+             *
+             * @param a The action taken in the last timestep.
+             * @param o The observation received in the last timestep.
+             * @param horizon The horizon to plan for.
+             * @param deadline The time at which to stop simulating.
+             * @param stats If not null, where to store the statistics of the search.
+             *
+             * @return The best action.
+             */
+            size_t sampleAction(size_t a, size_t o, unsigned horizon, SearchClock::time_point deadline, SearchStatistics * stats = nullptr);
+
             /**
              * @brief This function sets the new size for initial beliefs created from sampleAction().
              *
@@ -180,7 +219,7 @@ namespace AIToolbox::POMDP {
         private:
             const M& model_;
             size_t S, A, beliefSize_;
-            unsigned iterations_, maxDepth_;
+            unsigned iterations_, maxDepth_, reachedDepth_;
             double exploration_;
             unsigned k_;
 
@@ -189,7 +228,8 @@ namespace AIToolbox::POMDP {
             HNode graph_;
 
             // Private Methods
-            size_t runSimulation(unsigned horizon);
+            size_t runSimulation(unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats);
+            void rerootGraph(size_t a, size_t o);
             double simulate(BNode & b, size_t s, unsigned horizon);
 
             void maxBeliefNodeUpdate(BNode * bn, const ANode & aNode, size_t a);
@@ -212,17 +252,40 @@ namespace AIToolbox::POMDP {
         // Reset graph
         graph_ = HNode(A, beliefSize_, b, rand_);
 
-        return runSimulation(horizon);
+        return runSimulation(horizon, nullptr, nullptr);
     }
 
     template <typename M, bool UseEntropy>
     size_t rPOMCP<M, UseEntropy>::sampleAction(const size_t a, const size_t o, const unsigned horizon) {
+        rerootGraph(a, o);
+
+        return runSimulation(horizon, nullptr, nullptr);
+    }
+
+    template <typename M, bool UseEntropy>
+    size_t rPOMCP<M, UseEntropy>::sampleAction(const Belief& b, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        // Reset graph
+        graph_ = HNode(A, beliefSize_, b, rand_);
+
+        return runSimulation(horizon, &deadline, stats);
+    }
+
+    template <typename M, bool UseEntropy>
+    size_t rPOMCP<M, UseEntropy>::sampleAction(const size_t a, const size_t o, const unsigned horizon, const SearchClock::time_point deadline, SearchStatistics * stats) {
+        rerootGraph(a, o);
+
+        return runSimulation(horizon, &deadline, stats);
+    }
+
+    template <typename M, bool UseEntropy>
+    void rPOMCP<M, UseEntropy>::rerootGraph(const size_t a, const size_t o) {
         auto & obs = graph_.children[a].children;
 
         auto it = obs.find(o);
         if ( it == obs.end() ) {
             AI_LOGGER(AI_SEVERITY_WARNING, "Observation " << o << " never experienced in simulation, restarting with uniform belief..");
-            return sampleAction(Belief(S, 1.0 / S), horizon);
+            graph_ = HNode(A, beliefSize_, Belief(S, 1.0 / S), rand_);
+            return;
         }
 
         // Here we need an additional step, because *it is contained by graph_.
@@ -234,20 +297,19 @@ namespace AIToolbox::POMDP {
 
         if ( graph_.isSampleBeliefEmpty() ) {
             AI_LOGGER(AI_SEVERITY_WARNING, "rPOMCP lost track of the belief, restarting with uniform..");
-            return sampleAction(Belief(S, 1.0 / S), horizon);
+            graph_ = HNode(A, beliefSize_, Belief(S, 1.0 / S), rand_);
         }
-
-        return runSimulation(horizon);
     }
 
     template <typename M, bool UseEntropy>
-    size_t rPOMCP<M, UseEntropy>::runSimulation(const unsigned horizon) {
+    size_t rPOMCP<M, UseEntropy>::runSimulation(const unsigned horizon, const SearchClock::time_point * deadline, SearchStatistics * stats) {
+        if ( stats ) *stats = SearchStatistics();
         if ( !horizon ) return 0;
 
         maxDepth_ = horizon;
+        reachedDepth_ = 0;
 
-        for (unsigned i = 0; i < iterations_; ++i )
-            simulate(graph_, graph_.sampleBelief(), 0);
+        const auto simulations = runSimulations(iterations_, deadline, [&]{ simulate(graph_, graph_.sampleBelief(), 0); });
 
         auto begin = std::begin(graph_.children);
         size_t bestA = std::distance(begin, findBestA(begin, std::end(graph_.children)));
@@ -255,11 +317,21 @@ namespace AIToolbox::POMDP {
         // Since we do not update the root value in simulate,
         // we do it here.
         graph_.V = graph_.children[bestA].V;
+
+        if ( stats ) {
+            stats->simulations = simulations;
+            stats->maxDepth = reachedDepth_;
+            stats->rootVisits.resize(A);
+            for ( size_t a = 0; a < A; ++a )
+                stats->rootVisits[a] = graph_.children[a].N;
+        }
         return bestA;
     }
 
     template <typename M, bool UseEntropy>
     double rPOMCP<M, UseEntropy>::simulate(BNode & b, size_t s, unsigned depth) {
+        reachedDepth_ = std::max(reachedDepth_, depth);
+
         b.N++;
 
         // Select next action node
@@ -6,6 +6,7 @@
 
 #include <AIToolbox/MDP/IO.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 #include <AIToolbox/POMDP/TypeTraits.hpp>
 #include <AIToolbox/POMDP/Model.hpp>
@@ -150,6 +151,67 @@ namespace AIToolbox::POMDP {
         return is;
     }
 
+    /**
+     * @brief This function writes a POMDP::Model to a stream in binary format.
+     *
+     * The MDP part is laid out as in MDP::writeBinary(), followed by the
+     * observation matrices. The file can be loaded back with
+     * loadBinaryModel(). The stream should be opened in binary mode.
+     *
+     * @param os The output stream.
+     * @param m The model to write.
+     *
+     * @return The output stream.
+     */
+    std::ostream& writeBinary(std::ostream &os, const Model<MDP::Model> & m);
+
+    /**
+     * @brief This function writes a POMDP::SparseModel to a stream in binary format.
+     *
+     * The MDP part is laid out as in MDP::writeBinary(), followed by the
+     * observation matrices in CSR form. The file can be loaded back with
+     * loadBinarySparseModel(). The stream should be opened in binary mode.
+     *
+     * @param os The output stream.
+     * @param m The model to write.
+     *
+     * @return The output stream.
+     */
+    std::ostream& writeBinary(std::ostream &os, const SparseModel<MDP::SparseModel> & m);
+
+    /**
+     * @brief This function loads a POMDP::Model from a binary file.
+     *
+     * Each matrix is read from the file directly into the new Model. The
+     * data is assumed to be a valid model, and it is not checked again,
+     * except for the discount.
+     *
+     * This function throws std::runtime_error if the file cannot be read,
+     * or if it does not contain a POMDP::Model written by writeBinary().
+     *
+     * @param filename The name of the file to load.
+     *
+     * @return The loaded model.
+     */
+    Model<MDP::Model> loadBinaryModel(const std::string & filename);
+
+    /**
+     * @brief This function loads a POMDP::SparseModel from a binary file.
+     *
+     * Each CSR array is read from the file directly into the new
+     * SparseModel. The data is assumed to be a valid model, and it is not
+     * checked again, except for the sparse indices and the discount.
+     *
+     * This function throws std::runtime_error if the file cannot be read,
+     * or if it does not contain a POMDP::SparseModel written by
+     * writeBinary().
+     *
+     * @param filename The name of the file to load.
+     *
+     * @return The loaded model.
+     */
+    SparseModel<MDP::SparseModel> loadBinarySparseModel(const std::string & filename);
+
     /**
      * @brief This function reads a policy from a file.
      *
@@ -153,7 +153,7 @@ namespace AIToolbox::POMDP {
         auto & br = *bRet;
 
         if constexpr(is_model_eigen_v<M>) {
-            br = model.getObservationFunction(a).col(o).cwiseProduct((b.transpose() * model.getTransitionFunction(a)).transpose());
+            br = model.getObservationFunction(a).col(o).cwiseProduct((b.transpose() * model.getTransitionFunction(a).template cast<double>()).transpose());
         } else {
             const size_t S = model.getS();
             for ( size_t s1 = 0; s1 < S; ++s1 ) {
@@ -271,7 +271,7 @@ namespace AIToolbox::POMDP {
         auto & br = *bRet;
 
         if constexpr(is_model_eigen_v<M>) {
-            br = (b.transpose() * model.getTransitionFunction(a)).transpose();
+            br = (b.transpose() * model.getTransitionFunction(a).template cast<double>()).transpose();
         } else {
             const size_t S = model.getS();
             for ( size_t s1 = 0; s1 < S; ++s1 ) {
@@ -579,7 +579,7 @@ namespace AIToolbox::POMDP {
 
                 bpAlpha += pomdp.getObservationFunction(a).col(o).cwiseProduct(it->values);
             }
-            immediateRewards.col(a) += pomdp.getDiscount() * pomdp.getTransitionFunction(a) * bpAlpha;
+            immediateRewards.col(a) += pomdp.getDiscount() * pomdp.getTransitionFunction(a).template cast<double>() * bpAlpha;
         }
 
         size_t id;
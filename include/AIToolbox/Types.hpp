@@ -14,13 +14,29 @@ namespace AIToolbox {
     // This should have decent properties.
     using RandomEngine = std::mt19937;
 
-    using Vector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+    // Scalar-generic versions of the main containers. Most of the library
+    // works with double, but some classes (like MDP::SparseModelT) can store
+    // their data in a different precision to save memory.
+    template <typename T>
+    using VectorT = Eigen::Matrix<T, Eigen::Dynamic, 1>;
 
-    using Matrix2D       = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor | Eigen::AutoAlign>;
-    using SparseMatrix2D = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+    template <typename T>
+    using Matrix2DT       = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor | Eigen::AutoAlign>;
+    template <typename T>
+    using SparseMatrix2DT = Eigen::SparseMatrix<T, Eigen::RowMajor>;
 
-    using Matrix3D       = std::vector<Matrix2D>;
-    using SparseMatrix3D = std::vector<SparseMatrix2D>;
+    template <typename T>
+    using Matrix3DT       = std::vector<Matrix2DT<T>>;
+    template <typename T>
+    using SparseMatrix3DT = std::vector<SparseMatrix2DT<T>>;
+
+    using Vector = VectorT<double>;
+
+    using Matrix2D       = Matrix2DT<double>;
+    using SparseMatrix2D = SparseMatrix2DT<double>;
+
+    using Matrix3D       = Matrix3DT<double>;
+    using SparseMatrix3D = SparseMatrix3DT<double>;
 
     using Matrix4D       = boost::multi_array<Matrix2D,       2>;
     using SparseMatrix4D = boost::multi_array<SparseMatrix2D, 2>;
@@ -0,0 +1,293 @@
+#ifndef AI_TOOLBOX_UTILS_INDEXED_HEAP_HEADER_FILE
+#define AI_TOOLBOX_UTILS_INDEXED_HEAP_HEADER_FILE
+
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief This class is a d-ary max-heap over a dense range of integer keys.
+     *
+     * Each element in the heap is identified by an integer key, and at most
+     * one element per key can be in the heap at any time. This allows to
+     * find and increase the priority of an element already in the heap in
+     * constant time, without keeping handles around.
+     *
+     * The heap is stored in a single flat vector, together with a vector
+     * that maps each key to its position in the heap. Once the heap has
+     * grown to its working size, no operation allocates memory. The
+     * position vector grows automatically to fit the largest key pushed,
+     * but it can be sized in advance with the constructor or reserve().
+     *
+     * Higher arities result in shallower heaps, which make pushes and
+     * increases cheaper and pops a bit more expensive. A 4-ary heap is
+     * usually a good compromise.
+     *
+     * @tparam D The arity of the heap.
+     */
+    template <unsigned D = 4>
+    class IndexedHeap {
+        static_assert(D >= 2, "The arity of the heap must be at least 2!");
+
+        public:
+            /**
+             * @brief The type of the elements stored in the heap.
+             */
+            struct Entry {
+                double priority;
+                size_t key;
+            };
+
+            using const_iterator = typename std::vector<Entry>::const_iterator;
+
+            /**
+             * @brief Basic constructor.
+             *
+             * @param keys The number of keys to reserve space for.
+             */
+            IndexedHeap(size_t keys = 0);
+
+            /**
+             * @brief This function inserts a new element in the heap.
+             *
+             * The key must not already be in the heap.
+             *
+             * @param key The key of the new element.
+             * @param priority The priority of the new element.
+             */
+            void push(size_t key, double priority);
+
+            /**
+             * @brief This function increases the priority of an element in the heap.
+             *
+             * The key must already be in the heap. If the input priority
+             * is not higher than the current one, nothing happens.
+             *
+             * @param key The key of the element.
+             * @param priority The new priority of the element.
+             */
+            void increase(size_t key, double priority);
+
+            /**
+             * @brief This function inserts an element, or increases its priority if it is already present.
+             *
+             * @param key The key of the element.
+             * @param priority The priority of the element.
+             */
+            void pushOrIncrease(size_t key, double priority);
+
+            /**
+             * @brief This function returns the element with the highest priority.
+             *
+             * The heap must not be empty.
+             *
+             * @return The top element of the heap.
+             */
+            const Entry & top() const;
+
+            /**
+             * @brief This function removes the element with the highest priority.
+             *
+             * The heap must not be empty.
+             */
+            void pop();
+
+            /**
+             * @brief This function returns whether the input key is in the heap.
+             *
+             * @param key The key to check.
+             *
+             * @return True if the key is in the heap, false otherwise.
+             */
+            bool contains(size_t key) const;
+
+            /**
+             * @brief This function returns the priority of an element in the heap.
+             *
+             * The key must already be in the heap.
+             *
+             * @param key The key of the element.
+             *
+             * @return The priority of the element.
+             */
+            double getPriority(size_t key) const;
+
+            /**
+             * @brief This function removes all elements from the heap.
+             *
+             * This function does not release any memory.
+             */
+            void clear();
+
+            /**
+             * @brief This function reserves space for the input number of keys.
+             *
+             * @param keys The number of keys to reserve space for.
+             */
+            void reserve(size_t keys);
+
+            /**
+             * @brief This function returns the number of elements in the heap.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns whether the heap is empty.
+             */
+            bool empty() const;
+
+            /**
+             * @brief This function returns an iterator to the beginning of the heap storage.
+             *
+             * Elements are iterated in heap order, not in priority order.
+             */
+            const_iterator begin() const;
+
+            /**
+             * @brief This function returns an iterator to the end of the heap storage.
+             */
+            const_iterator end() const;
+
+        private:
+            static constexpr size_t NotInHeap = std::numeric_limits<size_t>::max();
+
+            void siftUp(size_t i);
+            void siftDown(size_t i);
+
+            std::vector<Entry> heap_;
+            std::vector<size_t> positions_;
+    };
+
+    template <unsigned D>
+    IndexedHeap<D>::IndexedHeap(const size_t keys) : positions_(keys, NotInHeap) {}
+
+    template <unsigned D>
+    void IndexedHeap<D>::push(const size_t key, const double priority) {
+        if ( key >= positions_.size() )
+            positions_.resize(key + 1, NotInHeap);
+
+        heap_.push_back({priority, key});
+        siftUp(heap_.size() - 1);
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::increase(const size_t key, const double priority) {
+        const auto i = positions_[key];
+        if ( heap_[i].priority >= priority ) return;
+
+        heap_[i].priority = priority;
+        siftUp(i);
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::pushOrIncrease(const size_t key, const double priority) {
+        if ( contains(key) ) increase(key, priority);
+        else push(key, priority);
+    }
+
+    template <unsigned D>
+    const typename IndexedHeap<D>::Entry & IndexedHeap<D>::top() const {
+        return heap_[0];
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::pop() {
+        positions_[heap_[0].key] = NotInHeap;
+
+        if ( heap_.size() > 1 ) {
+            heap_[0] = heap_.back();
+            heap_.pop_back();
+            siftDown(0);
+        } else {
+            heap_.pop_back();
+        }
+    }
+
+    template <unsigned D>
+    bool IndexedHeap<D>::contains(const size_t key) const {
+        return key < positions_.size() && positions_[key] != NotInHeap;
+    }
+
+    template <unsigned D>
+    double IndexedHeap<D>::getPriority(const size_t key) const {
+        return heap_[positions_[key]].priority;
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::clear() {
+        // We only reset the keys we have, so this is O(size()).
+        for ( const auto & e : heap_ )
+            positions_[e.key] = NotInHeap;
+        heap_.clear();
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::reserve(const size_t keys) {
+        if ( keys > positions_.size() )
+            positions_.resize(keys, NotInHeap);
+        heap_.reserve(keys);
+    }
+
+    template <unsigned D>
+    size_t IndexedHeap<D>::size() const {
+        return heap_.size();
+    }
+
+    template <unsigned D>
+    bool IndexedHeap<D>::empty() const {
+        return heap_.empty();
+    }
+
+    template <unsigned D>
+    typename IndexedHeap<D>::const_iterator IndexedHeap<D>::begin() const {
+        return heap_.begin();
+    }
+
+    template <unsigned D>
+    typename IndexedHeap<D>::const_iterator IndexedHeap<D>::end() const {
+        return heap_.end();
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::siftUp(size_t i) {
+        const Entry e = heap_[i];
+        while ( i > 0 ) {
+            const size_t parent = (i - 1) / D;
+            if ( heap_[parent].priority >= e.priority ) break;
+
+            heap_[i] = heap_[parent];
+            positions_[heap_[i].key] = i;
+            i = parent;
+        }
+        heap_[i] = e;
+        positions_[e.key] = i;
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::siftDown(size_t i) {
+        const Entry e = heap_[i];
+        const size_t size = heap_.size();
+        while ( true ) {
+            const size_t first = i * D + 1;
+            if ( first >= size ) break;
+
+            const size_t last = std::min(first + D, size);
+            size_t best = first;
+            for ( size_t c = first + 1; c < last; ++c )
+                if ( heap_[c].priority > heap_[best].priority )
+                    best = c;
+
+            if ( heap_[best].priority <= e.priority ) break;
+
+            heap_[i] = heap_[best];
+            positions_[heap_[i].key] = i;
+            i = best;
+        }
+        heap_[i] = e;
+        positions_[e.key] = i;
+    }
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef AI_TOOLBOX_UTILS_PARALLEL_HEADER_FILE
+#define AI_TOOLBOX_UTILS_PARALLEL_HEADER_FILE
+
+#include <cstddef>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief This function returns the number of threads to use given a requested amount.
+     *
+     * A request of zero threads is interpreted as "use all available
+     * hardware threads". The returned number is always at least 1, and is
+     * never larger than the number of work items, so that no thread is
+     * spawned with nothing to do.
+     *
+     * @param threads The number of requested threads, or 0 for the hardware concurrency.
+     * @param N The number of work items that are going to be split.
+     *
+     * @return The number of threads that should be used.
+     */
+    inline unsigned getNumThreads(unsigned threads, const size_t N) {
+        if ( threads == 0 ) threads = std::thread::hardware_concurrency();
+        if ( N < threads ) threads = static_cast<unsigned>(N);
+        return std::max(1u, threads);
+    }
+
+    /**
+     * @brief This function splits the range [0, N) in contiguous blocks and processes them in parallel.
+     *
+     * The input function is called exactly once per block, with signature
+     *
+     *     void(size_t begin, size_t end, unsigned threadId);
+     *
+     * Blocks are assigned to threads in order, so that threadId `i` always
+     * receives the i-th block of the range. This allows callers to
+     * accumulate per-thread results in a vector indexed by threadId, and
+     * to reduce them afterwards in a deterministic order.
+     *
+     * The last block is processed by the calling thread. If a block throws,
+     * all threads are joined and the first exception (in threadId order)
+     * is rethrown.
+     *
+     * @param N The size of the range to process.
+     * @param threads The number of threads to use (see getNumThreads()).
+     * @param f The function to call on each block.
+     */
+    namespace Impl {
+        /**
+         * @brief This function returns the start of the t-th of T contiguous blocks splitting [0, N).
+         *
+         * The first N % T blocks are one element larger than the others.
+         */
+        inline size_t blockBegin(const size_t N, const unsigned T, const unsigned t) {
+            return t * (N / T) + std::min<size_t>(t, N % T);
+        }
+    }
+
+    template <typename F>
+    void parallelFor(const size_t N, const unsigned threads, F f) {
+        const unsigned T = getNumThreads(threads, N);
+        if ( T == 1 ) {
+            f(size_t(0), N, 0u);
+            return;
+        }
+
+        const auto blockBegin = [&](unsigned t) {
+            return Impl::blockBegin(N, T, t);
+        };
+
+        std::vector<std::exception_ptr> errors(T);
+        std::vector<std::thread> workers;
+        workers.reserve(T - 1);
+
+        const auto run = [&](unsigned t) {
+            try {
+                f(blockBegin(t), blockBegin(t + 1), t);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        for ( unsigned t = 0; t < T - 1; ++t )
+            workers.emplace_back(run, t);
+        run(T - 1);
+
+        for ( auto & w : workers )
+            w.join();
+
+        for ( auto & e : errors )
+            if ( e ) std::rethrow_exception(e);
+    }
+
+    /**
+     * @brief This class keeps a fixed set of threads alive to run many parallelFor calls.
+     *
+     * The free parallelFor() function creates and joins its threads on
+     * every call, which is fine for one-off work but dominates the cost of
+     * short loops that are repeated many times, such as one Bellman backup
+     * per iteration of a solver. A ThreadPool spawns its workers once, and
+     * each call to parallelFor() only wakes them up and waits for them.
+     *
+     * The semantics of ThreadPool::parallelFor() are the same as those of
+     * the free function: blocks are assigned in threadId order, the last
+     * block runs on the calling thread, and the first exception in
+     * threadId order is rethrown after all blocks are done.
+     *
+     * A pool must only be used by one calling thread at a time.
+     */
+    class ThreadPool {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * The pool spawns one less thread than requested, as the
+             * calling thread always processes the last block.
+             *
+             * @param threads The total number of threads, as returned by getNumThreads().
+             */
+            explicit ThreadPool(unsigned threads) :
+                    generation_(0), pending_(0), stop_(false)
+            {
+                threads = std::max(1u, threads);
+                workers_.reserve(threads - 1);
+                for ( unsigned t = 0; t < threads - 1; ++t )
+                    workers_.emplace_back(&ThreadPool::work, this, t);
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool & operator=(const ThreadPool &) = delete;
+
+            /**
+             * @brief Destructor.
+             *
+             * Stops and joins all workers.
+             */
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                start_.notify_all();
+                for ( auto & w : workers_ )
+                    w.join();
+            }
+
+            /**
+             * @brief This function splits the range [0, N) in contiguous blocks and processes them on the pool.
+             *
+             * The number of blocks is the size of the pool, or N if that
+             * is smaller. See the free parallelFor() for the semantics of
+             * the input function.
+             *
+             * @param N The size of the range to process.
+             * @param f The function to call on each block.
+             */
+            template <typename F>
+            void parallelFor(const size_t N, F f) {
+                const unsigned T = getNumThreads(size(), N);
+                if ( T == 1 ) {
+                    f(size_t(0), N, 0u);
+                    return;
+                }
+
+                std::vector<std::exception_ptr> errors(T);
+                const auto run = [&](unsigned t) {
+                    try {
+                        f(Impl::blockBegin(N, T, t), Impl::blockBegin(N, T, t + 1), t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                };
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    // Workers past the last block have nothing to do.
+                    task_ = [&](unsigned t) { if ( t + 1 < T ) run(t); };
+                    pending_ = static_cast<unsigned>(workers_.size());
+                    ++generation_;
+                }
+                start_.notify_all();
+
+                // The calling thread takes the last block, so that with
+                // fewer blocks than threads the idle workers are the ones
+                // with the highest ids.
+                run(T - 1);
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    done_.wait(lock, [this]{ return pending_ == 0; });
+                    task_ = nullptr;
+                }
+
+                for ( auto & e : errors )
+                    if ( e ) std::rethrow_exception(e);
+            }
+
+            /**
+             * @brief This function returns the total number of threads of the pool, including the caller.
+             *
+             * @return The number of threads.
+             */
+            unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+        private:
+            void work(const unsigned id) {
+                unsigned seen = 0;
+                while ( true ) {
+                    std::function<void(unsigned)> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        start_.wait(lock, [&]{ return stop_ || generation_ != seen; });
+                        if ( stop_ ) return;
+                        seen = generation_;
+                        task = task_;
+                    }
+                    task(id);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if ( --pending_ == 0 ) done_.notify_one();
+                    }
+                }
+            }
+
+            std::vector<std::thread> workers_;
+            std::mutex mutex_;
+            std::condition_variable start_, done_;
+            std::function<void(unsigned)> task_;
+            unsigned generation_, pending_;
+            bool stop_;
+    };
+}
+
+#endif
@@ -97,22 +97,28 @@ namespace AIToolbox {
      * std::uniform_real_distribution<double>, since that is what is used
      * to obtain the random sample.
      *
+     * @tparam T The scalar type of the sparse container.
      * @tparam G The type of the generator used.
      * @param in The external probability container.
      * @param d The size of the supplied container.
      * @param generator The generator used to sample.
      *
-     * @return An index in range [0,d-1].
+     * @return An index in range [0,d-1]; if the row sums to less than one,
+     *         the leftover probability goes to its last non-zero index.
      */
-    template <typename G>
-    size_t sampleProbability(const size_t d, const SparseMatrix2D::ConstRowXpr& in, G& generator) {
+    template <typename T, typename G>
+    size_t sampleProbability(const size_t d, const Eigen::Block<const SparseMatrix2DT<T>, 1, Eigen::Dynamic, true>& in, G& generator) {
         double p = probabilityDistribution(generator);
 
-        for ( SparseMatrix2D::ConstRowXpr::InnerIterator i(in, 0); ; ++i ) {
+        // With float values the row may sum to slightly less than p, in
+        // which case we fall back to its last non-zero.
+        size_t last = d-1;
+        for ( typename SparseMatrix2DT<T>::ConstRowXpr::InnerIterator i(in, 0); i; ++i ) {
             if ( i.value() > p ) return i.col();
             p -= i.value();
+            last = i.col();
         }
-        return d-1;
+        return last;
     }
 
     /**
@@ -0,0 +1,201 @@
+#ifndef AI_TOOLBOX_UTILS_SAMPLING_INDEX_HEADER_FILE
+#define AI_TOOLBOX_UTILS_SAMPLING_INDEX_HEADER_FILE
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <AIToolbox/Types.hpp>
+#include <AIToolbox/Utils/Probability.hpp>
+
+namespace AIToolbox {
+    /**
+     * @brief This class stores a set of VoseAliasSampler for repeated O(1) sampling.
+     *
+     * This class is meant to be used by models that need to sample
+     * repeatedly from a large number of fixed distributions (for example,
+     * one per state-action pair). Each distribution is identified by an
+     * index, and can be built independently, either all at once or lazily
+     * on first use.
+     *
+     * Each sampler is built only over the non-zero entries of its input
+     * distribution, so that its memory usage depends on the number of
+     * possible outcomes rather than on the size of the full distribution.
+     * This makes the index useful for both dense and sparse models.
+     *
+     * Built samplers are immutable, and are shared between copies of the
+     * same SamplingIndex. Clearing or rebuilding a sampler in one copy does
+     * not affect the others.
+     */
+    class SamplingIndex {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * @param size The number of distributions that can be stored.
+             */
+            SamplingIndex(size_t size = 0) : samplers_(size), memory_(0), blockBytes_(0) {}
+
+            /**
+             * @brief This function builds the sampler for the given distribution.
+             *
+             * The input can be any dense or sparse Eigen vector expression
+             * (such as a row of a transition matrix). Any previously built
+             * sampler for the same index is replaced.
+             *
+             * This function does not check that the input is a valid
+             * probability distribution.
+             *
+             * @param i The index of the distribution to build.
+             * @param p The probability distribution to sample from.
+             */
+            template <typename V>
+            void build(size_t i, const V & p);
+
+            /**
+             * @brief This function samples from a previously built distribution.
+             *
+             * This function does not check that the sampler for the input
+             * index has been built.
+             *
+             * @param i The index of the distribution to sample.
+             * @param generator A random number generator.
+             *
+             * @return An index of the original distribution.
+             */
+            template <typename G>
+            size_t sample(size_t i, G & generator) const {
+                const auto & sampler = *samplers_[i];
+                return sampler.ids[sampler.alias.sampleProbability(generator)];
+            }
+
+            /**
+             * @brief This function returns whether the sampler for the given index has been built.
+             *
+             * @param i The index of the distribution to check.
+             *
+             * @return True if the sampler has been built, false otherwise.
+             */
+            bool isBuilt(size_t i) const { return bool(samplers_[i]); }
+
+            /**
+             * @brief This function removes all built samplers, and resizes the index.
+             *
+             * @param size The new number of distributions that can be stored.
+             */
+            void reset(size_t size) {
+                // Assigning a new vector also releases the old capacity.
+                samplers_ = decltype(samplers_)(size);
+                memory_ = 0;
+            }
+
+            /**
+             * @brief This function removes all built samplers.
+             */
+            void clear() { reset(samplers_.size()); }
+
+            /**
+             * @brief This function returns the number of distributions that can be stored.
+             *
+             * @return The size of the index.
+             */
+            size_t size() const { return samplers_.size(); }
+
+            /**
+             * @brief This function returns the memory used by the index, in bytes.
+             *
+             * This includes the per-index bookkeeping and, for every built
+             * sampler, both its own allocation (which also holds the
+             * shared_ptr control block) and the heap storage of its
+             * arrays. The overhead of the memory allocator itself is not
+             * included. Samplers shared between copies are counted by
+             * each copy.
+             *
+             * @return The number of bytes used by the index.
+             */
+            size_t getMemoryUsage() const {
+                return memory_ + samplers_.capacity() * sizeof(typename decltype(samplers_)::value_type);
+            }
+
+        private:
+            struct Sampler {
+                std::vector<size_t> ids;
+                VoseAliasSampler alias;
+            };
+
+            // Works like std::allocator, but records the size of what it
+            // allocates; this lets us measure the single block that
+            // allocate_shared uses for a Sampler and its control block.
+            template <typename T>
+            struct CountingAllocator {
+                using value_type = T;
+
+                CountingAllocator(size_t * b) : bytes(b) {}
+                template <typename U>
+                CountingAllocator(const CountingAllocator<U> & other) : bytes(other.bytes) {}
+
+                T * allocate(size_t n) {
+                    *bytes += n * sizeof(T);
+                    return std::allocator<T>().allocate(n);
+                }
+                void deallocate(T * p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+                template <typename U>
+                bool operator==(const CountingAllocator<U> &) const { return true; }
+                template <typename U>
+                bool operator!=(const CountingAllocator<U> &) const { return false; }
+
+                size_t * bytes;
+            };
+
+            /**
+             * @brief This function returns the heap memory used by the arrays of a sampler.
+             *
+             * The VoseAliasSampler keeps a probability and an alias per
+             * outcome.
+             */
+            static size_t arraysMemory(const Sampler & sampler) {
+                return sampler.ids.capacity() * sizeof(size_t) + sampler.ids.size() * (sizeof(double) + sizeof(size_t));
+            }
+
+            std::vector<std::shared_ptr<const Sampler>> samplers_;
+            size_t memory_;
+            // The size of the allocation of a Sampler with its control
+            // block. It's the same for all samplers.
+            size_t blockBytes_;
+    };
+
+    template <typename V>
+    void SamplingIndex::build(const size_t i, const V & p) {
+        std::vector<size_t> ids;
+        std::vector<double> values;
+
+        if constexpr (std::is_base_of_v<Eigen::SparseMatrixBase<V>, V>) {
+            for ( typename V::InnerIterator it(p, 0); it; ++it ) {
+                if ( it.value() <= 0.0 ) continue;
+                ids.push_back(it.index());
+                values.push_back(it.value());
+            }
+        } else {
+            for ( Eigen::Index j = 0; j < p.size(); ++j ) {
+                if ( p[j] <= 0.0 ) continue;
+                ids.push_back(j);
+                values.push_back(p[j]);
+            }
+        }
+
+        const ProbabilityVector pv = Eigen::Map<const Vector>(values.data(), values.size());
+        ids.shrink_to_fit();
+
+        if ( samplers_[i] ) memory_ -= blockBytes_ + arraysMemory(*samplers_[i]);
+
+        // The allocator only uses the counter while allocating, here.
+        size_t bytes = 0;
+        samplers_[i] = std::allocate_shared<const Sampler>(CountingAllocator<Sampler>(&bytes), Sampler{std::move(ids), VoseAliasSampler(pv)});
+        blockBytes_ = bytes;
+
+        memory_ += blockBytes_ + arraysMemory(*samplers_[i]);
+    }
+}
+
+#endif
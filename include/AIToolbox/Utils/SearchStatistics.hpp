@@ -0,0 +1,64 @@
+#ifndef AI_TOOLBOX_UTILS_SEARCH_STATISTICS_HEADER_FILE
+#define AI_TOOLBOX_UTILS_SEARCH_STATISTICS_HEADER_FILE
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief The clock used by the deadlines of online planners.
+     *
+     * This is a monotonic clock, so deadlines are not affected by changes
+     * to the system time.
+     */
+    using SearchClock = std::chrono::steady_clock;
+
+    /**
+     * @brief This struct reports what an online planner did during a single search.
+     *
+     * Planners that can reuse their tree between searches (like MCTS and
+     * POMCP) report in rootVisits the visits of the root actions made by
+     * all searches that contributed to the current root, while
+     * simulations only counts the simulations of the last search.
+     */
+    struct SearchStatistics {
+        /// The number of simulations run.
+        unsigned simulations = 0;
+        /// The deepest tree level reached by a simulation, where the root is at depth 0.
+        unsigned maxDepth = 0;
+        /// The number of visits of each root action.
+        std::vector<unsigned> rootVisits;
+    };
+
+    /**
+     * @brief This function runs the simulations of a single search.
+     *
+     * Without a deadline, the input simulation is run exactly iterations
+     * times. With a deadline, iterations is ignored and simulations are
+     * run until the deadline expires; at least one is always run, so that
+     * even an expired deadline returns an informed action.
+     *
+     * @param iterations The number of simulations to run without a deadline.
+     * @param deadline The time at which to stop, or nullptr.
+     * @param simulation The function running a single simulation.
+     *
+     * @return The number of simulations run.
+     */
+    template <typename F>
+    unsigned runSimulations(const size_t iterations, const SearchClock::time_point * deadline, F simulation) {
+        unsigned simulations = 0;
+        if ( !deadline ) {
+            for ( ; simulations < iterations; ++simulations )
+                simulation();
+            return simulations;
+        }
+        do {
+            simulation();
+            ++simulations;
+        } while ( SearchClock::now() < *deadline );
+        return simulations;
+    }
+}
+
+#endif
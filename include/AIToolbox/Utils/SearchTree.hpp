@@ -0,0 +1,425 @@
+#ifndef AI_TOOLBOX_UTILS_SEARCH_TREE_HEADER_FILE
+#define AI_TOOLBOX_UTILS_SEARCH_TREE_HEADER_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief This is the default, empty, per-node payload of a SearchTree.
+     */
+    struct SearchTreeNoData {};
+
+    /**
+     * @brief This class stores the alternating state/action tree of Monte Carlo tree search methods.
+     *
+     * A search tree alternates between nodes, which represent states (or
+     * beliefs), and edges, which represent the actions that can be taken
+     * from them. Each expanded node owns exactly A edges, and each edge
+     * links to the nodes that were reached through it, identified by an
+     * integer key (a state, or an observation).
+     *
+     * Rather than having every node own its own containers, all nodes and
+     * all edges live in two arenas, and refer to each other with 32 bit
+     * indices. The A edges of a node are contiguous, while the children
+     * of an edge form a singly linked list through the nodes themselves.
+     * This list works as a small map: the number of different outcomes of
+     * an action is usually small, and a short linear scan over compact
+     * nodes is cheaper than hashing.
+     *
+     * The arenas grow in chunks, each twice as large as the previous one,
+     * and chunks are never moved or freed. References to nodes and edges
+     * thus stay valid while the tree grows, which also allows multiple
+     * threads to read and update the tree while another one is allocating
+     * (as long as allocations themselves are serialized).
+     *
+     * Discarding part of the tree is O(1): reroot() and reset() simply
+     * push the discarded root on a garbage list. Memory is then
+     * reclaimed lazily, one node at a time, whenever a new node needs to
+     * be allocated; the arena only grows when there is nothing left to
+     * recycle. Payloads which have a clear() method are cleared rather
+     * than reconstructed, so that they keep their memory.
+     *
+     * @tparam Data The payload to store in each node.
+     */
+    template <typename Data = SearchTreeNoData>
+    class SearchTree {
+        public:
+            using Index = std::uint32_t;
+            static constexpr Index None = std::numeric_limits<Index>::max();
+
+            struct Edge {
+                double V = 0.0;
+                unsigned N = 0;
+                // Simulations currently running through this edge; used by
+                // tree-parallel searches for virtual loss.
+                unsigned pending = 0;
+                Index child = None;
+            };
+
+            struct Node {
+                size_t key = 0;
+                unsigned N = 0;
+                Index sibling = None;
+                Index edges = None;
+                Data data;
+            };
+
+            /**
+             * @brief Basic constructor.
+             *
+             * The tree is created with a single, unexpanded, root.
+             *
+             * @param A The number of edges of each expanded node.
+             */
+            SearchTree(size_t A);
+
+            /**
+             * @brief This function returns the index of the root node.
+             *
+             * @return The index of the root.
+             */
+            Index getRoot() const;
+
+            /**
+             * @brief This function returns the node with the input index.
+             *
+             * @param i The index of the node.
+             *
+             * @return The node.
+             */
+            Node & getNode(Index i);
+            const Node & getNode(Index i) const;
+
+            /**
+             * @brief This function returns the edges of the input node.
+             *
+             * The node must be expanded; the returned pointer points to
+             * exactly A contiguous edges.
+             *
+             * @param i The index of the node.
+             *
+             * @return A pointer to the first edge of the node.
+             */
+            Edge * getEdges(Index i);
+            const Edge * getEdges(Index i) const;
+
+            /**
+             * @brief This function returns whether the input node has edges.
+             *
+             * @param i The index of the node.
+             *
+             * @return True if the node has been expanded.
+             */
+            bool isExpanded(Index i) const;
+
+            /**
+             * @brief This function allocates the edges of the input node.
+             *
+             * If the node is already expanded this function does nothing.
+             *
+             * @param i The index of the node.
+             */
+            void expand(Index i);
+
+            /**
+             * @brief This function finds the child of a node for an action and key.
+             *
+             * @param i The index of the parent node.
+             * @param a The action of the edge to look into.
+             * @param key The key of the child.
+             *
+             * @return The index of the child, or None if it does not exist.
+             */
+            Index findChild(Index i, size_t a, size_t key) const;
+
+            /**
+             * @brief This function adds a new child to an edge.
+             *
+             * The parent must be expanded, and must not already contain a
+             * child with the same key for the same action.
+             *
+             * @param i The index of the parent node.
+             * @param a The action of the edge to add the child to.
+             * @param key The key of the child.
+             *
+             * @return The index of the new, unexpanded, child.
+             */
+            Index addChild(Index i, size_t a, size_t key);
+
+            /**
+             * @brief This function makes a child of the root the new root.
+             *
+             * The new root keeps all its statistics and subtree, while the
+             * rest of the tree is discarded in O(1), and recycled by later
+             * allocations.
+             *
+             * If the child does not exist the tree is not modified.
+             *
+             * @param a The action taken from the root.
+             * @param key The key of the child to keep.
+             *
+             * @return True if the child existed and is now the root.
+             */
+            bool reroot(size_t a, size_t key);
+
+            /**
+             * @brief This function discards the whole tree, leaving a single unexpanded root.
+             *
+             * This function does not release any memory.
+             */
+            void reset();
+
+            /**
+             * @brief This function returns the number of edges of each expanded node.
+             *
+             * @return The number of actions.
+             */
+            size_t getA() const;
+
+            /**
+             * @brief This function returns the number of nodes ever allocated by the arena.
+             *
+             * This includes both nodes in the tree and nodes waiting to be
+             * recycled, and so never decreases.
+             *
+             * @return The number of allocated nodes.
+             */
+            size_t getAllocatedNodes() const;
+
+        private:
+            /**
+             * @brief This class is an arena of fixed-width blocks which never moves its contents.
+             *
+             * Chunk k holds Base * 2^k blocks, so a handful of chunks
+             * covers the whole 32 bit index range, and their pointers can
+             * be kept in a fixed array.
+             */
+            template <typename T, Index Base>
+            class Pool {
+                public:
+                    Pool(size_t width) : width_(width), size_(0) {}
+
+                    Pool(const Pool & other) : width_(other.width_), size_(other.size_) {
+                        for ( size_t k = 0; k < chunks_.size() && other.chunks_[k]; ++k ) {
+                            const size_t elements = (size_t(Base) << k) * width_;
+                            chunks_[k].reset(new T[elements]);
+                            std::copy(other.chunks_[k].get(), other.chunks_[k].get() + elements, chunks_[k].get());
+                        }
+                    }
+
+                    Pool & operator=(const Pool & other) {
+                        if ( this != &other ) {
+                            Pool tmp(other);
+                            *this = std::move(tmp);
+                        }
+                        return *this;
+                    }
+
+                    Pool(Pool &&) = default;
+                    Pool & operator=(Pool &&) = default;
+
+                    Index grow() {
+                        const Index i = size_++;
+                        const auto [k, offset] = locate(i);
+                        if ( offset == 0 )
+                            chunks_[k].reset(new T[(size_t(Base) << k) * width_]());
+                        return i;
+                    }
+
+                    T * get(const Index i) const {
+                        const auto [k, offset] = locate(i);
+                        return chunks_[k].get() + offset * width_;
+                    }
+
+                    size_t size() const { return size_; }
+
+                private:
+                    static std::pair<unsigned, size_t> locate(const Index i) {
+                        // Block i is in chunk floor(log2(i / Base + 1)).
+                        std::uint64_t x = i / Base + 1;
+                        unsigned k = 0;
+                        for ( unsigned shift = 16; shift; shift >>= 1 ) {
+                            if ( x >> shift ) {
+                                x >>= shift;
+                                k += shift;
+                            }
+                        }
+                        return {k, i - size_t(Base) * ((size_t(1) << k) - 1)};
+                    }
+
+                    size_t width_;
+                    Index size_;
+                    std::array<std::unique_ptr<T[]>, 32> chunks_;
+            };
+
+            template <typename T, typename = void>
+            struct has_clear : std::false_type {};
+            template <typename T>
+            struct has_clear<T, std::void_t<decltype(std::declval<T&>().clear())>> : std::true_type {};
+
+            Index allocateNode(size_t key);
+            void recycle(Index i);
+
+            size_t A;
+            Pool<Node, 256> nodes_;
+            Pool<Edge, 64> edges_;
+            std::vector<Index> garbage_;
+            std::vector<Index> freeEdges_;
+            Index root_;
+    };
+
+    template <typename Data>
+    SearchTree<Data>::SearchTree(const size_t a) : A(a), nodes_(1), edges_(A) {
+        root_ = allocateNode(0);
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Index SearchTree<Data>::getRoot() const {
+        return root_;
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Node & SearchTree<Data>::getNode(const Index i) {
+        return *nodes_.get(i);
+    }
+
+    template <typename Data>
+    const typename SearchTree<Data>::Node & SearchTree<Data>::getNode(const Index i) const {
+        return *nodes_.get(i);
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Edge * SearchTree<Data>::getEdges(const Index i) {
+        return edges_.get(getNode(i).edges);
+    }
+
+    template <typename Data>
+    const typename SearchTree<Data>::Edge * SearchTree<Data>::getEdges(const Index i) const {
+        return edges_.get(getNode(i).edges);
+    }
+
+    template <typename Data>
+    bool SearchTree<Data>::isExpanded(const Index i) const {
+        return getNode(i).edges != None;
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::expand(const Index i) {
+        auto & node = getNode(i);
+        if ( node.edges != None ) return;
+
+        if ( freeEdges_.empty() ) {
+            node.edges = edges_.grow();
+        } else {
+            node.edges = freeEdges_.back();
+            freeEdges_.pop_back();
+
+            auto edges = edges_.get(node.edges);
+            std::fill(edges, edges + A, Edge());
+        }
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Index SearchTree<Data>::findChild(const Index i, const size_t a, const size_t key) const {
+        if ( !isExpanded(i) ) return None;
+
+        for ( auto c = getEdges(i)[a].child; c != None; c = getNode(c).sibling )
+            if ( getNode(c).key == key )
+                return c;
+
+        return None;
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Index SearchTree<Data>::addChild(const Index i, const size_t a, const size_t key) {
+        const auto c = allocateNode(key);
+        auto & edge = getEdges(i)[a];
+
+        getNode(c).sibling = edge.child;
+        edge.child = c;
+
+        return c;
+    }
+
+    template <typename Data>
+    bool SearchTree<Data>::reroot(const size_t a, const size_t key) {
+        const auto c = findChild(root_, a, key);
+        if ( c == None ) return false;
+
+        // Unlink the new root, so it is not recycled with its siblings.
+        auto * link = &getEdges(root_)[a].child;
+        while ( *link != c )
+            link = &getNode(*link).sibling;
+        *link = getNode(c).sibling;
+        getNode(c).sibling = None;
+
+        garbage_.push_back(root_);
+        root_ = c;
+
+        return true;
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::reset() {
+        garbage_.push_back(root_);
+        root_ = allocateNode(0);
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::getA() const {
+        return A;
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::getAllocatedNodes() const {
+        return nodes_.size();
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Index SearchTree<Data>::allocateNode(const size_t key) {
+        Index i;
+        if ( garbage_.empty() ) {
+            i = nodes_.grow();
+        } else {
+            i = garbage_.back();
+            garbage_.pop_back();
+            recycle(i);
+        }
+
+        auto & node = getNode(i);
+        node.key = key;
+        node.N = 0;
+        node.sibling = None;
+
+        return i;
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::recycle(const Index i) {
+        auto & node = getNode(i);
+
+        // The children are recycled in turn, when they are needed.
+        if ( node.edges != None ) {
+            const auto edges = edges_.get(node.edges);
+            for ( size_t a = 0; a < A; ++a )
+                for ( auto c = edges[a].child; c != None; c = getNode(c).sibling )
+                    garbage_.push_back(c);
+
+            freeEdges_.push_back(node.edges);
+            node.edges = None;
+        }
+
+        if constexpr (has_clear<Data>::value) node.data.clear();
+        else node.data = Data();
+    }
+}
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef AI_TOOLBOX_UTILS_TRANSPOSITION_TABLE_HEADER_FILE
+#define AI_TOOLBOX_UTILS_TRANSPOSITION_TABLE_HEADER_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+namespace AIToolbox {
+    /**
+     * @brief This class stores the shared nodes of Monte Carlo search on a DAG.
+     *
+     * When the same state can be reached through different paths, a
+     * search tree stores a separate copy of it (and of its statistics)
+     * for each path. This table instead stores a single node for each
+     * pair of key (a state) and depth, which all paths share. Including
+     * the depth in the key guarantees that the resulting graph is acyclic.
+     *
+     * The table has a fixed capacity, allocated on construction, so
+     * memory stays flat no matter how many searches are run with it. It
+     * is organized in buckets of a few entries each; a key can only be
+     * stored in the bucket it hashes to.
+     *
+     * Each entry remembers the generation (i.e. the search) that last
+     * used it. When a bucket is full, a new entry replaces the one that
+     * was used least recently. Entries used by the current generation are
+     * never replaced, so that nodes on the path of a running simulation
+     * stay valid; if a bucket only contains such entries the insertion
+     * fails.
+     *
+     * Each entry owns A edges, one per action, in a single contiguous
+     * array.
+     *
+     * @tparam Edge The per-action statistics to store.
+     */
+    template <typename Edge>
+    class TranspositionTable {
+        public:
+            using Index = std::uint32_t;
+            static constexpr Index None = std::numeric_limits<Index>::max();
+
+            // The number of entries of each bucket.
+            static constexpr size_t Ways = 4;
+
+            struct Node {
+                size_t key = 0;
+                unsigned depth = 0;
+                unsigned N = 0;
+                // The last generation that used this entry, 0 if empty.
+                unsigned generation = 0;
+            };
+
+            /**
+             * @brief Basic constructor.
+             *
+             * The capacity is rounded up to a multiple of the bucket
+             * size. A table with zero capacity cannot store anything.
+             *
+             * @param A The number of edges of each entry.
+             * @param capacity The maximum number of entries.
+             */
+            TranspositionTable(size_t A, size_t capacity);
+
+            /**
+             * @brief This function starts a new generation.
+             *
+             * All entries used before this call become candidates for
+             * replacement.
+             */
+            void newGeneration();
+
+            /**
+             * @brief This function finds the entry for the input key and depth.
+             *
+             * If found, the entry is marked as used by the current
+             * generation.
+             *
+             * @param key The key of the entry.
+             * @param depth The depth of the entry.
+             *
+             * @return The index of the entry, or None if not present.
+             */
+            Index find(size_t key, unsigned depth);
+
+            /**
+             * @brief This function adds a new entry for the input key and depth.
+             *
+             * The key and depth must not already be in the table. The new
+             * entry, and its edges, are value-initialized.
+             *
+             * @param key The key of the entry.
+             * @param depth The depth of the entry.
+             *
+             * @return The index of the new entry, or None if its bucket only contains entries of the current generation.
+             */
+            Index insert(size_t key, unsigned depth);
+
+            /**
+             * @brief This function returns the entry with the input index.
+             *
+             * @param i The index of the entry.
+             *
+             * @return The entry.
+             */
+            Node & getNode(Index i);
+            const Node & getNode(Index i) const;
+
+            /**
+             * @brief This function returns the edges of the input entry.
+             *
+             * @param i The index of the entry.
+             *
+             * @return A pointer to the A contiguous edges of the entry.
+             */
+            Edge * getEdges(Index i);
+            const Edge * getEdges(Index i) const;
+
+            /**
+             * @brief This function removes all entries from the table.
+             *
+             * This function does not release any memory.
+             */
+            void clear();
+
+            /**
+             * @brief This function returns the number of entries currently stored.
+             *
+             * @return The number of entries.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns the maximum number of entries.
+             *
+             * @return The capacity of the table.
+             */
+            size_t getCapacity() const;
+
+            /**
+             * @brief This function returns the number of edges of each entry.
+             *
+             * @return The number of actions.
+             */
+            size_t getA() const;
+
+            /**
+             * @brief This function returns the current generation.
+             *
+             * @return The current generation.
+             */
+            unsigned getGeneration() const;
+
+        private:
+            size_t getBucket(size_t key, unsigned depth) const;
+
+            size_t A, buckets_;
+            std::vector<Node> nodes_;
+            std::vector<Edge> edges_;
+            size_t size_;
+            unsigned generation_;
+    };
+
+    template <typename Edge>
+    TranspositionTable<Edge>::TranspositionTable(const size_t a, const size_t capacity) :
+            A(a), buckets_((capacity + Ways - 1) / Ways), size_(0), generation_(1)
+    {
+        if ( buckets_ * Ways >= None )
+            throw std::invalid_argument("The capacity of the transposition table is too large");
+
+        nodes_.resize(buckets_ * Ways);
+        edges_.resize(buckets_ * Ways * A);
+    }
+
+    template <typename Edge>
+    void TranspositionTable<Edge>::newGeneration() {
+        // On overflow we restart, forgetting which entries are older.
+        if ( ++generation_ == 0 ) {
+            for ( auto & node : nodes_ )
+                if ( node.generation ) node.generation = 1;
+            generation_ = 2;
+        }
+    }
+
+    template <typename Edge>
+    typename TranspositionTable<Edge>::Index TranspositionTable<Edge>::find(const size_t key, const unsigned depth) {
+        if ( !buckets_ ) return None;
+
+        const size_t begin = getBucket(key, depth) * Ways;
+        for ( size_t i = begin; i < begin + Ways; ++i ) {
+            auto & node = nodes_[i];
+            if ( node.generation && node.key == key && node.depth == depth ) {
+                node.generation = generation_;
+                return i;
+            }
+        }
+        return None;
+    }
+
+    template <typename Edge>
+    typename TranspositionTable<Edge>::Index TranspositionTable<Edge>::insert(const size_t key, const unsigned depth) {
+        if ( !buckets_ ) return None;
+
+        // Empty entries have generation 0, so they are always picked first.
+        const auto begin = nodes_.begin() + getBucket(key, depth) * Ways;
+        const auto it = std::min_element(begin, begin + Ways,
+            [](const Node & lhs, const Node & rhs){ return lhs.generation < rhs.generation; });
+
+        if ( it->generation == generation_ ) return None;
+        if ( !it->generation ) ++size_;
+
+        const Index i = std::distance(nodes_.begin(), it);
+        *it = Node{key, depth, 0, generation_};
+        std::fill(getEdges(i), getEdges(i) + A, Edge());
+
+        return i;
+    }
+
+    template <typename Edge>
+    typename TranspositionTable<Edge>::Node & TranspositionTable<Edge>::getNode(const Index i) {
+        return nodes_[i];
+    }
+
+    template <typename Edge>
+    const typename TranspositionTable<Edge>::Node & TranspositionTable<Edge>::getNode(const Index i) const {
+        return nodes_[i];
+    }
+
+    template <typename Edge>
+    Edge * TranspositionTable<Edge>::getEdges(const Index i) {
+        return edges_.data() + i * A;
+    }
+
+    template <typename Edge>
+    const Edge * TranspositionTable<Edge>::getEdges(const Index i) const {
+        return edges_.data() + i * A;
+    }
+
+    template <typename Edge>
+    void TranspositionTable<Edge>::clear() {
+        std::fill(nodes_.begin(), nodes_.end(), Node());
+        size_ = 0;
+        generation_ = 1;
+    }
+
+    template <typename Edge>
+    size_t TranspositionTable<Edge>::size() const {
+        return size_;
+    }
+
+    template <typename Edge>
+    size_t TranspositionTable<Edge>::getCapacity() const {
+        return nodes_.size();
+    }
+
+    template <typename Edge>
+    size_t TranspositionTable<Edge>::getA() const {
+        return A;
+    }
+
+    template <typename Edge>
+    unsigned TranspositionTable<Edge>::getGeneration() const {
+        return generation_;
+    }
+
+    template <typename Edge>
+    size_t TranspositionTable<Edge>::getBucket(const size_t key, const unsigned depth) const {
+        size_t seed = 0;
+        boost::hash_combine(seed, key);
+        boost::hash_combine(seed, depth);
+        return seed % buckets_;
+    }
+}
+
+#endif
@@ -0,0 +1,382 @@
+#include <AIToolbox/Impl/BinaryModelFormat.hpp>
+
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AIToolbox::Impl {
+    namespace {
+        constexpr char Magic[8] = {'A', 'I', 'T', 'B', 'M', 'D', 'L', '\0'};
+        constexpr std::uint32_t Version = 1;
+        constexpr std::uint32_t ByteOrderMarker = 0x01020304;
+        constexpr size_t HeaderSize = 64;
+        constexpr size_t Alignment = 8;
+
+        // Offsets of the header fields.
+        constexpr size_t VersionOffset   = 8;
+        constexpr size_t KindOffset      = 12;
+        constexpr size_t ByteOrderOffset = 16;
+        constexpr size_t ScalarOffset    = 20;
+        constexpr size_t SOffset         = 24;
+        constexpr size_t AOffset         = 32;
+        constexpr size_t OOffset         = 40;
+        constexpr size_t DiscountOffset  = 48;
+
+        using Index = SparseMatrix2D::StorageIndex;
+        static_assert(sizeof(Index) == sizeof(int), "Sparse matrices are expected to use int indices.");
+
+        template <typename T>
+        void put(char * buffer, const size_t offset, const T value) {
+            std::memcpy(buffer + offset, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T get(const char * buffer, const size_t offset) {
+            T value;
+            std::memcpy(&value, buffer + offset, sizeof(T));
+            return value;
+        }
+
+        size_t padded(const size_t bytes) {
+            return (bytes + Alignment - 1) / Alignment * Alignment;
+        }
+
+        struct Header {
+            size_t scalarSize, S, A, O;
+            double discount;
+        };
+
+        // Validates the header, given the number of bytes that follow it.
+        Header parseHeader(const char * header, const size_t remaining, const BinaryModelKind kind, const std::string & filename) {
+            if ( std::memcmp(header, Magic, sizeof(Magic)) != 0 )
+                throw std::runtime_error("File " + filename + " is not a binary model file.");
+            if ( get<std::uint32_t>(header, ByteOrderOffset) != ByteOrderMarker )
+                throw std::runtime_error("Binary model file " + filename + " was written with a different byte order.");
+            if ( get<std::uint32_t>(header, VersionOffset) != Version )
+                throw std::runtime_error("Binary model file " + filename + " has an unsupported version.");
+            if ( get<std::uint32_t>(header, KindOffset) != static_cast<std::uint32_t>(kind) )
+                throw std::runtime_error("Binary model file " + filename + " contains a different kind of model.");
+
+            Header h;
+            h.scalarSize = get<std::uint32_t>(header, ScalarOffset);
+            if ( h.scalarSize != sizeof(double) && h.scalarSize != sizeof(float) )
+                throw std::runtime_error("Binary model file " + filename + " has an unsupported scalar size.");
+
+            h.S = get<std::uint64_t>(header, SOffset);
+            h.A = get<std::uint64_t>(header, AOffset);
+            h.O = get<std::uint64_t>(header, OOffset);
+            h.discount = get<double>(header, DiscountOffset);
+
+            // The loaders size their containers from S and A before reading
+            // any section, so we bound them here. Every model stores A
+            // transition sections over S rows, and each row takes at least
+            // one index (sparse) or one scalar (dense) of at least
+            // sizeof(Index) bytes.
+            if ( h.S == 0 || h.A == 0 || h.S > remaining || h.A > remaining / h.S / sizeof(Index) )
+                throw std::runtime_error("Binary model file " + filename + " has invalid model dimensions.");
+
+            // The models are built without checks, so this is our only
+            // chance to catch it. Written so that NaN fails too.
+            if ( !(h.discount > 0.0 && h.discount <= 1.0) )
+                throw std::runtime_error("Binary model file " + filename + " has a discount outside (0,1].");
+
+            return h;
+        }
+
+        // Eigen trusts its indices blindly, so we make sure a corrupted
+        // file can't make us read out of bounds later.
+        void checkSparse(const Index * o, const Index * i, const size_t rows, const size_t cols, const size_t nnz) {
+            if ( o[0] != 0 || static_cast<size_t>(o[rows]) != nnz )
+                throw std::runtime_error("Binary model file contains an invalid sparse matrix.");
+            for ( size_t r = 0; r < rows; ++r ) {
+                if ( o[r] > o[r+1] )
+                    throw std::runtime_error("Binary model file contains an invalid sparse matrix.");
+                for ( auto j = o[r]; j < o[r+1]; ++j )
+                    if ( i[j] < 0 || static_cast<size_t>(i[j]) >= cols || (j > o[r] && i[j] <= i[j-1]) )
+                        throw std::runtime_error("Binary model file contains an invalid sparse matrix.");
+            }
+        }
+
+        // Maps the whole file read-only; the returned pointer unmaps it
+        // when the last copy is gone.
+        std::shared_ptr<const char> mapFile(const std::string & filename, size_t & size) {
+#ifdef _WIN32
+            const HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if ( file == INVALID_HANDLE_VALUE )
+                throw std::runtime_error("Could not open binary model file " + filename);
+
+            LARGE_INTEGER fileSize;
+            if ( !GetFileSizeEx(file, &fileSize) ) {
+                CloseHandle(file);
+                throw std::runtime_error("Could not read binary model file " + filename);
+            }
+            size = static_cast<size_t>(fileSize.QuadPart);
+            if ( size < HeaderSize ) {
+                CloseHandle(file);
+                throw std::runtime_error("Binary model file is truncated.");
+            }
+
+            const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if ( !mapping )
+                throw std::runtime_error("Could not map binary model file " + filename);
+
+            const void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            if ( !data )
+                throw std::runtime_error("Could not map binary model file " + filename);
+
+            return std::shared_ptr<const char>(static_cast<const char *>(data),
+                    [](const char * p) { UnmapViewOfFile(p); });
+#else
+            const int fd = ::open(filename.c_str(), O_RDONLY);
+            if ( fd < 0 )
+                throw std::runtime_error("Could not open binary model file " + filename);
+
+            struct stat st;
+            if ( ::fstat(fd, &st) != 0 ) {
+                ::close(fd);
+                throw std::runtime_error("Could not read binary model file " + filename);
+            }
+            size = static_cast<size_t>(st.st_size);
+            // This also avoids mapping empty files, which is an error.
+            if ( size < HeaderSize ) {
+                ::close(fd);
+                throw std::runtime_error("Binary model file is truncated.");
+            }
+
+            void * data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if ( data == MAP_FAILED )
+                throw std::runtime_error("Could not map binary model file " + filename);
+
+            return std::shared_ptr<const char>(static_cast<const char *>(data),
+                    [size](const char * p) { ::munmap(const_cast<char *>(p), size); });
+#endif
+        }
+    }
+
+    BinaryModelWriter::BinaryModelWriter(std::ostream & os, const BinaryModelKind kind, const size_t S, const size_t A, const size_t O, const double discount, const size_t scalarSize) :
+            os_(os), written_(0)
+    {
+        char header[HeaderSize] = {};
+
+        std::memcpy(header, Magic, sizeof(Magic));
+        put<std::uint32_t>(header, VersionOffset,   Version);
+        put<std::uint32_t>(header, KindOffset,      static_cast<std::uint32_t>(kind));
+        put<std::uint32_t>(header, ByteOrderOffset, ByteOrderMarker);
+        put<std::uint32_t>(header, ScalarOffset,    scalarSize);
+        put<std::uint64_t>(header, SOffset,         S);
+        put<std::uint64_t>(header, AOffset,         A);
+        put<std::uint64_t>(header, OOffset,         O);
+        put<double>       (header, DiscountOffset,  discount);
+
+        write(header, HeaderSize);
+    }
+
+    void BinaryModelWriter::writeDense(const Matrix2D & m) {
+        write(m.data(), m.size() * sizeof(double));
+        pad();
+    }
+
+    template <typename Scalar>
+    void BinaryModelWriter::writeSparse(const SparseMatrix2DT<Scalar> & m) {
+        if ( !m.isCompressed() ) {
+            SparseMatrix2DT<Scalar> c = m;
+            c.makeCompressed();
+            writeSparse(c);
+            return;
+        }
+        const std::uint64_t nnz = m.nonZeros();
+        write(&nnz, sizeof(nnz));
+        write(m.outerIndexPtr(), (m.outerSize() + 1) * sizeof(Index));
+        pad();
+        write(m.innerIndexPtr(), nnz * sizeof(Index));
+        pad();
+        write(m.valuePtr(), nnz * sizeof(Scalar));
+        pad();
+    }
+
+    template void BinaryModelWriter::writeSparse(const SparseMatrix2DT<double> & m);
+    template void BinaryModelWriter::writeSparse(const SparseMatrix2DT<float> & m);
+
+    void BinaryModelWriter::write(const void * data, const size_t bytes) {
+        os_.write(static_cast<const char *>(data), bytes);
+        written_ += bytes;
+    }
+
+    void BinaryModelWriter::pad() {
+        static constexpr char zeros[Alignment] = {};
+        write(zeros, padded(written_) - written_);
+    }
+
+    BinaryModelReader::BinaryModelReader(const std::string & filename, const BinaryModelKind kind) :
+            file_(filename, std::ios::binary), size_(0), offset_(0)
+    {
+        if ( !file_ )
+            throw std::runtime_error("Could not open binary model file " + filename);
+
+        file_.seekg(0, std::ios::end);
+        const auto end = file_.tellg();
+        file_.seekg(0, std::ios::beg);
+        if ( !file_ || end < 0 )
+            throw std::runtime_error("Could not read binary model file " + filename);
+        size_ = static_cast<size_t>(end);
+
+        char header[HeaderSize];
+        read(header, HeaderSize);
+
+        const auto h = parseHeader(header, size_ - offset_, kind, filename);
+        scalarSize_ = h.scalarSize;
+        S = h.S;
+        A = h.A;
+        O = h.O;
+        discount_ = h.discount;
+    }
+
+    Matrix2D BinaryModelReader::readDense(const size_t rows, const size_t cols) {
+        // Dimensions come from the file, so the size computation must not
+        // overflow before we compare it with the data we actually have.
+        if ( cols != 0 && rows > std::numeric_limits<size_t>::max() / sizeof(double) / cols )
+            throw std::runtime_error("Binary model file contains an oversized matrix.");
+
+        const auto bytes = rows * cols * sizeof(double);
+        require(bytes);
+
+        Matrix2D retval(rows, cols);
+        read(retval.data(), bytes);
+        skipPadding();
+        return retval;
+    }
+
+    template <typename Scalar>
+    SparseMatrix2DT<Scalar> BinaryModelReader::readSparse(const size_t rows, const size_t cols) {
+        if ( rows > INT_MAX || cols > INT_MAX )
+            throw std::runtime_error("Binary model file contains a sparse matrix too large to be indexed.");
+
+        std::uint64_t nnz;
+        read(&nnz, sizeof(nnz));
+
+        // Each non-zero takes at least one byte, so this check keeps all
+        // the products below from overflowing.
+        if ( nnz > INT_MAX || nnz > size_ - offset_ )
+            throw std::runtime_error("Binary model file is truncated.");
+
+        const auto outerBytes = (rows + 1) * sizeof(Index);
+        const auto innerBytes = nnz * sizeof(Index);
+        const auto valueBytes = nnz * sizeof(Scalar);
+        require(padded(outerBytes) + padded(innerBytes) + valueBytes);
+
+        SparseMatrix2DT<Scalar> retval(rows, cols);
+        retval.resizeNonZeros(nnz);
+        read(retval.outerIndexPtr(), outerBytes);
+        skipPadding();
+        read(retval.innerIndexPtr(), innerBytes);
+        skipPadding();
+        read(retval.valuePtr(), valueBytes);
+        skipPadding();
+
+        checkSparse(retval.outerIndexPtr(), retval.innerIndexPtr(), rows, cols, nnz);
+        return retval;
+    }
+
+    template SparseMatrix2DT<double> BinaryModelReader::readSparse(size_t rows, size_t cols);
+    template SparseMatrix2DT<float>  BinaryModelReader::readSparse(size_t rows, size_t cols);
+
+    void BinaryModelReader::require(const size_t bytes) const {
+        if ( bytes > size_ - offset_ )
+            throw std::runtime_error("Binary model file is truncated.");
+    }
+
+    void BinaryModelReader::read(void * data, const size_t bytes) {
+        require(bytes);
+        if ( !file_.read(static_cast<char *>(data), bytes) )
+            throw std::runtime_error("Could not read binary model file.");
+        offset_ += bytes;
+    }
+
+    void BinaryModelReader::skipPadding() {
+        const auto bytes = padded(offset_) - offset_;
+        require(bytes);
+        if ( !file_.ignore(bytes) )
+            throw std::runtime_error("Could not read binary model file.");
+        offset_ += bytes;
+    }
+
+    size_t BinaryModelReader::getS() const { return S; }
+    size_t BinaryModelReader::getA() const { return A; }
+    size_t BinaryModelReader::getO() const { return O; }
+    double BinaryModelReader::getDiscount() const { return discount_; }
+    size_t BinaryModelReader::getScalarSize() const { return scalarSize_; }
+
+    BinaryModelMapping::BinaryModelMapping(const std::string & filename, const BinaryModelKind kind) :
+            data_(mapFile(filename, size_)), offset_(HeaderSize)
+    {
+        const auto h = parseHeader(data_.get(), size_ - offset_, kind, filename);
+        scalarSize_ = h.scalarSize;
+        S = h.S;
+        A = h.A;
+        O = h.O;
+        discount_ = h.discount;
+    }
+
+    template <typename Scalar>
+    Eigen::Map<const SparseMatrix2DT<Scalar>> BinaryModelMapping::mapSparse(const size_t rows, const size_t cols) {
+        if ( rows > INT_MAX || cols > INT_MAX )
+            throw std::runtime_error("Binary model file contains a sparse matrix too large to be indexed.");
+
+        require(sizeof(std::uint64_t));
+        const auto nnz = get<std::uint64_t>(data_.get(), offset_);
+        offset_ += sizeof(std::uint64_t);
+
+        // Each non-zero takes at least one byte, so this check keeps all
+        // the products below from overflowing.
+        if ( nnz > INT_MAX || nnz > size_ - offset_ )
+            throw std::runtime_error("Binary model file is truncated.");
+
+        const auto outerBytes = (rows + 1) * sizeof(Index);
+        const auto innerBytes = nnz * sizeof(Index);
+        const auto valueBytes = nnz * sizeof(Scalar);
+        require(padded(outerBytes) + padded(innerBytes) + padded(valueBytes));
+
+        // The writer aligns every array to 8 bytes from the start of the
+        // file, and the mapping itself is page aligned.
+        const auto o = reinterpret_cast<const Index *>(data_.get() + offset_);
+        offset_ += padded(outerBytes);
+        const auto i = reinterpret_cast<const Index *>(data_.get() + offset_);
+        offset_ += padded(innerBytes);
+        const auto v = reinterpret_cast<const Scalar *>(data_.get() + offset_);
+        offset_ += padded(valueBytes);
+
+        checkSparse(o, i, rows, cols, nnz);
+        return Eigen::Map<const SparseMatrix2DT<Scalar>>(rows, cols, nnz, o, i, v);
+    }
+
+    template Eigen::Map<const SparseMatrix2DT<double>> BinaryModelMapping::mapSparse(size_t rows, size_t cols);
+    template Eigen::Map<const SparseMatrix2DT<float>>  BinaryModelMapping::mapSparse(size_t rows, size_t cols);
+
+    void BinaryModelMapping::require(const size_t bytes) const {
+        if ( bytes > size_ - offset_ )
+            throw std::runtime_error("Binary model file is truncated.");
+    }
+
+    size_t BinaryModelMapping::getS() const { return S; }
+    size_t BinaryModelMapping::getA() const { return A; }
+    size_t BinaryModelMapping::getO() const { return O; }
+    double BinaryModelMapping::getDiscount() const { return discount_; }
+    size_t BinaryModelMapping::getScalarSize() const { return scalarSize_; }
+}
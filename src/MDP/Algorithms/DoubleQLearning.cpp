@@ -4,24 +4,29 @@ namespace AIToolbox::MDP {
     DoubleQLearning::DoubleQLearning(const size_t ss, const size_t aa, const double discount, const double alpha) :
             S(ss), A(aa), discount_(discount), dist_(0.5),
             qa_(makeQFunction(S, A)),
-            qc_(makeQFunction(S, A))
+            qc_(makeQFunction(S, A)),
+            version_(0)
     {
         setDiscount(discount);
         setLearningRate(alpha);
     }
 
-    void DoubleQLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+    double DoubleQLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
         size_t a1;
+        double error;
 
         if (dist_(rand_)) {
             qa_.row(s1).maxCoeff(&a1);
-            const double change = alpha_ * ( rew + discount_ * (qc_(s1, a1) - qa_(s1, a1)) - qa_(s, a) );
-            qa_(s, a) += change;
-            qc_(s, a) += change;
+            error = rew + discount_ * (qc_(s1, a1) - qa_(s1, a1)) - qa_(s, a);
+            qa_(s, a) += alpha_ * error;
+            qc_(s, a) += alpha_ * error;
         } else {
             (qc_.row(s1) - qa_.row(s1)).maxCoeff(&a1);
-            qc_(s, a) += alpha_ * ( rew + discount_ * qa_(s1, a1) - (qc_(s, a) - qa_(s, a)) );
+            error = rew + discount_ * qa_(s1, a1) - (qc_(s, a) - qa_(s, a));
+            qc_(s, a) += alpha_ * error;
         }
+        ++version_;
+        return error;
     }
 
     void DoubleQLearning::setLearningRate(const double a) {
@@ -42,6 +47,7 @@ namespace AIToolbox::MDP {
     size_t DoubleQLearning::getA() const { return A; }
 
     const QFunction & DoubleQLearning::getQFunction() const { return qc_; }
+    const size_t & DoubleQLearning::getQFunctionVersion() const { return version_; }
     const QFunction & DoubleQLearning::getQFunctionA() const { return qa_; }
     QFunction DoubleQLearning::getQFunctionB() const { return qc_ - qa_; }
     void DoubleQLearning::setQFunction(const QFunction & qfun) {
@@ -49,5 +55,6 @@ namespace AIToolbox::MDP {
         assert(qc_.cols() == qfun.cols());
         qa_ = qfun;
         qc_ = qfun * 2;
+        ++version_;
     }
 }
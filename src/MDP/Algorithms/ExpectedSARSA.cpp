@@ -2,18 +2,20 @@
 
 namespace AIToolbox::MDP {
     ExpectedSARSA::ExpectedSARSA(QFunction & qfun, const PolicyInterface & policy, const double discount, const double alpha) :
-            policy_(policy), S(policy_.getS()), A(policy_.getA()), q_(qfun)
+            policy_(policy), S(policy_.getS()), A(policy_.getA()), q_(qfun), version_(0), probs_(A)
     {
         setDiscount(discount);
         setLearningRate(alpha);
     }
 
-    void ExpectedSARSA::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
-        double expectedQ = 0.0;
-        for (size_t ai = 0; ai < A; ++ai)
-            expectedQ += policy_.getActionProbability(s1, ai) * q_(s1, ai);
+    double ExpectedSARSA::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+        policy_.getActionProbabilities(s1, probs_);
+        const double expectedQ = q_.row(s1).dot(probs_);
 
-        q_(s, a) += alpha_ * ( rew + discount_ * expectedQ - q_(s, a) );
+        const auto error = rew + discount_ * expectedQ - q_(s, a);
+        q_(s, a) += alpha_ * error;
+        ++version_;
+        return error;
     }
 
     void ExpectedSARSA::setLearningRate(const double a) {
@@ -34,5 +36,6 @@ namespace AIToolbox::MDP {
     size_t ExpectedSARSA::getA() const { return A; }
 
     const QFunction & ExpectedSARSA::getQFunction() const { return q_; }
+    const size_t & ExpectedSARSA::getQFunctionVersion() const { return version_; }
     const PolicyInterface & ExpectedSARSA::getPolicy() const { return policy_; }
 }
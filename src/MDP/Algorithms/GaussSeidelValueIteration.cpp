@@ -0,0 +1,36 @@
+#include <AIToolbox/MDP/Algorithms/GaussSeidelValueIteration.hpp>
+
+namespace AIToolbox::MDP {
+    GaussSeidelValueIteration::GaussSeidelValueIteration(const unsigned horizon, const double tolerance, ValueFunction v, const bool prioritized) :
+            horizon_(horizon), vParameter_(std::move(v)), prioritized_(prioritized), sweeps_(0)
+    {
+        setTolerance(tolerance);
+    }
+
+    void GaussSeidelValueIteration::setTolerance(const double t) {
+        if ( t < 0.0 ) throw std::invalid_argument("Tolerance must be >= 0");
+        tolerance_ = t;
+    }
+
+    void GaussSeidelValueIteration::setHorizon(const unsigned h) {
+        horizon_ = h;
+    }
+
+    void GaussSeidelValueIteration::setValueFunction(ValueFunction v) {
+        vParameter_ = std::move(v);
+    }
+
+    void GaussSeidelValueIteration::setPrioritized(const bool prioritized) {
+        prioritized_ = prioritized;
+    }
+
+    double GaussSeidelValueIteration::getTolerance() const { return tolerance_; }
+
+    unsigned GaussSeidelValueIteration::getHorizon() const { return horizon_; }
+
+    const ValueFunction & GaussSeidelValueIteration::getValueFunction() const { return vParameter_; }
+
+    bool GaussSeidelValueIteration::isPrioritized() const { return prioritized_; }
+
+    unsigned GaussSeidelValueIteration::getSweeps() const { return sweeps_; }
+}
@@ -2,19 +2,21 @@
 
 namespace AIToolbox::MDP {
     HystereticQLearning::HystereticQLearning(const size_t ss, const size_t aa, const double discount, const double alpha, const double beta) :
-            S(ss), A(aa), discount_(discount), q_(makeQFunction(S, A))
+            S(ss), A(aa), discount_(discount), q_(makeQFunction(S, A)), version_(0)
     {
         setDiscount(discount);
         setPositiveLearningRate(alpha);
         setNegativeLearningRate(beta);
     }
 
-    void HystereticQLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+    double HystereticQLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
         const auto delta = rew + discount_ * q_.row(s1).maxCoeff() - q_(s, a);
         if (delta >= 0)
             q_(s, a) += alpha_ * delta;
         else
             q_(s, a) += beta_ * delta;
+        ++version_;
+        return delta;
     }
 
     void HystereticQLearning::setPositiveLearningRate(const double a) {
@@ -42,4 +44,5 @@ namespace AIToolbox::MDP {
     size_t HystereticQLearning::getA() const { return A; }
 
     const QFunction & HystereticQLearning::getQFunction() const { return q_; }
+    const size_t & HystereticQLearning::getQFunctionVersion() const { return version_; }
 }
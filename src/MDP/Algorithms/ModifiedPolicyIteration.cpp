@@ -0,0 +1,46 @@
+#include <AIToolbox/MDP/Algorithms/ModifiedPolicyIteration.hpp>
+
+namespace AIToolbox::MDP {
+    ModifiedPolicyIteration::ModifiedPolicyIteration(const unsigned horizon, const double tolerance, const unsigned sweeps, const bool actionElimination, ValueFunction v) :
+            horizon_(horizon), sweeps_(sweeps), actionElimination_(actionElimination),
+            vParameter_(std::move(v)), iterations_(0), eliminated_(0), backups_(0)
+    {
+        setTolerance(tolerance);
+    }
+
+    void ModifiedPolicyIteration::setTolerance(const double t) {
+        if ( t < 0.0 ) throw std::invalid_argument("Tolerance must be >= 0");
+        tolerance_ = t;
+    }
+
+    void ModifiedPolicyIteration::setHorizon(const unsigned h) {
+        horizon_ = h;
+    }
+
+    void ModifiedPolicyIteration::setEvaluationSweeps(const unsigned sweeps) {
+        sweeps_ = sweeps;
+    }
+
+    void ModifiedPolicyIteration::setActionElimination(const bool actionElimination) {
+        actionElimination_ = actionElimination;
+    }
+
+    void ModifiedPolicyIteration::setValueFunction(ValueFunction v) {
+        vParameter_ = std::move(v);
+    }
+
+    double ModifiedPolicyIteration::getTolerance() const { return tolerance_; }
+
+    unsigned ModifiedPolicyIteration::getHorizon() const { return horizon_; }
+
+    unsigned ModifiedPolicyIteration::getEvaluationSweeps() const { return sweeps_; }
+
+    bool ModifiedPolicyIteration::getActionElimination() const { return actionElimination_; }
+
+    const ValueFunction & ModifiedPolicyIteration::getValueFunction() const { return vParameter_; }
+
+    unsigned ModifiedPolicyIteration::getIterations() const { return iterations_; }
+
+    size_t ModifiedPolicyIteration::getEliminatedActions() const { return eliminated_; }
+    size_t ModifiedPolicyIteration::getBackups() const { return backups_; }
+}
@@ -1,8 +1,8 @@
 #include <AIToolbox/MDP/Algorithms/PolicyIteration.hpp>
 
 namespace AIToolbox::MDP {
-    PolicyIteration::PolicyIteration(const unsigned horizon, const double tolerance) :
-            horizon_(horizon)
+    PolicyIteration::PolicyIteration(const unsigned horizon, const double tolerance, const bool linearSolve) :
+            horizon_(horizon), linearSolve_(linearSolve)
     {
         setTolerance(tolerance);
     }
@@ -16,7 +16,13 @@ namespace AIToolbox::MDP {
         horizon_ = h;
     }
 
+    void PolicyIteration::setLinearSolve(const bool l) {
+        linearSolve_ = l;
+    }
+
     double PolicyIteration::getTolerance()   const { return tolerance_; }
 
     unsigned PolicyIteration::getHorizon() const { return horizon_; }
+
+    bool PolicyIteration::getLinearSolve() const { return linearSolve_; }
 }
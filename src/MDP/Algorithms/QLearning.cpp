@@ -2,14 +2,17 @@
 
 namespace AIToolbox::MDP {
     QLearning::QLearning(const size_t ss, const size_t aa, const double discount, const double alpha) :
-            S(ss), A(aa), discount_(discount), q_(makeQFunction(S, A))
+            S(ss), A(aa), discount_(discount), q_(makeQFunction(S, A)), version_(0)
     {
         setDiscount(discount);
         setLearningRate(alpha);
     }
 
-    void QLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
-        q_(s, a) += alpha_ * ( rew + discount_ * q_.row(s1).maxCoeff() - q_(s, a) );
+    double QLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+        const auto error = rew + discount_ * q_.row(s1).maxCoeff() - q_(s, a);
+        q_(s, a) += alpha_ * error;
+        ++version_;
+        return error;
     }
 
     void QLearning::setLearningRate(const double a) {
@@ -30,9 +33,11 @@ namespace AIToolbox::MDP {
     size_t QLearning::getA() const { return A; }
 
     const QFunction & QLearning::getQFunction() const { return q_; }
+    const size_t & QLearning::getQFunctionVersion() const { return version_; }
     void QLearning::setQFunction(const QFunction & qfun) { 
         assert(q_.rows() == qfun.rows());
         assert(q_.cols() == qfun.cols());
         q_ = qfun;
+        ++version_;
     }
 }
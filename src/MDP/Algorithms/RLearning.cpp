@@ -4,19 +4,23 @@
 
 namespace AIToolbox::MDP {
     RLearning::RLearning(const size_t ss, const size_t aa, const double alpha, const double rho) :
-            S(ss), A(aa), rAvg_(0.0), q_(makeQFunction(S, A))
+            S(ss), A(aa), rAvg_(0.0), q_(makeQFunction(S, A)), version_(0)
     {
         setAlphaLearningRate(alpha);
         setRhoLearningRate(rho);
     }
 
-    void RLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
+    double RLearning::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const double rew) {
         const double futureBestValue = q_.row(s1).maxCoeff();
-        q_(s, a) += alpha_ * ( rew - rAvg_ + futureBestValue );
+        const double error = rew - rAvg_ + futureBestValue - q_(s, a);
+        q_(s, a) += alpha_ * error;
 
         const double currBestValue = q_.row(s).maxCoeff();
         if (checkEqualGeneral(q_(s, a), currBestValue))
-            rAvg_ += rho_ * ( rew + futureBestValue - currBestValue );
+            rAvg_ += rho_ * ( rew - rAvg_ + futureBestValue - currBestValue );
+
+        ++version_;
+        return error;
     }
 
     void RLearning::setAlphaLearningRate(const double a) {
@@ -37,12 +41,14 @@ namespace AIToolbox::MDP {
     size_t RLearning::getA() const { return A; }
 
     const QFunction & RLearning::getQFunction() const { return q_; }
+    const size_t & RLearning::getQFunctionVersion() const { return version_; }
     double RLearning::getAverageReward() const { return rAvg_; }
 
     void RLearning::setQFunction(const QFunction & qfun) {
         assert(q_.rows() == qfun.rows());
         assert(q_.cols() == qfun.cols());
         q_ = qfun;
+        ++version_;
     }
 }
 
@@ -2,14 +2,17 @@
 
 namespace AIToolbox::MDP {
     SARSA::SARSA(const size_t ss, const size_t aa, const double discount, const double alpha) :
-            S(ss), A(aa), q_(makeQFunction(S, A))
+            S(ss), A(aa), q_(makeQFunction(S, A)), version_(0)
     {
         setDiscount(discount);
         setLearningRate(alpha);
     }
 
-    void SARSA::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const size_t a1, const double rew) {
-        q_(s, a) += alpha_ * ( rew + discount_ * q_(s1, a1) - q_(s, a) );
+    double SARSA::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const size_t a1, const double rew) {
+        const auto error = rew + discount_ * q_(s1, a1) - q_(s, a);
+        q_(s, a) += alpha_ * error;
+        ++version_;
+        return error;
     }
 
     void SARSA::setLearningRate(const double a) {
@@ -30,4 +33,5 @@ namespace AIToolbox::MDP {
     size_t SARSA::getA() const { return A; }
 
     const QFunction & SARSA::getQFunction() const { return q_; }
+    const size_t & SARSA::getQFunctionVersion() const { return version_; }
 }
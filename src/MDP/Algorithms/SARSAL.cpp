@@ -2,7 +2,7 @@
 
 namespace AIToolbox::MDP {
     SARSAL::SARSAL(const size_t ss, const size_t aa, const double discount, const double alpha, const double lambda, const double tolerance) :
-            S(ss), A(aa), q_(makeQFunction(S, A))
+            S(ss), A(aa), q_(makeQFunction(S, A)), version_(0), traces_(A)
     {
         setDiscount(discount);
         setLearningRate(alpha);
@@ -12,51 +12,20 @@ namespace AIToolbox::MDP {
 
     void SARSAL::stepUpdateQ(const size_t s, const size_t a, const size_t s1, const size_t a1, const double rew) {
         const auto error = alpha_ * ( rew + discount_ * q_(s1, a1) - q_(s, a) );
-        bool newTrace = true;
-
-        // So basically here we have in traces_ a non-ordered list of the old
-        // state/action pairs we have already seen. For each item in this list,
-        // we scale its "relevantness" back by gammaL_, and we update its
-        // q-value accordingly.
-        //
-        // If the current s-a are in the list already, their eligibility is
-        // directly updated to 1.0. Otherwise, they are added to the list.
-        //
-        // If any element would become too far away temporally to still be
-        // relevant, we extract it from the list. As the order is not important
-        // (it is implicit in the "el" element), we can use swap+pop.
-        for (size_t i = 0; i < traces_.size(); ++i) {
-            auto & [ss, aa, el] = traces_[i];
-            if (ss == s && aa == a) {
-                el = 1.0;
-                newTrace = false;
-            } else {
-                el *= gammaL_;
-                if (el < tolerance_) {
-                    std::swap(traces_[i], traces_[traces_.size() - 1]);
-                    traces_.pop_back();
-                    --i;
-                    continue;
-                }
-            }
-            q_(ss, aa) += error * el;
-        }
-        if (newTrace) {
-            traces_.emplace_back(s, a, 1.0);
-            q_(s, a) += error; // el is 1.0 here
-        }
+        traces_.update(q_, s, a, error, gammaL_, tolerance_);
+        ++version_;
     }
 
     void SARSAL::clearTraces() {
         traces_.clear();
     }
 
-    const SARSAL::Traces & SARSAL::getTraces() const {
-        return traces_;
+    SARSAL::Traces SARSAL::getTraces() const {
+        return traces_.getTraces();
     }
 
     void SARSAL::setTraces(const Traces & t) {
-        traces_ = t;
+        traces_.setTraces(t);
     }
 
     void SARSAL::setLearningRate(const double a) {
@@ -97,9 +66,11 @@ namespace AIToolbox::MDP {
     size_t SARSAL::getA() const { return A; }
 
     const QFunction & SARSAL::getQFunction() const { return q_; }
+    const size_t & SARSAL::getQFunctionVersion() const { return version_; }
     void SARSAL::setQFunction(const QFunction & qfun) { 
         assert(q_.rows() == qfun.rows());
         assert(q_.cols() == qfun.cols());
         q_ = qfun; 
+        ++version_;
     }
 }
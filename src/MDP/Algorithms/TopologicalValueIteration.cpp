@@ -0,0 +1,105 @@
+#include <AIToolbox/MDP/Algorithms/TopologicalValueIteration.hpp>
+
+#include <limits>
+
+namespace AIToolbox::MDP {
+    TopologicalValueIteration::TopologicalValueIteration(const unsigned horizon, const double tolerance, ValueFunction v) :
+            horizon_(horizon), vParameter_(std::move(v))
+    {
+        setTolerance(tolerance);
+    }
+
+    void TopologicalValueIteration::decompose(const std::vector<std::vector<size_t>> & graph) {
+        constexpr auto unvisited = std::numeric_limits<size_t>::max();
+        const size_t S = graph.size();
+
+        components_.clear();
+        cyclic_.assign(S, false);
+
+        std::vector<size_t> index(S, unvisited), lowlink(S);
+        std::vector<bool> onStack(S, false);
+        std::vector<size_t> stack;
+        // Each frame holds a node and the next successor to visit.
+        std::vector<std::pair<size_t, size_t>> frames;
+
+        size_t counter = 0;
+        const auto visit = [&](const size_t v) {
+            index[v] = lowlink[v] = counter++;
+            stack.push_back(v);
+            onStack[v] = true;
+            frames.emplace_back(v, 0);
+        };
+
+        for ( size_t root = 0; root < S; ++root ) {
+            if ( index[root] != unvisited ) continue;
+
+            visit(root);
+            while ( !frames.empty() ) {
+                const auto v = frames.back().first;
+                auto & next = frames.back().second;
+
+                if ( next < graph[v].size() ) {
+                    const auto w = graph[v][next++];
+                    if ( index[w] == unvisited )
+                        visit(w);
+                    else if ( onStack[w] )
+                        lowlink[v] = std::min(lowlink[v], index[w]);
+                    continue;
+                }
+
+                // All successors visited, check whether v is a root.
+                if ( lowlink[v] == index[v] ) {
+                    std::vector<size_t> component;
+                    size_t w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[w] = false;
+                        component.push_back(w);
+                    } while ( w != v );
+
+                    const bool cyclic = component.size() > 1 ||
+                        std::binary_search(std::begin(graph[v]), std::end(graph[v]), v);
+                    for ( const auto s : component )
+                        cyclic_[s] = cyclic;
+
+                    components_.emplace_back(std::move(component));
+                }
+
+                frames.pop_back();
+                if ( !frames.empty() ) {
+                    const auto parent = frames.back().first;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[v]);
+                }
+            }
+        }
+    }
+
+    void TopologicalValueIteration::clearComponents() {
+        components_.clear();
+        cyclic_.clear();
+    }
+
+    void TopologicalValueIteration::setTolerance(const double t) {
+        if ( t < 0.0 ) throw std::invalid_argument("Tolerance must be >= 0");
+        tolerance_ = t;
+    }
+
+    void TopologicalValueIteration::setHorizon(const unsigned h) {
+        horizon_ = h;
+    }
+
+    void TopologicalValueIteration::setValueFunction(ValueFunction v) {
+        vParameter_ = std::move(v);
+    }
+
+    double TopologicalValueIteration::getTolerance() const { return tolerance_; }
+
+    unsigned TopologicalValueIteration::getHorizon() const { return horizon_; }
+
+    const ValueFunction & TopologicalValueIteration::getValueFunction() const { return vParameter_; }
+
+    const std::vector<std::vector<size_t>> & TopologicalValueIteration::getComponents() const { return components_; }
+
+    const std::vector<unsigned> & TopologicalValueIteration::getComponentIterations() const { return iterations_; }
+}
@@ -0,0 +1,64 @@
+#include <AIToolbox/MDP/Algorithms/Utils/EligibilityTraces.hpp>
+
+namespace AIToolbox::MDP {
+    EligibilityTraces::EligibilityTraces(const size_t a) : A(a), scale_(1.0) {}
+
+    void EligibilityTraces::update(QFunction & q, const size_t s, const size_t a, const double error, const double traceDiscount, const double tolerance) {
+        double * qd = q.data();
+        update(s, a, traceDiscount, tolerance, [qd, error](const size_t id, const double el) {
+            qd[id] += error * el;
+        });
+    }
+
+    void EligibilityTraces::renormalize() {
+        for (auto & el : traces_)
+            el *= scale_;
+        scale_ = 1.0;
+    }
+
+    void EligibilityTraces::remove(const size_t i) {
+        index_.erase(ids_[i]);
+
+        const size_t last = ids_.size() - 1;
+        if (i != last) {
+            ids_[i] = ids_[last];
+            traces_[i] = traces_[last];
+            index_[ids_[i]] = i;
+        }
+        ids_.pop_back();
+        traces_.pop_back();
+    }
+
+    void EligibilityTraces::clear() {
+        ids_.clear();
+        traces_.clear();
+        index_.clear();
+        scale_ = 1.0;
+    }
+
+    size_t EligibilityTraces::size() const {
+        return ids_.size();
+    }
+
+    EligibilityTraces::Traces EligibilityTraces::getTraces() const {
+        Traces retval;
+        retval.reserve(ids_.size());
+        for (size_t i = 0; i < ids_.size(); ++i)
+            retval.emplace_back(ids_[i] / A, ids_[i] % A, traces_[i] * scale_);
+        return retval;
+    }
+
+    void EligibilityTraces::setTraces(const Traces & t) {
+        clear();
+        for (const auto & [s, a, el] : t) {
+            const size_t id = s * A + a;
+            if (const auto it = index_.find(id); it != index_.end()) {
+                traces_[it->second] = el;
+            } else {
+                index_.emplace(id, ids_.size());
+                ids_.push_back(id);
+                traces_.push_back(el);
+            }
+        }
+    }
+}
@@ -4,7 +4,7 @@
 
 namespace AIToolbox::MDP {
     OffPolicyBase::OffPolicyBase(const size_t s, const size_t a, const double discount, const double alpha, const double tolerance) :
-            S(s), A(a), q_(makeQFunction(S, A))
+            S(s), A(a), q_(makeQFunction(S, A)), version_(0), traces_(A)
     {
         setDiscount(discount);
         setLearningRate(alpha);
@@ -12,50 +12,20 @@ namespace AIToolbox::MDP {
     }
 
     void OffPolicyBase::updateTraces(const size_t s, const size_t a, const double error, const double traceDiscount) {
-        // So basically here we have in traces_ a non-ordered list of the old
-        // state/action pairs we have already seen. For each item in this list,
-        // we scale its "relevantness" back by gammaL_, and we update its
-        // q-value accordingly.
-        //
-        // If the current s-a are in the list already, their eligibility is
-        // directly updated to 1.0. Otherwise, they are added to the list.
-        //
-        // If any element would become too far away temporally to still be
-        // relevant, we extract it from the list. As the order is not important
-        // (it is implicit in the "el" element), we can use swap+pop.
-        bool newTrace = true;
-        for (size_t i = 0; i < traces_.size(); ++i) {
-            auto & [ss, aa, el] = traces_[i];
-            if (ss == s && aa == a) {
-                el = 1.0;
-                newTrace = false;
-            } else {
-                el *= traceDiscount;
-                if (el < tolerance_) {
-                    std::swap(traces_[i], traces_[traces_.size() - 1]);
-                    traces_.pop_back();
-                    --i;
-                    continue;
-                }
-            }
-            q_(ss, aa) += error * el;
-        }
-        if (newTrace) {
-            traces_.emplace_back(s, a, 1.0);
-            q_(s, a) += error; // el is 1.0 here
-        }
+        traces_.update(q_, s, a, error, traceDiscount, tolerance_);
+        ++version_;
     }
 
     void OffPolicyBase::clearTraces() {
         traces_.clear();
     }
 
-    const OffPolicyBase::Traces & OffPolicyBase::getTraces() const {
-        return traces_;
+    OffPolicyBase::Traces OffPolicyBase::getTraces() const {
+        return traces_.getTraces();
     }
 
     void OffPolicyBase::setTraces(const Traces & t) {
-        traces_ = t;
+        traces_.setTraces(t);
     }
 
     void OffPolicyBase::setLearningRate(const double a) {
@@ -84,5 +54,9 @@ namespace AIToolbox::MDP {
     size_t OffPolicyBase::getA() const { return A; }
 
     const QFunction & OffPolicyBase::getQFunction() const { return q_; }
-    void OffPolicyBase::setQFunction(const QFunction & qfun) { q_ = qfun; }
+    const size_t & OffPolicyBase::getQFunctionVersion() const { return version_; }
+    void OffPolicyBase::setQFunction(const QFunction & qfun) {
+        q_ = qfun;
+        ++version_;
+    }
 }
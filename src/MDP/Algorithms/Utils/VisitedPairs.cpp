@@ -0,0 +1,59 @@
+#include <AIToolbox/MDP/Algorithms/Utils/VisitedPairs.hpp>
+
+namespace AIToolbox::MDP {
+    DenseVisitedPairs::DenseVisitedPairs(const size_t S, const size_t a) :
+            A(a), bits_((S * A + 63) / 64, 0) {}
+
+    bool DenseVisitedPairs::insert(const size_t s, const size_t a) {
+        const size_t id = s * A + a;
+        auto & word = bits_[id / 64];
+        const std::uint64_t mask = std::uint64_t(1) << (id % 64);
+
+        if ( word & mask ) return false;
+
+        word |= mask;
+        pairs_.push_back(id);
+        return true;
+    }
+
+    bool DenseVisitedPairs::contains(const size_t s, const size_t a) const {
+        const size_t id = s * A + a;
+        return bits_[id / 64] & (std::uint64_t(1) << (id % 64));
+    }
+
+    size_t DenseVisitedPairs::size() const { return pairs_.size(); }
+
+    std::pair<size_t, size_t> DenseVisitedPairs::operator[](const size_t i) const {
+        return {pairs_[i] / A, pairs_[i] % A};
+    }
+
+    PagedVisitedPairs::PagedVisitedPairs(size_t, const size_t a) : A(a) {}
+
+    bool PagedVisitedPairs::insert(const size_t s, const size_t a) {
+        const size_t id = s * A + a;
+        // A new page is value-initialized to all zeroes.
+        auto & word = pages_[id / PageBits][(id % PageBits) / 64];
+        const std::uint64_t mask = std::uint64_t(1) << (id % 64);
+
+        if ( word & mask ) return false;
+
+        word |= mask;
+        pairs_.push_back(id);
+        return true;
+    }
+
+    bool PagedVisitedPairs::contains(const size_t s, const size_t a) const {
+        const size_t id = s * A + a;
+        const auto it = pages_.find(id / PageBits);
+        if ( it == pages_.end() ) return false;
+        return it->second[(id % PageBits) / 64] & (std::uint64_t(1) << (id % 64));
+    }
+
+    size_t PagedVisitedPairs::size() const { return pairs_.size(); }
+
+    std::pair<size_t, size_t> PagedVisitedPairs::operator[](const size_t i) const {
+        return {pairs_[i] / A, pairs_[i] % A};
+    }
+
+    size_t PagedVisitedPairs::getPages() const { return pages_.size(); }
+}
@@ -1,8 +1,8 @@
 #include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
 
 namespace AIToolbox::MDP {
-    ValueIteration::ValueIteration(unsigned horizon, double tolerance, ValueFunction v) :
-            horizon_(horizon), vParameter_(v)
+    ValueIteration::ValueIteration(unsigned horizon, double tolerance, ValueFunction v, unsigned threads) :
+            horizon_(horizon), vParameter_(v), threads_(threads)
     {
         setTolerance(tolerance);
     }
@@ -20,9 +20,15 @@ namespace AIToolbox::MDP {
         vParameter_ = std::move(v);
     }
 
+    void ValueIteration::setThreads(const unsigned threads) {
+        threads_ = threads;
+    }
+
     double ValueIteration::getTolerance()   const { return tolerance_; }
 
     unsigned ValueIteration::getHorizon() const { return horizon_; }
 
     const ValueFunction & ValueIteration::getValueFunction() const { return vParameter_; }
+
+    unsigned ValueIteration::getThreads() const { return threads_; }
 }
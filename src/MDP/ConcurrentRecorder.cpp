@@ -0,0 +1,63 @@
+#include <AIToolbox/MDP/ConcurrentRecorder.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace AIToolbox::MDP {
+    ConcurrentRecorder::ConcurrentRecorder(Experience & exp, const size_t stripes) :
+            exp_(exp), stripes_(stripes), timesteps_(0)
+    {
+        if ( stripes == 0 ) throw std::invalid_argument("Number of stripes must be > 0");
+    }
+
+    ConcurrentRecorder::~ConcurrentRecorder() {
+        flush();
+    }
+
+    void ConcurrentRecorder::record(const size_t s, const size_t a, const size_t s1, const double rew) {
+        // All records up to the next flush() share the version the
+        // Experience takes on it, as with Experience::recordBatch().
+        const auto version = exp_.version_ + 1;
+        timesteps_.fetch_add(1, std::memory_order_relaxed);
+
+        auto & stripe = stripes_[(s * exp_.A + a) % stripes_.size()];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+
+        // Same as Experience::record, minus the timesteps.
+        exp_.visits_[a](s, s1) += 1;
+        exp_.visitsSum_(s, a) += 1;
+
+        const auto delta = rew - exp_.rewards_(s, a);
+        exp_.rewards_(s, a) += delta / exp_.visitsSum_(s, a);
+        exp_.M2s_(s, a) += delta * (rew - exp_.rewards_(s, a));
+
+        // The shared dirty log can't be touched here, so each stripe
+        // keeps its own list until flush(). Pairs belong to a single
+        // stripe, so their version is safe to update under its lock.
+        auto & pairVersion = exp_.pairVersions_(s, a);
+        if ( pairVersion != version ) {
+            stripe.dirty.emplace_back(s, a);
+            pairVersion = version;
+        }
+    }
+
+    void ConcurrentRecorder::flush() {
+        const auto version = exp_.version_ + 1;
+        const auto current = [this](size_t s, size_t a) { return exp_.pairVersions_(s, a); };
+
+        bool modified = false;
+        for ( auto & stripe : stripes_ ) {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            for ( const auto & [s, a] : stripe.dirty )
+                exp_.dirty_.add(s, a, version, exp_.S * exp_.A, current);
+            modified = modified || !stripe.dirty.empty();
+            stripe.dirty.clear();
+        }
+        exp_.timesteps_ += timesteps_.exchange(0);
+        if ( modified )
+            exp_.version_ = version;
+    }
+
+    size_t ConcurrentRecorder::getStripes() const { return stripes_.size(); }
+    const Experience & ConcurrentRecorder::getExperience() const { return exp_; }
+}
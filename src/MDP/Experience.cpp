@@ -1,10 +1,14 @@
 #include <AIToolbox/MDP/Experience.hpp>
 
+#include <AIToolbox/Impl/ExperienceBatch.hpp>
+
 #include <algorithm>
+#include <stdexcept>
 
 namespace AIToolbox::MDP {
     Experience::Experience(const size_t s, const size_t a) :
-            S(s), A(a), visits_(A, Table2D(S, S)), visitsSum_(S, A), rewards_(S, A), M2s_(S, A), timesteps_(0)
+            S(s), A(a), visits_(A, Table2D(S, S)), visitsSum_(S, A), rewards_(S, A), M2s_(S, A), timesteps_(0),
+            version_(0), resetVersion_(0), pairVersions_(S, A)
     {
         reset();
     }
@@ -21,6 +25,44 @@ namespace AIToolbox::MDP {
         rewards_(s, a) += delta / visitsSum_(s, a);
         // Rolling sum of square diffs.
         M2s_(s, a) += delta * (rew - rewards_(s, a));
+
+        markDirty(s, a, ++version_);
+    }
+
+    void Experience::recordBatch(const size_t n, const size_t * s, const size_t * a, const size_t * s1, const double * rew) {
+        const auto version = ++version_;
+
+        Impl::groupBatch(n, s, a, s1, rew,
+            [this](size_t ss, size_t aa, size_t ss1, unsigned long visits) {
+                visits_[aa](ss, ss1) += visits;
+            },
+            [this, version](size_t ss, size_t aa, unsigned long count, double mean, double m2) {
+                Impl::mergeWelford(visitsSum_(ss, aa), rewards_(ss, aa), M2s_(ss, aa), count, mean, m2);
+                markDirty(ss, aa, version);
+            }
+        );
+        timesteps_ += n;
+    }
+
+    void Experience::merge(const Experience & other) {
+        if ( other.S != S || other.A != A )
+            throw std::invalid_argument("Cannot merge Experiences with different sizes");
+
+        for ( size_t a = 0; a < A; ++a )
+            visits_[a] += other.visits_[a];
+
+        const auto version = ++version_;
+
+        for ( size_t s = 0; s < S; ++s ) {
+            for ( size_t a = 0; a < A; ++a ) {
+                const auto nB = other.visitsSum_(s, a);
+                if ( nB == 0 ) continue;
+
+                Impl::mergeWelford(visitsSum_(s, a), rewards_(s, a), M2s_(s, a), nB, other.rewards_(s, a), other.M2s_(s, a));
+                markDirty(s, a, version);
+            }
+        }
+        timesteps_ += other.timesteps_;
     }
 
     void Experience::reset() {
@@ -30,12 +72,45 @@ namespace AIToolbox::MDP {
         rewards_.setZero();
         M2s_.setZero();
         timesteps_ = 0;
+
+        pairVersions_.setZero();
+        markAllDirty();
     }
 
     unsigned long Experience::getTimesteps() const {
         return timesteps_;
     }
 
+    unsigned long Experience::getVersion() const {
+        return version_;
+    }
+
+    unsigned long Experience::getVersion(const size_t s, const size_t a) const {
+        return std::max(pairVersions_(s, a), resetVersion_);
+    }
+
+    unsigned long Experience::getEpoch() const {
+        return epoch_.get();
+    }
+
+    std::vector<std::pair<size_t, size_t>> Experience::getDirtyPairs(const unsigned long version) const {
+        return dirty_.since(version, [this](size_t s, size_t a) { return pairVersions_(s, a); });
+    }
+
+    void Experience::markDirty(const size_t s, const size_t a, const unsigned long version) {
+        auto & pairVersion = pairVersions_(s, a);
+        // A pair can only be modified once per version.
+        if ( pairVersion == version ) return;
+        pairVersion = version;
+        dirty_.add(s, a, version, S * A, [this](size_t ss, size_t aa) { return pairVersions_(ss, aa); });
+    }
+
+    void Experience::markAllDirty() {
+        resetVersion_ = ++version_;
+        epoch_.advance();
+        dirty_.clear();
+    }
+
     unsigned long Experience::getVisits(const size_t s, const size_t a, const size_t s1) const {
         return visits_[a](s, s1);
     }
@@ -7,6 +7,7 @@
 #include <AIToolbox/MDP/Policies/Policy.hpp>
 
 #include <AIToolbox/Impl/CassandraParser.hpp>
+#include <AIToolbox/Impl/BinaryModelFormat.hpp>
 #include <AIToolbox/Impl/Logging.hpp>
 
 #include <iostream>
@@ -66,6 +67,10 @@ namespace AIToolbox::MDP {
                 }
             }
         }
+        // The whole Experience changed, so we mark all pairs as modified.
+        e.version_ = exp.version_;
+        e.markAllDirty();
+
         // This guarantees that if input is invalid we still keep the old Exp.
         exp = std::move(e);
 
@@ -112,6 +117,10 @@ namespace AIToolbox::MDP {
                 }
             }
         }
+        // The whole Experience changed, so we mark all pairs as modified.
+        e.version_ = exp.version_;
+        e.markAllDirty();
+
         // This guarantees that if input is invalid we still keep the old Exp.
         exp = std::move(e);
 
@@ -146,18 +155,23 @@ namespace AIToolbox::MDP {
                     in.transitions_[a](s, s) = 1.0;
             }
         }
+        // Keep the caller's sampling index settings; this also builds the
+        // index over the new data if it is eager.
+        in.setSamplingIndex(m.useSamplingIndex_, m.eagerSamplingIndex_);
+
         // This guarantees that if input is invalid we still keep the old Model.
         m = std::move(in);
 
         return is;
     }
 
-    // MDP::SparseModel reader
-    std::istream& operator>>(std::istream &is, SparseModel & m) {
+    // MDP::SparseModelT reader
+    template <typename Scalar>
+    std::istream& operator>>(std::istream &is, SparseModelT<Scalar> & m) {
         const size_t S = m.getS();
         const size_t A = m.getA();
 
-        SparseModel in(S,A);
+        SparseModelT<Scalar> in(S,A);
         double p, r;
 
         for ( size_t s = 0; s < S; ++s ) {
@@ -185,12 +199,81 @@ namespace AIToolbox::MDP {
                     in.transitions_[a].coeffRef(s, s) = 1.0;
             }
         }
+        // Keep the caller's sampling index and stacking settings; this also
+        // builds them over the new data.
+        in.setSamplingIndex(m.useSamplingIndex_, m.eagerSamplingIndex_);
+        in.setStackedTransitions(m.useStackedTransitions_);
+
         // This guarantees that if input is invalid we still keep the old Model.
         m = std::move(in);
 
         return is;
     }
 
+    template std::istream& operator>>(std::istream &is, SparseModelT<double> & m);
+    template std::istream& operator>>(std::istream &is, SparseModelT<float> & m);
+
+    // MDP::Model binary writer
+    std::ostream& writeBinary(std::ostream &os, const Model & m) {
+        Impl::BinaryModelWriter writer(os, Impl::BinaryModelKind::MDPModel, m.getS(), m.getA(), 0, m.getDiscount());
+
+        for ( const auto & t : m.getTransitionFunction() )
+            writer.writeDense(t);
+        writer.writeDense(m.getRewardFunction());
+
+        return os;
+    }
+
+    // MDP::SparseModelT binary writer
+    template <typename Scalar>
+    std::ostream& writeBinary(std::ostream &os, const SparseModelT<Scalar> & m) {
+        Impl::BinaryModelWriter writer(os, Impl::BinaryModelKind::MDPSparseModel, m.getS(), m.getA(), 0, m.getDiscount(), sizeof(Scalar));
+
+        for ( const auto & t : m.getTransitionFunction() )
+            writer.writeSparse(t);
+        writer.writeSparse(m.getRewardFunction());
+
+        return os;
+    }
+
+    template std::ostream& writeBinary(std::ostream &os, const SparseModelT<double> & m);
+    template std::ostream& writeBinary(std::ostream &os, const SparseModelT<float> & m);
+
+    // MDP::Model binary reader
+    Model loadBinaryModel(const std::string & filename) {
+        Impl::BinaryModelReader reader(filename, Impl::BinaryModelKind::MDPModel);
+        const auto S = reader.getS(), A = reader.getA();
+
+        Model::TransitionMatrix t;
+        t.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            t.emplace_back(reader.readDense(S, S));
+        auto r = reader.readDense(S, A);
+
+        return Model(NO_CHECK, S, A, std::move(t), std::move(r), reader.getDiscount());
+    }
+
+    // MDP::SparseModelT binary reader
+    template <typename Scalar>
+    SparseModelT<Scalar> loadBinarySparseModel(const std::string & filename) {
+        Impl::BinaryModelReader reader(filename, Impl::BinaryModelKind::MDPSparseModel);
+        if ( reader.getScalarSize() != sizeof(Scalar) )
+            throw std::runtime_error("Binary model file " + filename + " stores a model with a different scalar type.");
+
+        const auto S = reader.getS(), A = reader.getA();
+
+        typename SparseModelT<Scalar>::TransitionMatrix t;
+        t.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            t.emplace_back(reader.readSparse<Scalar>(S, S));
+        auto r = reader.readSparse<double>(S, A);
+
+        return SparseModelT<Scalar>(NO_CHECK, S, A, std::move(t), std::move(r), reader.getDiscount());
+    }
+
+    template SparseModelT<double> loadBinarySparseModel(const std::string & filename);
+    template SparseModelT<float>  loadBinarySparseModel(const std::string & filename);
+
     // MDP::Policy reader
     std::istream& operator>>(std::istream &is, Policy &p) {
         const size_t S = p.getS();
@@ -0,0 +1,92 @@
+#include <AIToolbox/MDP/MappedSparseModel.hpp>
+
+#include <stdexcept>
+
+#include <AIToolbox/Impl/Seeder.hpp>
+#include <AIToolbox/Utils/Core.hpp>
+#include <AIToolbox/Utils/Probability.hpp>
+
+namespace AIToolbox::MDP {
+    namespace {
+        template <typename Scalar>
+        typename MappedSparseModelT<Scalar>::TransitionMatrix mapTransitions(Impl::BinaryModelMapping & mapping, const std::string & filename) {
+            if ( mapping.getScalarSize() != sizeof(Scalar) )
+                throw std::runtime_error("Binary model file " + filename + " stores a model with a different scalar type.");
+
+            const auto S = mapping.getS(), A = mapping.getA();
+
+            typename MappedSparseModelT<Scalar>::TransitionMatrix t;
+            t.reserve(A);
+            for ( size_t a = 0; a < A; ++a )
+                t.emplace_back(mapping.mapSparse<Scalar>(S, S));
+            return t;
+        }
+    }
+
+    template <typename Scalar>
+    MappedSparseModelT<Scalar>::MappedSparseModelT(const std::string & filename) :
+            mapping_(filename, Impl::BinaryModelKind::MDPSparseModel),
+            S(mapping_.getS()), A(mapping_.getA()), discount_(mapping_.getDiscount()),
+            transitions_(mapTransitions<Scalar>(mapping_, filename)),
+            rewards_(mapping_.mapSparse<double>(S, A)),
+            rand_(Impl::Seeder::getSeed()) {}
+
+    template <typename Scalar>
+    std::tuple<size_t, double> MappedSparseModelT<Scalar>::sampleSR(const size_t s, const size_t a) const {
+        return sampleSR(s, a, rand_);
+    }
+
+    template <typename Scalar>
+    std::tuple<size_t, double> MappedSparseModelT<Scalar>::sampleSR(const size_t s, const size_t a, RandomEngine & rnd) const {
+        double p = probabilityDistribution(rnd);
+
+        // If rounding leaves p above the total we keep the last non-zero.
+        size_t s1 = s;
+        for ( typename Eigen::Map<const SparseMatrix2DT<Scalar>>::InnerIterator it(transitions_[a], s); it; ++it ) {
+            s1 = it.col();
+            if ( it.value() > p ) break;
+            p -= it.value();
+        }
+
+        return std::make_tuple(s1, getExpectedReward(s, a, s1));
+    }
+
+    template <typename Scalar>
+    double MappedSparseModelT<Scalar>::getTransitionProbability(const size_t s, const size_t a, const size_t s1) const {
+        return transitions_[a].coeff(s, s1);
+    }
+
+    template <typename Scalar>
+    double MappedSparseModelT<Scalar>::getExpectedReward(const size_t s, const size_t a, const size_t) const {
+        return rewards_.coeff(s, a);
+    }
+
+    template <typename Scalar>
+    bool MappedSparseModelT<Scalar>::isTerminal(const size_t s) const {
+        for ( size_t a = 0; a < A; ++a )
+            if ( !checkEqualSmall(1.0, getTransitionProbability(s, a, s)) )
+                return false;
+        return true;
+    }
+
+    template <typename Scalar>
+    size_t MappedSparseModelT<Scalar>::getS() const { return S; }
+
+    template <typename Scalar>
+    size_t MappedSparseModelT<Scalar>::getA() const { return A; }
+
+    template <typename Scalar>
+    double MappedSparseModelT<Scalar>::getDiscount() const { return discount_; }
+
+    template <typename Scalar>
+    const typename MappedSparseModelT<Scalar>::TransitionMatrix & MappedSparseModelT<Scalar>::getTransitionFunction() const { return transitions_; }
+
+    template <typename Scalar>
+    const typename MappedSparseModelT<Scalar>::RewardMatrix & MappedSparseModelT<Scalar>::getRewardFunction() const { return rewards_; }
+
+    template <typename Scalar>
+    const Eigen::Map<const SparseMatrix2DT<Scalar>> & MappedSparseModelT<Scalar>::getTransitionFunction(const size_t a) const { return transitions_[a]; }
+
+    template class MappedSparseModelT<double>;
+    template class MappedSparseModelT<float>;
+}
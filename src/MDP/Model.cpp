@@ -4,12 +4,13 @@ namespace AIToolbox::MDP {
     Model::Model(NoCheck, const size_t s, const size_t a, TransitionMatrix && t, RewardMatrix && r, const double d) :
             S(s), A(a), discount_(d),
             transitions_(std::move(t)),
-            rewards_(std::move(r)),
+            rewards_(std::move(r)), useSamplingIndex_(false), eagerSamplingIndex_(false),
             rand_(Impl::Seeder::getSeed()) {}
 
     Model::Model(const size_t s, const size_t a, const double discount) :
             S(s), A(a), discount_(discount), transitions_(A, Matrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            rand_(Impl::Seeder::getSeed())
     {
         // Make transition matrix true probability
         for ( size_t a = 0; a < A; ++a )
@@ -31,6 +32,7 @@ namespace AIToolbox::MDP {
         }
         // Then we copy.
         transitions_ = t;
+        resetSamplingIndex();
     }
 
     void Model::setRewardFunction(const RewardMatrix & r) {
@@ -38,7 +40,19 @@ namespace AIToolbox::MDP {
     }
 
     std::tuple<size_t, double> Model::sampleSR(const size_t s, const size_t a) const {
-        size_t s1 = sampleProbability(S, transitions_[a].row(s), rand_);
+        return sampleSR(s, a, rand_);
+    }
+
+    std::tuple<size_t, double> Model::sampleSR(const size_t s, const size_t a, RandomEngine & rnd) const {
+        size_t s1;
+        if ( useSamplingIndex_ ) {
+            const size_t id = s * A + a;
+            if ( !samplingIndex_.isBuilt(id) )
+                samplingIndex_.build(id, transitions_[a].row(s));
+            s1 = samplingIndex_.sample(id, rnd);
+        } else {
+            s1 = sampleProbability(S, transitions_[a].row(s), rnd);
+        }
 
         return std::make_tuple(s1, rewards_(s, a));
     }
@@ -56,6 +70,24 @@ namespace AIToolbox::MDP {
         discount_ = d;
     }
 
+    void Model::setSamplingIndex(const bool enabled, const bool eager) {
+        useSamplingIndex_ = enabled;
+        eagerSamplingIndex_ = eager;
+        resetSamplingIndex();
+    }
+
+    void Model::resetSamplingIndex() {
+        if ( !useSamplingIndex_ ) {
+            samplingIndex_.reset(0);
+            return;
+        }
+        samplingIndex_.reset(S * A);
+        if ( eagerSamplingIndex_ )
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    samplingIndex_.build(s * A + a, transitions_[a].row(s));
+    }
+
     bool Model::isTerminal(const size_t s) const {
         for ( size_t a = 0; a < A; ++a )
             if ( !checkEqualSmall(1.0, transitions_[a](s, s)) )
@@ -66,6 +98,8 @@ namespace AIToolbox::MDP {
     size_t Model::getS() const { return S; }
     size_t Model::getA() const { return A; }
     double Model::getDiscount() const { return discount_; }
+    bool Model::isSamplingIndexEnabled() const { return useSamplingIndex_; }
+    size_t Model::getSamplingIndexMemory() const { return samplingIndex_.getMemoryUsage(); }
 
     const Model::TransitionMatrix & Model::getTransitionFunction() const { return transitions_; }
     const Model::RewardMatrix &     Model::getRewardFunction()     const { return rewards_; }
@@ -13,6 +13,14 @@ namespace AIToolbox::MDP {
         return 1.0 / A;
     }
 
+    void EpsilonPolicy::getActionProbabilities(const size_t & s, Vector & out) const {
+        const auto & wrapped = dynamic_cast<const PolicyInterface &>(policy_);
+        wrapped.getActionProbabilities(s, out);
+
+        out *= (1.0 - epsilon_);
+        out.array() += epsilon_ / A;
+    }
+
     Matrix2D EpsilonPolicy::getPolicy() const {
         const auto & wrapped = dynamic_cast<const PolicyInterface &>(policy_);
         auto p = wrapped.getPolicy();
@@ -0,0 +1,8 @@
+#include <AIToolbox/MDP/Policies/PolicyInterface.hpp>
+
+namespace AIToolbox::MDP {
+    void PolicyInterface::getActionProbabilities(const size_t & s, Vector & out) const {
+        for ( size_t a = 0; a < A; ++a )
+            out[a] = getActionProbability(s, a);
+    }
+}
@@ -17,6 +17,10 @@ namespace AIToolbox::MDP {
         return policy_(s, a);
     }
 
+    void PolicyWrapper::getActionProbabilities(const size_t & s, Vector & out) const {
+        out = policy_.row(s);
+    }
+
     const PolicyWrapper::PolicyMatrix & PolicyWrapper::getPolicyMatrix() const {
         return policy_;
     }
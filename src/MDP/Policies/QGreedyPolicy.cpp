@@ -1,29 +1,91 @@
 #include <AIToolbox/MDP/Policies/QGreedyPolicy.hpp>
 
+#include <algorithm>
+
 #include <AIToolbox/Bandit/Policies/Utils/QGreedyPolicyWrapper.hpp>
 
 namespace AIToolbox::MDP {
     QGreedyPolicy::QGreedyPolicy(const QFunction & q) :
-            PolicyInterface::Base(q.rows(), q.cols()), QPolicyInterface(q), bestActions_(getA()) {}
+            PolicyInterface::Base(q.rows(), q.cols()), QPolicyInterface(q), bestActions_(getA()),
+            version_(nullptr) {}
 
     size_t QGreedyPolicy::sampleAction(const size_t & s) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            // Same draw as QGreedyPolicyWrapper, so results do not change.
+            auto pickDistribution = std::uniform_int_distribution<unsigned>(0, count-1);
+            return cachedActions_[s * A + pickDistribution(rand_)];
+        }
         auto wrap = Bandit::QGreedyPolicyWrapper(q_.row(s), bestActions_, rand_);
         return wrap.sampleAction();
     }
 
     double QGreedyPolicy::getActionProbability(const size_t & s, const size_t & a) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            const auto begin = cachedActions_.begin() + s * A;
+            if ( std::binary_search(begin, begin + count, a) )
+                return 1.0 / count;
+            return 0.0;
+        }
         auto wrap = Bandit::QGreedyPolicyWrapper(q_.row(s), bestActions_, rand_);
         return wrap.getActionProbability(a);
     }
 
+    void QGreedyPolicy::getActionProbabilities(const size_t & s, Vector & out) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            out.setZero();
+            for (size_t i = 0; i < count; ++i)
+                out[cachedActions_[s * A + i]] = 1.0 / count;
+            return;
+        }
+        auto wrap = Bandit::QGreedyPolicyWrapper(q_.row(s), bestActions_, rand_);
+        wrap.getPolicy(out);
+    }
+
     Matrix2D QGreedyPolicy::getPolicy() const {
         Matrix2D retval(S, A);
 
         for (size_t s = 0; s < S; ++s) {
+            if ( version_ ) {
+                const unsigned count = getCachedActions(s);
+                retval.row(s).setZero();
+                for (size_t i = 0; i < count; ++i)
+                    retval(s, cachedActions_[s * A + i]) = 1.0 / count;
+                continue;
+            }
             auto wrap = Bandit::QGreedyPolicyWrapper(q_.row(s), bestActions_, rand_);
             wrap.getPolicy(retval.row(s));
         }
 
         return retval;
     }
+
+    unsigned QGreedyPolicy::getCachedActions(const size_t s) const {
+        if ( cacheStamps_[s] != *version_ + 1 ) {
+            cachedCounts_[s] = Bandit::findBestActions(q_.row(s), cachedActions_.data() + s * A);
+            cacheStamps_[s] = *version_ + 1;
+        }
+        return cachedCounts_[s];
+    }
+
+    void QGreedyPolicy::enableCache(const size_t & version) {
+        version_ = &version;
+        // A stamp of zero is never valid, so everything is recomputed.
+        cacheStamps_.assign(S, 0);
+        cachedCounts_.resize(S);
+        cachedActions_.resize(S * A);
+    }
+
+    void QGreedyPolicy::disableCache() {
+        version_ = nullptr;
+        cacheStamps_ = {};
+        cachedCounts_ = {};
+        cachedActions_ = {};
+    }
+
+    bool QGreedyPolicy::isCacheEnabled() const {
+        return version_ != nullptr;
+    }
 }
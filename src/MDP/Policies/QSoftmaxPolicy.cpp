@@ -1,29 +1,78 @@
 #include <AIToolbox/MDP/Policies/QSoftmaxPolicy.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 #include <AIToolbox/Bandit/Policies/Utils/QSoftmaxPolicyWrapper.hpp>
+#include <AIToolbox/Utils/Probability.hpp>
 
 namespace AIToolbox::MDP {
     QSoftmaxPolicy::QSoftmaxPolicy(const QFunction & q, const double t) :
             PolicyInterface::Base(q.rows(), q.cols()), QPolicyInterface(q),
-            temperature_(t), bestActions_(A), vbuffer_(A)
+            temperature_(t), bestActions_(A), vbuffer_(A), version_(nullptr)
     {
         if ( temperature_ < 0.0 ) throw std::invalid_argument("Temperature must be >= 0");
     }
 
     size_t QSoftmaxPolicy::sampleAction(const size_t & s) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            if ( count ) {
+                auto pickDistribution = std::uniform_int_distribution<unsigned>(0, count-1);
+                return cachedActions_[s * A + pickDistribution(rand_)];
+            }
+            const auto begin = cachedCdf_.begin() + s * A;
+            const size_t a = std::upper_bound(begin, begin + A, probabilityDistribution(rand_)) - begin;
+            return std::min(a, A - 1);
+        }
         auto wrap = Bandit::QSoftmaxPolicyWrapper(temperature_, q_.row(s), vbuffer_, bestActions_, rand_);
         return wrap.sampleAction();
     }
 
     double QSoftmaxPolicy::getActionProbability(const size_t & s, const size_t & a) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            if ( count ) {
+                const auto begin = cachedActions_.begin() + s * A;
+                if ( std::binary_search(begin, begin + count, a) )
+                    return 1.0 / count;
+                return 0.0;
+            }
+            const double * cdf = cachedCdf_.data() + s * A;
+            return a == 0 ? cdf[0] : cdf[a] - cdf[a-1];
+        }
         auto wrap = Bandit::QSoftmaxPolicyWrapper(temperature_, q_.row(s), vbuffer_, bestActions_, rand_);
         return wrap.getActionProbability(a);
     }
 
+    void QSoftmaxPolicy::getActionProbabilities(const size_t & s, Vector & out) const {
+        if ( version_ ) {
+            const unsigned count = getCachedActions(s);
+            if ( count ) {
+                out.setZero();
+                for (size_t i = 0; i < count; ++i)
+                    out[cachedActions_[s * A + i]] = 1.0 / count;
+            } else {
+                const double * cdf = cachedCdf_.data() + s * A;
+                out[0] = cdf[0];
+                for (size_t a = 1; a < A; ++a)
+                    out[a] = cdf[a] - cdf[a-1];
+            }
+            return;
+        }
+        auto wrap = Bandit::QSoftmaxPolicyWrapper(temperature_, q_.row(s), vbuffer_, bestActions_, rand_);
+        wrap.getPolicy(out);
+    }
+
     Matrix2D QSoftmaxPolicy::getPolicy() const {
         Matrix2D retval(S, A);
 
         for (size_t s = 0; s < S; ++s) {
+            if ( version_ ) {
+                getActionProbabilities(s, vbuffer_);
+                retval.row(s) = vbuffer_;
+                continue;
+            }
             auto wrap = Bandit::QSoftmaxPolicyWrapper(temperature_, q_.row(s), vbuffer_, bestActions_, rand_);
             wrap.getPolicy(retval.row(s));
         }
@@ -31,9 +80,69 @@ namespace AIToolbox::MDP {
         return retval;
     }
 
+    unsigned QSoftmaxPolicy::getCachedActions(const size_t s) const {
+        if ( cacheStamps_[s] == *version_ + 1 )
+            return cachedCounts_[s];
+
+        size_t * ties = cachedActions_.data() + s * A;
+        double * cdf = cachedCdf_.data() + s * A;
+        unsigned count = 0;
+
+        // This follows QSoftmaxPolicyWrapper.
+        if ( checkEqualSmall(temperature_, 0.0) ) {
+            count = Bandit::findBestActions(q_.row(s), ties);
+        } else {
+            double sum = 0.0;
+            for ( size_t a = 0; a < A; ++a ) {
+                cdf[a] = std::exp(q_(s, a) / temperature_);
+                if ( std::isinf(cdf[a]) )
+                    ties[count++] = a;
+                sum += cdf[a];
+            }
+            if ( !count ) {
+                if ( checkEqualSmall(sum, 0.0) ) {
+                    for ( size_t a = 0; a < A; ++a )
+                        ties[a] = a;
+                    count = A;
+                } else {
+                    double acc = 0.0;
+                    for ( size_t a = 0; a < A; ++a ) {
+                        acc += cdf[a] / sum;
+                        cdf[a] = acc;
+                    }
+                }
+            }
+        }
+        cachedCounts_[s] = count;
+        cacheStamps_[s] = *version_ + 1;
+        return count;
+    }
+
+    void QSoftmaxPolicy::enableCache(const size_t & version) {
+        version_ = &version;
+        // A stamp of zero is never valid, so everything is recomputed.
+        cacheStamps_.assign(S, 0);
+        cachedCounts_.resize(S);
+        cachedActions_.resize(S * A);
+        cachedCdf_.resize(S * A);
+    }
+
+    void QSoftmaxPolicy::disableCache() {
+        version_ = nullptr;
+        cacheStamps_ = {};
+        cachedCounts_ = {};
+        cachedActions_ = {};
+        cachedCdf_ = {};
+    }
+
+    bool QSoftmaxPolicy::isCacheEnabled() const {
+        return version_ != nullptr;
+    }
+
     void QSoftmaxPolicy::setTemperature(const double t) {
         if ( t < 0.0 ) throw std::invalid_argument("Temperature must be >= 0");
         temperature_ = t;
+        if ( version_ ) cacheStamps_.assign(S, 0);
     }
 
     double QSoftmaxPolicy::getTemperature() const {
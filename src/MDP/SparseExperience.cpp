@@ -1,8 +1,16 @@
 #include <AIToolbox/MDP/SparseExperience.hpp>
 
+#include <AIToolbox/Impl/ExperienceBatch.hpp>
+
+#include <algorithm>
+
 namespace AIToolbox::MDP {
     SparseExperience::SparseExperience(const size_t s, const size_t a) :
-            S(s), A(a), visits_(A, SparseTable2D(S, S)), visitsSum_(S, A), rewards_(S, A), M2s_(S, A), timesteps_(0) {}
+            S(s), A(a), visits_(A, SparseTable2D(S, S)), visitsSum_(S, A), rewards_(S, A), M2s_(S, A), timesteps_(0),
+            version_(0), resetVersion_(0), pairVersions_(S, A)
+    {
+        markAllDirty();
+    }
 
     void SparseExperience::record(const size_t s, const size_t a, const size_t s1, const double rew) {
         ++timesteps_;
@@ -16,6 +24,23 @@ namespace AIToolbox::MDP {
         rewards_.coeffRef(s, a) += delta / visitsSum_.coeffRef(s, a);
         // Rolling sum of square diffs.
         M2s_.coeffRef(s, a) += delta * (rew - rewards_.coeffRef(s, a));
+
+        markDirty(s, a, ++version_);
+    }
+
+    void SparseExperience::recordBatch(const size_t n, const size_t * s, const size_t * a, const size_t * s1, const double * rew) {
+        const auto version = ++version_;
+
+        Impl::groupBatch(n, s, a, s1, rew,
+            [this](size_t ss, size_t aa, size_t ss1, unsigned long visits) {
+                visits_[aa].coeffRef(ss, ss1) += visits;
+            },
+            [this, version](size_t ss, size_t aa, unsigned long count, double mean, double m2) {
+                Impl::mergeWelford(visitsSum_.coeffRef(ss, aa), rewards_.coeffRef(ss, aa), M2s_.coeffRef(ss, aa), count, mean, m2);
+                markDirty(ss, aa, version);
+            }
+        );
+        timesteps_ += n;
     }
 
     void SparseExperience::reset() {
@@ -33,6 +58,40 @@ namespace AIToolbox::MDP {
         M2s_.makeCompressed();
 
         timesteps_ = 0;
+
+        pairVersions_.setZero();
+        pairVersions_.makeCompressed();
+        markAllDirty();
+    }
+
+    unsigned long SparseExperience::getVersion() const {
+        return version_;
+    }
+
+    unsigned long SparseExperience::getVersion(const size_t s, const size_t a) const {
+        return std::max(pairVersions_.coeff(s, a), resetVersion_);
+    }
+
+    unsigned long SparseExperience::getEpoch() const {
+        return epoch_.get();
+    }
+
+    std::vector<std::pair<size_t, size_t>> SparseExperience::getDirtyPairs(const unsigned long version) const {
+        return dirty_.since(version, [this](size_t s, size_t a) { return pairVersions_.coeff(s, a); });
+    }
+
+    void SparseExperience::markDirty(const size_t s, const size_t a, const unsigned long version) {
+        auto & pairVersion = pairVersions_.coeffRef(s, a);
+        // A pair can only be modified once per version.
+        if ( pairVersion == version ) return;
+        pairVersion = version;
+        dirty_.add(s, a, version, S * A, [this](size_t ss, size_t aa) { return pairVersions_.coeff(ss, aa); });
+    }
+
+    void SparseExperience::markAllDirty() {
+        resetVersion_ = ++version_;
+        epoch_.advance();
+        dirty_.clear();
     }
 
     unsigned long SparseExperience::getTimesteps() const {
@@ -1,71 +1,174 @@
 #include <AIToolbox/MDP/SparseModel.hpp>
 
 namespace AIToolbox::MDP {
-    SparseModel::SparseModel(NoCheck, const size_t s, const size_t a, TransitionMatrix && t, RewardMatrix && r, const double d) :
-            S(s), A(a), discount_(d), transitions_(t), rewards_(r), rand_(Impl::Seeder::getSeed()) {}
+    template <typename Scalar>
+    SparseModelT<Scalar>::SparseModelT(NoCheck, const size_t s, const size_t a, TransitionMatrix && t, RewardMatrix && r, const double d) :
+            S(s), A(a), discount_(d), transitions_(std::move(t)), rewards_(std::move(r)),
+            useSamplingIndex_(false), eagerSamplingIndex_(false), useStackedTransitions_(false),
+            rand_(Impl::Seeder::getSeed()) {}
 
-    SparseModel::SparseModel(const size_t s, const size_t a, const double discount) :
-            S(s), A(a), discount_(discount), transitions_(A, SparseMatrix2D(S, S)),
-            rewards_(S, A), rand_(Impl::Seeder::getSeed())
+    template <typename Scalar>
+    SparseModelT<Scalar>::SparseModelT(const size_t s, const size_t a, const double discount) :
+            S(s), A(a), discount_(discount), transitions_(A, SparseMatrix2DT<Scalar>(S, S)),
+            rewards_(S, A), useSamplingIndex_(false), eagerSamplingIndex_(false),
+            useStackedTransitions_(false), rand_(Impl::Seeder::getSeed())
     {
         // Make transition matrix true probability
         for ( size_t a = 0; a < A; ++a )
             transitions_[a].setIdentity();
     }
 
-    void SparseModel::setTransitionFunction(const SparseMatrix3D & t) {
+    template <typename Scalar>
+    void SparseModelT<Scalar>::setTransitionFunction(const TransitionMatrix & t) {
         // First we verify data, without modifying anything...
         for ( size_t a = 0; a < A; ++a ) {
             // Eigen sparse does not implement minCoeff so we can't check for negatives.
             // So we force the matrix to its abs, and if then the sum goes haywire then
             // we found an error.
             for ( size_t s = 0; s < S; ++s ) {
-                if ( !checkEqualSmall(1.0, t[a].row(s).sum()) )
+                if ( !checkEqualSmall(1.0, t[a].row(s).template cast<double>().sum()) )
                     throw std::invalid_argument("Input transition matrix does not contain valid probabilities.");
-                if ( !checkEqualSmall(1.0, t[a].row(s).cwiseAbs().sum()) )
+                if ( !checkEqualSmall(1.0, t[a].row(s).cwiseAbs().template cast<double>().sum()) )
                     throw std::invalid_argument("Input transition matrix does not contain valid probabilities.");
             }
         }
         // Then we copy.
         transitions_ = t;
+        resetSamplingIndex();
+        resetStackedTransitions();
     }
 
-    void SparseModel::setRewardFunction(const RewardMatrix & r) {
+    template <typename Scalar>
+    void SparseModelT<Scalar>::setRewardFunction(const RewardMatrix & r) {
         rewards_ = r;
     }
 
-    std::tuple<size_t, double> SparseModel::sampleSR(const size_t s, const size_t a) const {
-        const size_t s1 = sampleProbability(S, transitions_[a].row(s), rand_);
+    template <typename Scalar>
+    std::tuple<size_t, double> SparseModelT<Scalar>::sampleSR(const size_t s, const size_t a) const {
+        return sampleSR(s, a, rand_);
+    }
+
+    template <typename Scalar>
+    std::tuple<size_t, double> SparseModelT<Scalar>::sampleSR(const size_t s, const size_t a, RandomEngine & rnd) const {
+        size_t s1;
+        if ( useSamplingIndex_ ) {
+            const size_t id = s * A + a;
+            if ( !samplingIndex_.isBuilt(id) )
+                samplingIndex_.build(id, transitions_[a].row(s));
+            s1 = samplingIndex_.sample(id, rnd);
+        } else {
+            s1 = sampleProbability(S, transitions_[a].row(s), rnd);
+        }
 
         return std::make_tuple(s1, getExpectedReward(s, a, s1));
     }
 
-    double SparseModel::getTransitionProbability(const size_t s, const size_t a, const size_t s1) const {
+    template <typename Scalar>
+    double SparseModelT<Scalar>::getTransitionProbability(const size_t s, const size_t a, const size_t s1) const {
         return transitions_[a].coeff(s, s1);
     }
 
-    double SparseModel::getExpectedReward(const size_t s, const size_t a, const size_t) const {
+    template <typename Scalar>
+    double SparseModelT<Scalar>::getExpectedReward(const size_t s, const size_t a, const size_t) const {
         return rewards_.coeff(s, a);
     }
 
-    void SparseModel::setDiscount(const double d) {
+    template <typename Scalar>
+    void SparseModelT<Scalar>::setDiscount(const double d) {
         if ( d <= 0.0 || d > 1.0 ) throw std::invalid_argument("Discount parameter must be in (0,1]");
         discount_ = d;
     }
 
-    bool SparseModel::isTerminal(const size_t s) const {
+    template <typename Scalar>
+    void SparseModelT<Scalar>::setSamplingIndex(const bool enabled, const bool eager) {
+        useSamplingIndex_ = enabled;
+        eagerSamplingIndex_ = eager;
+        resetSamplingIndex();
+    }
+
+    template <typename Scalar>
+    void SparseModelT<Scalar>::resetSamplingIndex() {
+        if ( !useSamplingIndex_ ) {
+            samplingIndex_.reset(0);
+            return;
+        }
+        samplingIndex_.reset(S * A);
+        if ( eagerSamplingIndex_ )
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    samplingIndex_.build(s * A + a, transitions_[a].row(s));
+    }
+
+    template <typename Scalar>
+    void SparseModelT<Scalar>::setStackedTransitions(const bool enabled) {
+        useStackedTransitions_ = enabled;
+        resetStackedTransitions();
+    }
+
+    template <typename Scalar>
+    void SparseModelT<Scalar>::resetStackedTransitions() {
+        if ( !useStackedTransitions_ ) {
+            stacked_ = SparseMatrix2DT<Scalar>();
+            return;
+        }
+        size_t nonZeros = 0;
+        for ( size_t a = 0; a < A; ++a )
+            nonZeros += transitions_[a].nonZeros();
+
+        stacked_.resize(S * A, S);
+        stacked_.reserve(nonZeros);
+
+        // Rows are filled in order, and each transition row is already
+        // sorted by column, so we can append directly to the storage.
+        for ( size_t s = 0; s < S; ++s ) {
+            for ( size_t a = 0; a < A; ++a ) {
+                const auto row = s * A + a;
+                stacked_.startVec(row);
+                for ( typename SparseMatrix2DT<Scalar>::InnerIterator it(transitions_[a], s); it; ++it )
+                    stacked_.insertBack(row, it.col()) = it.value();
+            }
+        }
+        stacked_.finalize();
+    }
+
+    template <typename Scalar>
+    bool SparseModelT<Scalar>::isTerminal(const size_t s) const {
         for ( size_t a = 0; a < A; ++a )
             if ( !checkEqualSmall(1.0, getTransitionProbability(s, a, s)) )
                 return false;
         return true;
     }
 
-    size_t SparseModel::getS() const { return S; }
-    size_t SparseModel::getA() const { return A; }
-    double SparseModel::getDiscount() const { return discount_; }
+    template <typename Scalar>
+    size_t SparseModelT<Scalar>::getS() const { return S; }
+
+    template <typename Scalar>
+    size_t SparseModelT<Scalar>::getA() const { return A; }
+
+    template <typename Scalar>
+    double SparseModelT<Scalar>::getDiscount() const { return discount_; }
+
+    template <typename Scalar>
+    bool SparseModelT<Scalar>::isSamplingIndexEnabled() const { return useSamplingIndex_; }
+
+    template <typename Scalar>
+    size_t SparseModelT<Scalar>::getSamplingIndexMemory() const { return samplingIndex_.getMemoryUsage(); }
+
+    template <typename Scalar>
+    bool SparseModelT<Scalar>::isStackedTransitionsEnabled() const { return useStackedTransitions_; }
+
+    template <typename Scalar>
+    const typename SparseModelT<Scalar>::TransitionMatrix & SparseModelT<Scalar>::getTransitionFunction() const { return transitions_; }
+
+    template <typename Scalar>
+    const typename SparseModelT<Scalar>::RewardMatrix & SparseModelT<Scalar>::getRewardFunction() const { return rewards_; }
+
+    template <typename Scalar>
+    const SparseMatrix2DT<Scalar> & SparseModelT<Scalar>::getTransitionFunction(const size_t a) const { return transitions_[a]; }
 
-    const SparseModel::TransitionMatrix & SparseModel::getTransitionFunction() const { return transitions_; }
-    const SparseModel::RewardMatrix &     SparseModel::getRewardFunction()     const { return rewards_; }
+    template <typename Scalar>
+    const SparseMatrix2DT<Scalar> & SparseModelT<Scalar>::getStackedTransitionFunction() const { return stacked_; }
 
-    const SparseMatrix2D & SparseModel::getTransitionFunction(const size_t a) const { return transitions_[a]; }
+    template class SparseModelT<double>;
+    template class SparseModelT<float>;
 }
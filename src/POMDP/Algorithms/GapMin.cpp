@@ -26,11 +26,6 @@ namespace AIToolbox::POMDP {
         return precisionDigits_;
     }
 
-    bool GapMin::QueueElementLess::operator() (const QueueElement& arg1, const QueueElement& arg2) const
-    {
-        return std::get<1>(arg1) < std::get<1>(arg2);
-    }
-
     void GapMin::cleanUp(const MDP::QFunction & ubQ, UpperBoundValueFunction * ubVp, Matrix2D * fibQp) {
         assert(ubVp);
         assert(fibQp);
@@ -3,6 +3,7 @@
 #include <AIToolbox/POMDP/Utils.hpp>
 
 #include <AIToolbox/Impl/CassandraParser.hpp>
+#include <AIToolbox/Impl/BinaryModelFormat.hpp>
 
 namespace AIToolbox::POMDP {
     Model<MDP::Model> parseCassandra(std::istream & input) {
@@ -13,6 +14,66 @@ namespace AIToolbox::POMDP {
         return Model<MDP::Model>(O, W, S, A, T, R, discount);
     }
 
+    std::ostream& writeBinary(std::ostream &os, const Model<MDP::Model> & m) {
+        Impl::BinaryModelWriter writer(os, Impl::BinaryModelKind::POMDPModel, m.getS(), m.getA(), m.getO(), m.getDiscount());
+
+        for ( const auto & t : m.getTransitionFunction() )
+            writer.writeDense(t);
+        writer.writeDense(m.getRewardFunction());
+        for ( const auto & o : m.getObservationFunction() )
+            writer.writeDense(o);
+
+        return os;
+    }
+
+    std::ostream& writeBinary(std::ostream &os, const SparseModel<MDP::SparseModel> & m) {
+        Impl::BinaryModelWriter writer(os, Impl::BinaryModelKind::POMDPSparseModel, m.getS(), m.getA(), m.getO(), m.getDiscount());
+
+        for ( const auto & t : m.getTransitionFunction() )
+            writer.writeSparse(t);
+        writer.writeSparse(m.getRewardFunction());
+        for ( const auto & o : m.getObservationFunction() )
+            writer.writeSparse(o);
+
+        return os;
+    }
+
+    Model<MDP::Model> loadBinaryModel(const std::string & filename) {
+        Impl::BinaryModelReader reader(filename, Impl::BinaryModelKind::POMDPModel);
+        const auto S = reader.getS(), A = reader.getA(), O = reader.getO();
+
+        MDP::Model::TransitionMatrix t;
+        t.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            t.emplace_back(reader.readDense(S, S));
+        auto r = reader.readDense(S, A);
+
+        Model<MDP::Model>::ObservationMatrix w;
+        w.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            w.emplace_back(reader.readDense(S, O));
+
+        return Model<MDP::Model>(NO_CHECK, O, std::move(w), NO_CHECK, S, A, std::move(t), std::move(r), reader.getDiscount());
+    }
+
+    SparseModel<MDP::SparseModel> loadBinarySparseModel(const std::string & filename) {
+        Impl::BinaryModelReader reader(filename, Impl::BinaryModelKind::POMDPSparseModel);
+        const auto S = reader.getS(), A = reader.getA(), O = reader.getO();
+
+        MDP::SparseModel::TransitionMatrix t;
+        t.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            t.emplace_back(reader.readSparse<double>(S, S));
+        auto r = reader.readSparse<double>(S, A);
+
+        SparseModel<MDP::SparseModel>::ObservationMatrix w;
+        w.reserve(A);
+        for ( size_t a = 0; a < A; ++a )
+            w.emplace_back(reader.readSparse<double>(S, O));
+
+        return SparseModel<MDP::SparseModel>(NO_CHECK, O, std::move(w), NO_CHECK, S, A, std::move(t), std::move(r), reader.getDiscount());
+    }
+
     std::ostream& operator<<(std::ostream &os, const Policy & p) {
         const auto & vf = p.getValueFunction();
 
@@ -30,12 +30,13 @@ void exportMDPPolicyIteration() {
          "When the policy does not change anymore, it is guaranteed to be\n"
          "optimal, and the found QFunction is returned.\n", no_init}
 
-        .def(init<unsigned, optional<double>>(
+        .def(init<unsigned, optional<double, bool>>(
                 "Basic constructor.\n"
                 "\n"
                 "@param horizon The horizon parameter to use during the PolicyEvaluation phase.\n"
-                "@param tolerance The tolerance parameter to use during the PolicyEvaluation phase."
-        , (arg("self"), "horizon", "tolerance")))
+                "@param tolerance The tolerance parameter to use during the PolicyEvaluation phase.\n"
+                "@param linearSolve Whether PolicyEvaluation should solve for the values directly."
+        , (arg("self"), "horizon", "tolerance", "linearSolve")))
 
         .def("__call__",                &PolicyIteration::operator()<Model>,
                 "This function applies policy iteration on an MDP to solve it.\n"
@@ -83,11 +84,23 @@ void exportMDPPolicyIteration() {
                  "This function sets the horizon parameter."
         , (arg("self"), "horizon"))
 
+        .def("setLinearSolve",          &PolicyIteration::setLinearSolve,
+                 "This function sets whether PolicyEvaluation should solve for the values directly.\n"
+                 "\n"
+                 "In this mode the horizon and tolerance are used as the\n"
+                 "maximum number of iterations and the relative residual of\n"
+                 "the linear solver."
+        , (arg("self"), "l"))
+
         .def("getTolerance",            &PolicyIteration::getTolerance,
                  "This function will return the currently set tolerance parameter."
         , (arg("self")))
 
         .def("getHorizon",              &PolicyIteration::getHorizon,
                  "This function will return the current horizon parameter."
+        , (arg("self")))
+
+        .def("getLinearSolve",          &PolicyIteration::getLinearSolve,
+                 "This function returns whether PolicyEvaluation solves for the values directly."
         , (arg("self")));
 }
@@ -76,6 +76,14 @@ void exportPrioritizedSweepingByModel(std::string className) {
                  "proceeds to the next most urgent iteration."
         , (arg("self")))
 
+        .def("updatePredecessors",      static_cast<void(V::*)()>(&V::updatePredecessors),
+                 "This function rebuilds the predecessor index from the model.\n"
+                 "\n"
+                 "This function scans the whole transition function of the\n"
+                 "model, so it should only be called when the model changed in\n"
+                 "ways that stepUpdateQ() cannot detect by itself."
+        , (arg("self")))
+
         .def("setQueueThreshold",       &V::setQueueThreshold,
                  "This function sets the theta parameter.\n"
                  "\n"
@@ -142,7 +142,7 @@ void exportMDPQL() {
                  "MDP::QGreedyPolicy."
         , (arg("self")))
 
-        .def("getTraces",                   &QL::getTraces, return_internal_reference<>(),
+        .def("getTraces",                   &QL::getTraces,
                  "This function returns the currently set traces."
         , (arg("self")));
 }
@@ -228,7 +228,7 @@ void exportMDPSARSAL() {
                  "MDP::QGreedyPolicy."
         , (arg("self")))
 
-        .def("getTraces",                   &SARSAL::getTraces, return_internal_reference<>(),
+        .def("getTraces",                   &SARSAL::getTraces,
                  "This function returns the currently set traces."
         , (arg("self")));
 }
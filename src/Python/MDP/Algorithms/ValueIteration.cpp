@@ -32,7 +32,7 @@ void exportMDPValueIteration() {
          "This implementation in particular is ported from the MATLAB\n"
          "MDPToolbox (although it is simplified).", no_init}
 
-        .def(init<unsigned, optional<double>>(
+        .def(init<unsigned, optional<double, ValueFunction, unsigned>>(
                  "Basic constructor.\n"
                  "\n"
                  "The tolerance parameter must be >= 0.0, otherwise the\n"
@@ -43,9 +43,16 @@ void exportMDPValueIteration() {
                  "will stop as soon as the difference between two iterations\n"
                  "is less than the tolerance specified.\n"
                  "\n"
+                 "Note that the default value function size needs to match\n"
+                 "the number of states of the Model. Otherwise it will\n"
+                 "be ignored. An empty value function will be defaulted\n"
+                 "to all zeroes.\n"
+                 "\n"
                  "@param horizon The maximum number of iterations to perform.\n"
-                 "@param tolerance The tolerance factor to stop the value iteration loop."
-        , (arg("self"), "horizon", "tolerance")))
+                 "@param tolerance The tolerance factor to stop the value iteration loop.\n"
+                 "@param v The initial value function from which to start the loop.\n"
+                 "@param threads The number of threads to use, 0 for all available ones."
+        , (arg("self"), "horizon", arg("tolerance") = 0.001, arg("v") = ValueFunction{Values(), Actions(0)}, arg("threads") = 1u)))
 
         .def("__call__",                &ValueIteration::operator()<Model>,
                  "This function applies value iteration on an MDP to solve it.\n"
@@ -109,11 +116,26 @@ void exportMDPValueIteration() {
                  "This function sets the horizon parameter."
         , (arg("self"), "horizon"))
 
+        .def("setThreads",              &ValueIteration::setThreads,
+                 "This function sets the number of threads to use.\n"
+                 "\n"
+                 "Multithreading is only used with models that expose Eigen\n"
+                 "matrices; other models are always solved serially. A value\n"
+                 "of 0 uses all available hardware threads, while 1 disables\n"
+                 "multithreading.\n"
+                 "\n"
+                 "@param threads The new number of threads."
+        , (arg("self"), "threads"))
+
         .def("getTolerance",            &ValueIteration::getTolerance,
                  "This function will return the currently set tolerance parameter."
         , (arg("self")))
 
         .def("getHorizon",              &ValueIteration::getHorizon,
                  "This function will return the current horizon parameter."
+        , (arg("self")))
+
+        .def("getThreads",              &ValueIteration::getThreads,
+                 "This function returns the currently set number of threads."
         , (arg("self")));
 }
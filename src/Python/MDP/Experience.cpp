@@ -35,6 +35,17 @@ void exportMDPExperience() {
                  "@param rew   Obtained reward."
         , (arg("self"), "s", "a", "s1", "rew"))
 
+        .def("merge",           &Experience::merge,
+                 "This function adds all the data recorded in another Experience to this one.\n"
+                 "\n"
+                 "Visits and timesteps are summed, while rewards and M2s are\n"
+                 "combined with the parallel variant of Welford's algorithm, so\n"
+                 "that the result is the same as if all events had been\n"
+                 "recorded in this Experience.\n"
+                 "\n"
+                 "@param other The Experience to merge into this one."
+        , (arg("self"), "other"))
+
         .def("reset",           &Experience::reset,
                 "This function resets all experienced rewards and transitions."
         , (arg("self")))
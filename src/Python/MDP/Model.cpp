@@ -149,7 +149,7 @@ void exportMDPModel() {
                 "This function returns the currently set discount factor."
         , (arg("self")))
 
-        .def("sampleSR",                    &Model::sampleSR,
+        .def("sampleSR",                    static_cast<std::tuple<size_t, double>(Model::*)(size_t, size_t) const>(&Model::sampleSR),
                  "This function samples the MDP for the specified state action pair.\n"
                  "\n"
                  "This function samples the model for simulated experience.\n"
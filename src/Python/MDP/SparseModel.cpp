@@ -159,7 +159,7 @@ void exportMDPSparseModel() {
                 "This function returns the currently set discount factor."
         , (arg("self")))
 
-        .def("sampleSR",                    &SparseModel::sampleSR,
+        .def("sampleSR",                    static_cast<std::tuple<size_t, double>(SparseModel::*)(size_t, size_t) const>(&SparseModel::sampleSR),
                  "This function samples the MDP for the specified state action pair.\n"
                  "\n"
                  "This function samples the model for simulated experience.\n"
@@ -0,0 +1,73 @@
+#define BOOST_TEST_MODULE MDP_ConcurrentRecorder
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/ConcurrentRecorder.hpp>
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/MaximumLikelihoodModel.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE( threadedRecording ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 10, A = 3;
+    const size_t threads = 4, perThread = 5000;
+
+    Experience exp(S, A), truth(S, A);
+    const auto version = exp.getVersion();
+
+    // Each thread records the same deterministic sequence of events; since
+    // counts and reward averages do not depend on the order, the result
+    // must match a serial recording.
+    const auto event = [](size_t i) {
+        return std::make_tuple(i % S, (i / S) % A, (i * 7) % S, static_cast<double>(i % 5));
+    };
+
+    {
+        ConcurrentRecorder recorder(exp, 8);
+        BOOST_CHECK_EQUAL(recorder.getStripes(), 8);
+
+        std::vector<std::thread> workers;
+        for ( size_t t = 0; t < threads; ++t ) {
+            workers.emplace_back([&recorder, &event]{
+                for ( size_t i = 0; i < perThread; ++i ) {
+                    const auto [s, a, s1, r] = event(i);
+                    recorder.record(s, a, s1, r);
+                }
+            });
+        }
+        for ( auto & w : workers ) w.join();
+    }
+
+    for ( size_t t = 0; t < threads; ++t ) {
+        for ( size_t i = 0; i < perThread; ++i ) {
+            const auto [s, a, s1, r] = event(i);
+            truth.record(s, a, s1, r);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(exp.getTimesteps(), truth.getTimesteps());
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            BOOST_CHECK_EQUAL(exp.getVisitsSum(s, a), truth.getVisitsSum(s, a));
+            BOOST_CHECK_CLOSE(exp.getReward(s, a), truth.getReward(s, a), 0.0001);
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(exp.getVisits(s, a, s1), truth.getVisits(s, a, s1));
+        }
+    }
+
+    // The pairs recorded by all stripes are listed once each.
+    auto dirty = exp.getDirtyPairs(version);
+    std::sort(std::begin(dirty), std::end(dirty));
+    BOOST_CHECK(std::adjacent_find(std::begin(dirty), std::end(dirty)) == std::end(dirty));
+    BOOST_CHECK_EQUAL(dirty.size(), S * A);
+
+    // The Experience can be used as usual.
+    MaximumLikelihoodModel<Experience> model(exp);
+    MaximumLikelihoodModel<Experience> truthModel(truth);
+    for ( size_t a = 0; a < A; ++a )
+        BOOST_CHECK(model.getTransitionFunction(a).isApprox(truthModel.getTransitionFunction(a)));
+}
@@ -109,3 +109,80 @@ BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     BOOST_CHECK_EQUAL( p1.sampleAction(13), RIGHT);
     BOOST_CHECK_EQUAL( p1.sampleAction(14), RIGHT);
 }
+
+BOOST_AUTO_TEST_CASE( parallelBatchUpdates ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+    // Concurrent sampling needs the index to be built upfront.
+    model.setSamplingIndex(true, true);
+
+    static_assert(has_engine_sampling_v<decltype(model)>);
+
+    const auto run = [&](unsigned threads) {
+        AIToolbox::Impl::Seeder::setRootSeed(42);
+
+        Dyna2 solver(model, 0.1, 0.9, 0.001, 400, threads);
+        BOOST_CHECK_EQUAL( solver.getThreads(), threads );
+
+        solver.batchUpdateQ(5);
+        solver.batchUpdateQ(10);
+
+        // Permanent learning is untouched.
+        BOOST_CHECK_EQUAL( solver.getPermanentQFunction().cwiseAbs().maxCoeff(), 0.0 );
+
+        return QFunction(solver.getTransientQFunction());
+    };
+
+    const auto q1 = run(2);
+    const auto q2 = run(2);
+
+    // Results only depend on the seed, not on thread scheduling.
+    BOOST_CHECK( q1 == q2 );
+
+    // Every step costs -1 outside of the corners, so the simulated pairs
+    // have been pushed down.
+    for (size_t a = 0; a < model.getA(); ++a) {
+        BOOST_CHECK( q1(5, a) < 0.0 );
+        BOOST_CHECK( q1(10, a) < 0.0 );
+    }
+    BOOST_CHECK_EQUAL( q1.row(0).cwiseAbs().maxCoeff(), 0.0 );
+    BOOST_CHECK_EQUAL( q1.row(15).cwiseAbs().maxCoeff(), 0.0 );
+
+    // A single thread explores the same region, sequentially.
+    const auto q3 = run(1);
+    for (size_t a = 0; a < model.getA(); ++a)
+        BOOST_CHECK( q3(5, a) < 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( parallelBatchUpdatesGreedyPolicy ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+    model.setSamplingIndex(true, true);
+
+    // The usual setup: epsilon-greedy over the transient QFunction, whose
+    // greedy policy writes to its internal buffers and cache.
+    const auto run = [&]{
+        AIToolbox::Impl::Seeder::setRootSeed(7);
+
+        Dyna2 solver(model, 0.1, 0.9, 0.001, 2000, 4);
+        auto greedy = std::make_unique<QGreedyPolicy>(solver.getTransientQFunction());
+        greedy->enableCache(solver.getTransientQFunctionVersion());
+        solver.setInternalPolicy(new EpsilonPolicy(*greedy, 0.3));
+
+        for (size_t s = 1; s < 15; ++s)
+            solver.batchUpdateQ(s);
+
+        return QFunction(solver.getTransientQFunction());
+    };
+
+    const auto q1 = run();
+    const auto q2 = run();
+    BOOST_CHECK( q1 == q2 );
+    BOOST_CHECK( q1.allFinite() );
+}
@@ -43,3 +43,83 @@ BOOST_AUTO_TEST_CASE( updates ) {
         BOOST_CHECK_EQUAL( solver.getQFunction()(1, 1), 0.0  );
     }
 }
+
+namespace ai = AIToolbox;
+
+template <typename V>
+void checkVisitedPairs(V & visited) {
+    BOOST_CHECK_EQUAL( visited.size(), 0 );
+    BOOST_CHECK( !visited.contains(3, 1) );
+
+    BOOST_CHECK( visited.insert(3, 1) );
+    BOOST_CHECK( visited.insert(0, 0) );
+    BOOST_CHECK( !visited.insert(3, 1) );
+    BOOST_CHECK( visited.insert(99999, 4) );
+
+    BOOST_CHECK_EQUAL( visited.size(), 3 );
+    BOOST_CHECK( visited.contains(3, 1) );
+    BOOST_CHECK( !visited.contains(3, 2) );
+    BOOST_CHECK( visited.contains(99999, 4) );
+
+    BOOST_CHECK( visited[0] == std::make_pair(size_t(3), size_t(1)) );
+    BOOST_CHECK( visited[1] == std::make_pair(size_t(0), size_t(0)) );
+    BOOST_CHECK( visited[2] == std::make_pair(size_t(99999), size_t(4)) );
+}
+
+BOOST_AUTO_TEST_CASE( visitedPairs ) {
+    using namespace AIToolbox::MDP;
+
+    DenseVisitedPairs dense(100000, 5);
+    checkVisitedPairs(dense);
+
+    PagedVisitedPairs paged(100000, 5);
+    checkVisitedPairs(paged);
+    // The first two pairs share a page, the last is far away.
+    BOOST_CHECK_EQUAL( paged.getPages(), 2 );
+}
+
+template <typename V>
+void checkBatchUpdate() {
+    using namespace AIToolbox::MDP;
+
+    // A deterministic cycle where action a gives reward a + 1.
+    constexpr size_t S = 3, A = 2;
+    ai::Matrix3D transitions(A, ai::Matrix2D::Zero(S, S));
+    ai::Matrix2D rewards(S, A);
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            transitions[a](s, (s + 1) % S) = 1.0;
+            rewards(s, a) = a + 1.0;
+        }
+    }
+    Model model(ai::NO_CHECK, S, A, std::move(transitions), std::move(rewards), 0.5);
+    model.setSamplingIndex(true);
+
+    DynaQ<Model, V> solver(model, 0.5, 20);
+
+    // Without visited pairs there is nothing to replay.
+    solver.batchUpdateQ();
+    BOOST_CHECK_EQUAL( solver.getQFunction().sum(), 0.0 );
+
+    solver.stepUpdateQ(0, 1, 1, 2.0);
+    for ( unsigned i = 0; i < 10; ++i )
+        solver.batchUpdateQ();
+    BOOST_CHECK_CLOSE( solver.getQFunction()(0, 1), 2.0, 0.001 );
+
+    solver.stepUpdateQ(1, 0, 2, 1.0);
+    for ( unsigned i = 0; i < 10; ++i )
+        solver.batchUpdateQ();
+    BOOST_CHECK_CLOSE( solver.getQFunction()(1, 0), 1.0, 0.001 );
+    BOOST_CHECK_CLOSE( solver.getQFunction()(0, 1), 2.5, 0.001 );
+
+    // Unvisited pairs are never replayed.
+    BOOST_CHECK_EQUAL( solver.getQFunction()(2, 0), 0.0 );
+    BOOST_CHECK_EQUAL( solver.getVisitedPairs().size(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( batchUpdates ) {
+    using namespace AIToolbox::MDP;
+
+    checkBatchUpdate<DenseVisitedPairs>();
+    checkBatchUpdate<PagedVisitedPairs>();
+}
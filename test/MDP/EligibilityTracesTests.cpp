@@ -0,0 +1,103 @@
+#define BOOST_TEST_MODULE MDP_EligibilityTraces
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/Utils/EligibilityTraces.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+
+#include <cmath>
+
+namespace aif = AIToolbox::MDP;
+
+double getTrace(const aif::EligibilityTraces & traces, const size_t s, const size_t a) {
+    for (const auto & [ss, aa, el] : traces.getTraces())
+        if (ss == s && aa == a) return el;
+    return 0.0;
+}
+
+BOOST_AUTO_TEST_CASE( decayAndUpdate ) {
+    aif::EligibilityTraces traces(2);
+    auto q = aif::makeQFunction(3, 2);
+
+    traces.update(q, 0, 1, 1.0, 0.5, 0.1);
+    traces.update(q, 2, 0, 2.0, 0.5, 0.1);
+
+    BOOST_CHECK_EQUAL( traces.size(), 2 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 1), 0.5 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 2, 0), 1.0 );
+
+    // (0,1) got 1.0 from the first update and 2.0 * 0.5 from the second.
+    BOOST_CHECK_EQUAL( q(0, 1), 2.0 );
+    BOOST_CHECK_EQUAL( q(2, 0), 2.0 );
+
+    // Revisiting a pair resets its trace to 1.
+    traces.update(q, 0, 1, 1.0, 0.5, 0.1);
+    BOOST_CHECK_EQUAL( traces.size(), 2 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 1), 1.0 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 2, 0), 0.5 );
+    BOOST_CHECK_EQUAL( q(0, 1), 3.0 );
+    BOOST_CHECK_EQUAL( q(2, 0), 2.5 );
+}
+
+BOOST_AUTO_TEST_CASE( cutoff ) {
+    aif::EligibilityTraces traces(1);
+    auto q = aif::makeQFunction(4, 1);
+
+    // With discount 0.5 and cutoff 0.2, a trace survives two more steps.
+    for (size_t s = 0; s < 4; ++s)
+        traces.update(q, s, 0, 1.0, 0.5, 0.2);
+
+    BOOST_CHECK_EQUAL( traces.size(), 3 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 0), 0.0 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 1, 0), 0.25 );
+
+    // The removed trace was not updated in its last step.
+    BOOST_CHECK_EQUAL( q(0, 0), 1.75 );
+    BOOST_CHECK_EQUAL( q(1, 0), 1.75 );
+    BOOST_CHECK_EQUAL( q(2, 0), 1.5 );
+    BOOST_CHECK_EQUAL( q(3, 0), 1.0 );
+
+    // A zero discount drops everything but the current pair.
+    traces.update(q, 0, 0, 1.0, 0.0, 0.2);
+    BOOST_CHECK_EQUAL( traces.size(), 1 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 0), 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE( renormalization ) {
+    aif::EligibilityTraces traces(2);
+    auto q = aif::makeQFunction(1, 2);
+
+    // Without cutoff the first trace is never removed, and the global
+    // scale goes well past the point where it gets folded back.
+    constexpr unsigned steps = 300;
+    traces.update(q, 0, 0, 0.0, 0.5, 0.0);
+    for (unsigned i = 1; i < steps; ++i)
+        traces.update(q, 0, 1, 0.0, 0.5, 0.0);
+
+    const double expected = std::pow(0.5, steps - 1);
+    BOOST_CHECK_CLOSE( getTrace(traces, 0, 0), expected, 1e-9 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 1), 1.0 );
+
+    traces.update(q, 0, 1, 1.0, 1.0, 0.0);
+    BOOST_CHECK_CLOSE( q(0, 0), expected, 1e-9 );
+    BOOST_CHECK_EQUAL( q(0, 1), 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE( setAndGet ) {
+    aif::EligibilityTraces traces(3);
+    auto q = aif::makeQFunction(2, 3);
+
+    traces.setTraces({{0, 2, 0.5}, {1, 1, 0.25}});
+    BOOST_CHECK_EQUAL( traces.size(), 2 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 0, 2), 0.5 );
+    BOOST_CHECK_EQUAL( getTrace(traces, 1, 1), 0.25 );
+
+    traces.update(q, 1, 1, 4.0, 0.5, 0.01);
+    BOOST_CHECK_EQUAL( q(0, 2), 1.0 );
+    BOOST_CHECK_EQUAL( q(1, 1), 4.0 );
+
+    traces.clear();
+    BOOST_CHECK_EQUAL( traces.size(), 0 );
+    BOOST_CHECK( traces.getTraces().empty() );
+}
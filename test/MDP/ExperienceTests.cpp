@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <fstream>
 #include <cstdio>
+#include <random>
 
 BOOST_AUTO_TEST_CASE( eigen_experience ) {
     BOOST_CHECK(AIToolbox::MDP::is_experience_eigen_v<AIToolbox::MDP::Experience>);
@@ -140,3 +141,158 @@ BOOST_AUTO_TEST_CASE( files ) {
         std::remove(outputFilename.c_str());
     }
 }
+
+BOOST_AUTO_TEST_CASE( merge ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 4, A = 3;
+
+    Experience all(S, A), first(S, A), second(S, A);
+
+    std::mt19937 rand(12345);
+    std::uniform_int_distribution<size_t> sDist(0, S-1), aDist(0, A-1);
+    std::normal_distribution<double> rDist(3.0, 2.0);
+
+    for ( size_t i = 0; i < 1000; ++i ) {
+        const auto s = sDist(rand), a = aDist(rand), s1 = sDist(rand);
+        const auto r = rDist(rand);
+
+        all.record(s, a, s1, r);
+        // We split unevenly so that some pairs are only seen by one.
+        if ( i % 3 == 0 || s == 0 ) first.record(s, a, s1, r);
+        else second.record(s, a, s1, r);
+    }
+
+    first.merge(second);
+
+    BOOST_CHECK_EQUAL(first.getTimesteps(), all.getTimesteps());
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            BOOST_CHECK_EQUAL(first.getVisitsSum(s, a), all.getVisitsSum(s, a));
+            BOOST_CHECK(AIToolbox::checkEqualGeneral(first.getReward(s, a), all.getReward(s, a)));
+            BOOST_CHECK(AIToolbox::checkEqualGeneral(first.getM2(s, a), all.getM2(s, a)));
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(first.getVisits(s, a, s1), all.getVisits(s, a, s1));
+        }
+    }
+
+    Experience wrong(S + 1, A);
+    BOOST_CHECK_THROW(first.merge(wrong), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE( batchRecording ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 5, A = 3, N = 2000;
+
+    std::mt19937 rand(54321);
+    std::uniform_int_distribution<size_t> sDist(0, S-1), aDist(0, A-1);
+    std::normal_distribution<double> rDist(-1.0, 4.0);
+
+    std::vector<size_t> s(N), a(N), s1(N);
+    std::vector<double> r(N);
+    for ( size_t i = 0; i < N; ++i ) {
+        s[i] = sDist(rand); a[i] = aDist(rand); s1[i] = sDist(rand);
+        r[i] = rDist(rand);
+    }
+
+    Experience serial(S, A), batch(S, A);
+
+    // We also check that batches combine correctly with previous data.
+    for ( size_t i = 0; i < N / 4; ++i ) {
+        serial.record(s[i], a[i], s1[i], r[i]);
+        batch.record(s[i], a[i], s1[i], r[i]);
+    }
+    for ( size_t i = N / 4; i < N; ++i )
+        serial.record(s[i], a[i], s1[i], r[i]);
+
+    batch.recordBatch(N - N / 4, s.data() + N / 4, a.data() + N / 4, s1.data() + N / 4, r.data() + N / 4);
+
+    BOOST_CHECK_EQUAL(batch.getTimesteps(), serial.getTimesteps());
+    for ( size_t ss = 0; ss < S; ++ss ) {
+        for ( size_t aa = 0; aa < A; ++aa ) {
+            BOOST_CHECK_EQUAL(batch.getVisitsSum(ss, aa), serial.getVisitsSum(ss, aa));
+            BOOST_CHECK(AIToolbox::checkEqualGeneral(batch.getReward(ss, aa), serial.getReward(ss, aa)));
+            BOOST_CHECK(AIToolbox::checkEqualGeneral(batch.getM2(ss, aa), serial.getM2(ss, aa)));
+            for ( size_t ss1 = 0; ss1 < S; ++ss1 )
+                BOOST_CHECK_EQUAL(batch.getVisits(ss, aa, ss1), serial.getVisits(ss, aa, ss1));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( versions ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 4, A = 2;
+
+    Experience exp(S, A);
+
+    auto v = exp.getVersion();
+    const auto untouched = exp.getVersion(3, 1);
+
+    exp.record(1, 0, 2, 1.0);
+    BOOST_CHECK(exp.getVersion() > v);
+    BOOST_CHECK(exp.getVersion(1, 0) > v);
+    BOOST_CHECK_EQUAL(exp.getVersion(3, 1), untouched);
+
+    v = exp.getVersion();
+    const size_t s[] = {2, 2}, a[] = {1, 1}, s1[] = {0, 3};
+    const double r[] = {0.5, 1.5};
+    exp.recordBatch(2, s, a, s1, r);
+    BOOST_CHECK(exp.getVersion(2, 1) > v);
+    BOOST_CHECK(exp.getVersion(1, 0) <= v);
+
+    v = exp.getVersion();
+    exp.reset();
+    for ( size_t ss = 0; ss < S; ++ss )
+        for ( size_t aa = 0; aa < A; ++aa )
+            BOOST_CHECK(exp.getVersion(ss, aa) > v);
+}
+
+BOOST_AUTO_TEST_CASE( dirtyPairs ) {
+    using namespace AIToolbox::MDP;
+    using Pairs = std::vector<std::pair<size_t, size_t>>;
+    const size_t S = 4, A = 2;
+
+    Experience exp(S, A), other(S, A);
+    BOOST_CHECK(exp.getEpoch() != other.getEpoch());
+
+    const auto v0 = exp.getVersion();
+    BOOST_CHECK(exp.getDirtyPairs(v0).empty());
+
+    // Each pair is listed once, in order of last modification.
+    exp.record(1, 0, 2, 1.0);
+    exp.record(3, 1, 0, 1.0);
+    exp.record(1, 0, 3, 1.0);
+    const size_t s[] = {2, 2}, a[] = {1, 1}, s1[] = {0, 3};
+    const double r[] = {0.5, 1.5};
+    exp.recordBatch(2, s, a, s1, r);
+
+    BOOST_CHECK(exp.getDirtyPairs(v0) == (Pairs{{3, 1}, {1, 0}, {2, 1}}));
+
+    // Reading does not consume the pairs, so other readers still see them.
+    BOOST_CHECK(exp.getDirtyPairs(v0) == (Pairs{{3, 1}, {1, 0}, {2, 1}}));
+
+    const auto v1 = exp.getVersion();
+    BOOST_CHECK(exp.getDirtyPairs(v1).empty());
+    exp.record(1, 0, 2, 1.0);
+    BOOST_CHECK(exp.getDirtyPairs(v1) == (Pairs{{1, 0}}));
+    BOOST_CHECK(exp.getDirtyPairs(v0) == (Pairs{{3, 1}, {2, 1}, {1, 0}}));
+
+    // Many modifications of the same pairs are still listed once each.
+    for ( unsigned i = 0; i < 500; ++i )
+        exp.record(i % 2, 1, 0, 1.0);
+    BOOST_CHECK(exp.getDirtyPairs(v1) == (Pairs{{1, 0}, {0, 1}, {1, 1}}));
+
+    // Copies always start a new epoch, even from an older copy.
+    Experience copy = exp;
+    BOOST_CHECK(copy.getEpoch() != exp.getEpoch());
+    const auto epoch = exp.getEpoch();
+    exp = copy;
+    BOOST_CHECK(exp.getEpoch() != epoch);
+    BOOST_CHECK(exp.getEpoch() != copy.getEpoch());
+
+    // Changes to all pairs start a new epoch instead.
+    const auto epoch2 = exp.getEpoch();
+    exp.record(2, 0, 2, 1.0);
+    exp.reset();
+    BOOST_CHECK(exp.getEpoch() != epoch2);
+    BOOST_CHECK(exp.getDirtyPairs(exp.getVersion()).empty());
+}
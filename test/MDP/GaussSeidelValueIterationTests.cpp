@@ -0,0 +1,107 @@
+#define BOOST_TEST_MODULE MDP_GaussSeidelValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/GaussSeidelValueIteration.hpp>
+
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include "Utils/OldMDPModel.hpp"
+#include "Utils/CornerProblemSolution.hpp"
+
+namespace ai = AIToolbox;
+namespace aif = AIToolbox::MDP;
+
+aif::Model makeChainProblem(const size_t S) {
+    // A chain where action 0 moves towards the absorbing state 0, and
+    // action 1 stays put. Only reaching state 0 gives reward.
+    ai::Matrix3D transitions(2, ai::Matrix2D::Zero(S, S));
+    ai::Matrix2D rewards = ai::Matrix2D::Zero(S, 2);
+
+    transitions[0](0, 0) = 1.0;
+    transitions[1](0, 0) = 1.0;
+    for ( size_t s = 1; s < S; ++s ) {
+        transitions[0](s, s - 1) = 1.0;
+        transitions[1](s, s) = 1.0;
+    }
+    rewards(1, 0) = 1.0;
+
+    return aif::Model(ai::NO_CHECK, S, 2, std::move(transitions), std::move(rewards), 0.9);
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCorners ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+
+    for ( const bool prioritized : {false, true} ) {
+        GaussSeidelValueIteration solver(1000000, 0.00001, {Values(), Actions(0)}, prioritized);
+        auto [bound, vfun, qfun] = solver(model);
+
+        BOOST_CHECK( bound <= solver.getTolerance() );
+        checkCornerProblemSolution(vfun, 0.0001);
+
+        // The QFunction is built from the returned values.
+        for ( size_t s = 0; s < model.getS(); ++s )
+            BOOST_CHECK_SMALL( qfun(s, vfun.actions[s]) - vfun.values[s], 0.0001 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersSparse ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+
+    for ( const bool prioritized : {false, true} ) {
+        GaussSeidelValueIteration solver(1000000, 0.00001, {Values(), Actions(0)}, prioritized);
+        auto [bound, vfun, qfun] = solver(model);
+
+        BOOST_CHECK( bound <= solver.getTolerance() );
+        checkCornerProblemSolution(vfun, 0.0001);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersNonEigen ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    OldMDPModel model = makeCornerProblem(grid);
+
+    for ( const bool prioritized : {false, true} ) {
+        GaussSeidelValueIteration solver(1000000, 0.00001, {Values(), Actions(0)}, prioritized);
+        auto [bound, vfun, qfun] = solver(model);
+
+        BOOST_CHECK( bound <= solver.getTolerance() );
+        checkCornerProblemSolution(vfun, 0.0001);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( chainConvergesInFewSweeps ) {
+    using namespace AIToolbox::MDP;
+
+    constexpr size_t S = 50;
+    const auto model = makeChainProblem(S);
+
+    // Sweeping states in order propagates the reward through the whole
+    // chain in a single sweep, while Jacobi iterations need one per state.
+    GaussSeidelValueIteration gs(1000000, 0.00001);
+    auto [bound, vfun, qfun] = gs(model);
+
+    BOOST_CHECK( bound <= gs.getTolerance() );
+    BOOST_CHECK_EQUAL( gs.getSweeps(), 2 );
+
+    for ( size_t s = 1; s < S; ++s ) {
+        BOOST_CHECK_EQUAL( vfun.actions[s], 0 );
+        BOOST_CHECK_SMALL( vfun.values[s] - std::pow(0.9, s - 1), 0.0001 );
+    }
+
+    // Values are computed without needing a full horizon.
+    GaussSeidelValueIteration gsHorizon(1, 0.0);
+    auto [hBound, hVfun, hQfun] = gsHorizon(model);
+    BOOST_CHECK_EQUAL( gsHorizon.getSweeps(), 1 );
+    BOOST_CHECK_SMALL( hVfun.values[S-1] - std::pow(0.9, S-2), 0.000001 );
+}
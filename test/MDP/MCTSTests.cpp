@@ -4,7 +4,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include <AIToolbox/MDP/Algorithms/MCTS.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/Policies/QGreedyPolicy.hpp>
 
 #include <AIToolbox/MDP/Environments/CornerProblem.hpp>
 
@@ -97,9 +99,267 @@ BOOST_AUTO_TEST_CASE( sampleOneTime ) {
 
     auto & graph_ = solver.getGraph();
     // We find the leaf we just produced
-    auto it = graph_.children[0].children.begin();
-    auto s1 = it->first;
+    const auto root = graph_.getRoot();
+    auto s1 = graph_.getNode(graph_.getEdges(root)[0].child).key;
 
     // We make a,o the new head
     solver.sampleAction( 0, s1, horizon - 1);
 }
+
+BOOST_AUTO_TEST_CASE( parallelSearch ) {
+    using namespace AIToolbox::MDP;
+    using namespace GridWorldEnums;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    for (const auto p : {MCTSParallelism::Root, MCTSParallelism::Tree}) {
+        MCTS solver(model, 10000, 5.0, 4);
+        solver.setParallelism(p);
+        BOOST_CHECK_EQUAL( solver.getThreads(), 4 );
+
+        BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+
+        // All simulations end up at the root, whatever the mode.
+        const auto & graph = solver.getGraph();
+        const auto root = graph.getRoot();
+        BOOST_CHECK_EQUAL( graph.getNode(root).N, 10000 );
+        unsigned visits = 0;
+        for (size_t a = 0; a < model.getA(); ++a) {
+            const auto & an = graph.getEdges(root)[a];
+            visits += an.N;
+            BOOST_CHECK_EQUAL( an.pending, 0 );
+        }
+        BOOST_CHECK_EQUAL( visits, 10000 );
+
+        BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+        BOOST_CHECK_EQUAL( solver.sampleAction(7,10), DOWN);
+        BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+
+        // Tree reuse works as in the sequential case.
+        auto a = solver.sampleAction(13,10);
+        BOOST_CHECK_EQUAL( a, RIGHT );
+        BOOST_CHECK_EQUAL( solver.sampleAction(a, 14, 9), RIGHT);
+    }
+
+    MCTS solver(model, 10000, 5.0, 4);
+    solver.setRootMerge(MCTSRootMerge::Values);
+    BOOST_CHECK_EQUAL( solver.sampleAction(2,10), LEFT);
+
+    BOOST_CHECK_THROW( solver.setVirtualLoss(-1.0), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( treeMemoryReuse ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    const unsigned iterations = 1000;
+    MCTS solver(model, iterations, 5.0);
+
+    // Every simulation adds at most one node, and discarded branches are
+    // recycled before the arena grows; so the arena never holds more
+    // nodes than a single search can create, however many searches we do.
+    size_t s = 5;
+    for (unsigned i = 0; i < 20; ++i) {
+        const auto a = solver.sampleAction(s, 10);
+        const auto & graph = solver.getGraph();
+
+        const auto root = graph.getRoot();
+        const auto child = graph.getEdges(root)[a].child;
+        if (child != graph.None && i % 5) {
+            // Reuse the subtree of the first outcome of the chosen action.
+            const auto s1 = graph.getNode(child).key;
+            const auto N = graph.getNode(child).N;
+            solver.sampleAction(a, s1, 10);
+
+            // The kept subtree keeps its statistics.
+            BOOST_CHECK_EQUAL( graph.getNode(graph.getRoot()).N, N + iterations );
+            s = s1;
+        }
+        BOOST_CHECK( graph.getAllocatedNodes() <= iterations + 1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( deadlineSearch ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    // The iterations are ignored when searching with a deadline.
+    MCTS solver(model, 1, 5.0);
+    const auto & graph = solver.getGraph();
+
+    SearchStatistics stats;
+    const auto start = SearchClock::now();
+    const auto deadline = start + std::chrono::milliseconds(50);
+
+    const auto a = solver.sampleAction(1, 10, deadline, &stats);
+    BOOST_CHECK( SearchClock::now() >= deadline );
+
+    BOOST_CHECK( stats.simulations > 1 );
+    BOOST_CHECK( stats.maxDepth > 0 );
+    BOOST_CHECK( stats.maxDepth < 10 );
+    BOOST_CHECK_EQUAL( stats.rootVisits.size(), model.getA() );
+
+    unsigned visits = 0;
+    for (const auto v : stats.rootVisits) visits += v;
+    BOOST_CHECK_EQUAL( visits, stats.simulations );
+    BOOST_CHECK_EQUAL( graph.getNode(graph.getRoot()).N, stats.simulations );
+
+    // Reusing the tree, the root visits include the ones of the kept subtree.
+    const auto child = graph.getEdges(graph.getRoot())[a].child;
+    if (child != graph.None) {
+        const auto s1 = graph.getNode(child).key;
+        const auto N = graph.getNode(child).N;
+
+        solver.sampleAction(a, s1, 9, SearchClock::now() + std::chrono::milliseconds(10), &stats);
+
+        visits = 0;
+        for (const auto v : stats.rootVisits) visits += v;
+        BOOST_CHECK_EQUAL( visits, N + stats.simulations );
+    }
+
+    // An expired deadline still runs a single simulation.
+    solver.sampleAction(1, 10, start, &stats);
+    BOOST_CHECK_EQUAL( stats.simulations, 1 );
+
+    // With multiple threads, all of them simulate until the deadline.
+    for (const auto p : {MCTSParallelism::Root, MCTSParallelism::Tree}) {
+        MCTS psolver(model, 1, 5.0, 4);
+        psolver.setParallelism(p);
+
+        psolver.sampleAction(1, 10, SearchClock::now() + std::chrono::milliseconds(50), &stats);
+        BOOST_CHECK( stats.simulations >= 4 );
+
+        visits = 0;
+        for (const auto v : stats.rootVisits) visits += v;
+        BOOST_CHECK_EQUAL( visits, stats.simulations );
+
+        const auto & pgraph = psolver.getGraph();
+        BOOST_CHECK_EQUAL( pgraph.getNode(pgraph.getRoot()).N, stats.simulations );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( rolloutPolicyAndLeafEvaluator ) {
+    using namespace AIToolbox::MDP;
+    using namespace GridWorldEnums;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    ValueIteration vi(1000000, 0.00001);
+    const auto q = std::get<2>(vi(model));
+    QGreedyPolicy policy(q);
+
+    // With a good rollout policy far fewer iterations are needed.
+    MCTS solver(model, 500, 5.0);
+    solver.setRolloutPolicy(&policy);
+    BOOST_CHECK_EQUAL( solver.getRolloutPolicy(), &policy );
+
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(7,10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+
+    // Same if we value leaves directly, without rollouts.
+    solver.setRolloutPolicy(nullptr);
+    solver.setRolloutDepth(0);
+    solver.setLeafEvaluator(q);
+    BOOST_CHECK_EQUAL( solver.getRolloutDepth(), 0 );
+
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(7,10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+
+    // The evaluator is only called on rollouts truncated before the horizon.
+    unsigned calls = 0;
+    solver.setLeafEvaluator([&calls](size_t) { ++calls; return 0.0; });
+    solver.setRolloutDepth(std::numeric_limits<unsigned>::max());
+    solver.sampleAction(5, 10);
+    BOOST_CHECK_EQUAL( calls, 0 );
+
+    solver.setRolloutDepth(2);
+    solver.sampleAction(5, 10);
+    BOOST_CHECK( calls > 0 );
+
+    // Multithreaded searches can use a rollout policy too.
+    for (const auto p : {MCTSParallelism::Root, MCTSParallelism::Tree}) {
+        MCTS psolver(model, 2000, 5.0, 4);
+        psolver.setParallelism(p);
+        psolver.setRolloutPolicy(&policy);
+
+        BOOST_CHECK_EQUAL( psolver.sampleAction(1,10), LEFT);
+        BOOST_CHECK_EQUAL( psolver.sampleAction(14,10), RIGHT);
+    }
+
+    QFunction bad = QFunction::Zero(model.getS(), model.getA() + 1);
+    QGreedyPolicy badPolicy(bad);
+    BOOST_CHECK_THROW( solver.setRolloutPolicy(&badPolicy), std::invalid_argument );
+    BOOST_CHECK_THROW( solver.setLeafEvaluator(bad), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( transpositionSearch ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+    using namespace GridWorldEnums;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    MCTS solver(model, 10000, 5.0);
+    solver.setTranspositionTableSize(1000);
+    BOOST_CHECK_EQUAL( solver.getTranspositionTableSize(), 1000 );
+
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(7,10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(13,10), RIGHT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+
+    // There are only 16 states, so even over many searches the graph
+    // stays small, and the internal tree is not used at all.
+    const auto & table = solver.getTranspositionTable();
+    BOOST_CHECK( table.size() > 0 );
+    BOOST_CHECK( table.size() <= 16 * 10 );
+    BOOST_CHECK( !solver.getGraph().isExpanded(solver.getGraph().getRoot()) );
+
+    // Nodes are kept between searches, even when starting from a new state.
+    SearchStatistics stats;
+    solver.sampleAction(5, 10, SearchClock::now(), &stats);
+    solver.sampleAction(5, 10, SearchClock::now(), &stats);
+
+    unsigned visits = 0;
+    for (const auto v : stats.rootVisits) visits += v;
+    BOOST_CHECK_EQUAL( visits, stats.simulations + 1 );
+
+    // With a tiny table, memory stays flat over long sessions, and old
+    // nodes are replaced.
+    solver.setTranspositionTableSize(8);
+    BOOST_CHECK_EQUAL( table.size(), 0 );
+
+    size_t s = 5;
+    for (unsigned i = 0; i < 50; ++i) {
+        const auto a = solver.sampleAction(s, 10);
+        BOOST_CHECK( a < model.getA() );
+        BOOST_CHECK( table.size() <= 8 );
+
+        s = std::get<0>(model.sampleSR(s, a));
+        if (model.isTerminal(s)) s = 5;
+    }
+    BOOST_CHECK_EQUAL( table.getCapacity(), 8 );
+
+    // Going back to the tree.
+    solver.setTranspositionTableSize(0);
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK( solver.getGraph().isExpanded(solver.getGraph().getRoot()) );
+}
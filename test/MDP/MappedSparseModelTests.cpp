@@ -0,0 +1,155 @@
+#define BOOST_TEST_MODULE MDP_MappedSparseModel
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/IO.hpp>
+#include <AIToolbox/MDP/MappedSparseModel.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE( eigen_model ) {
+    BOOST_CHECK(AIToolbox::MDP::is_model_eigen_v<AIToolbox::MDP::MappedSparseModel>);
+    BOOST_CHECK(AIToolbox::MDP::has_engine_sampling_v<AIToolbox::MDP::MappedSparseModel>);
+}
+
+BOOST_AUTO_TEST_CASE( mapping ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel m = makeCornerProblem(grid);
+    m.setDiscount(0.95);
+
+    std::string outputFilename = "./mappedSparseModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( writeBinary(outputFile, m) );
+    }
+    {
+        auto mapped = std::make_unique<MappedSparseModel>(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), mapped->getS());
+        BOOST_CHECK_EQUAL(m.getA(), mapped->getA());
+        BOOST_CHECK_EQUAL(m.getDiscount(), mapped->getDiscount());
+
+        // Copies share the mapping, which outlives the original.
+        const MappedSparseModel m2 = *mapped;
+        mapped.reset();
+
+        for ( size_t a = 0; a < m.getA(); ++a ) {
+            BOOST_CHECK_EQUAL(m.getTransitionFunction(a).nonZeros(), m2.getTransitionFunction(a).nonZeros());
+            BOOST_CHECK(m.getTransitionFunction(a).isApprox(m2.getTransitionFunction(a)));
+        }
+        BOOST_CHECK(m.getRewardFunction().isApprox(m2.getRewardFunction()));
+
+        for ( size_t s = 0; s < m.getS(); ++s ) {
+            BOOST_CHECK_EQUAL(m.isTerminal(s), m2.isTerminal(s));
+            for ( size_t a = 0; a < m.getA(); ++a ) {
+                BOOST_CHECK(m2.getTransitionProbability(s, a, std::get<0>(m2.sampleSR(s, a))) > 0.0);
+                for ( size_t s1 = 0; s1 < m.getS(); ++s1 ) {
+                    BOOST_CHECK_EQUAL(m.getTransitionProbability(s, a, s1), m2.getTransitionProbability(s, a, s1));
+                    BOOST_CHECK_EQUAL(m.getExpectedReward(s, a, s1), m2.getExpectedReward(s, a, s1));
+                }
+            }
+        }
+
+        // Planning works on the mapping directly.
+        ValueIteration solver(1000000, 0.001);
+        const auto q1 = std::get<2>(solver(m));
+        const auto q2 = std::get<2>(solver(m2));
+        BOOST_CHECK(q1.isApprox(q2));
+
+        // The file still holds a double model.
+        BOOST_CHECK_THROW(MappedSparseModelT<float>{outputFilename}, std::runtime_error);
+    }
+    {
+        // A dense model can't be mapped.
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        BOOST_CHECK( writeBinary(outputFile, Model(m)) );
+    }
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( mappingSinglePrecision ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModelT<float> m = makeCornerProblem(grid);
+
+    std::string outputFilename = "./mappedFloatSparseModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( writeBinary(outputFile, m) );
+    }
+    {
+        const MappedSparseModelT<float> m2(outputFilename);
+
+        for ( size_t a = 0; a < m.getA(); ++a )
+            BOOST_CHECK(m.getTransitionFunction(a).isApprox(m2.getTransitionFunction(a)));
+        BOOST_CHECK(m.getRewardFunction().isApprox(m2.getRewardFunction()));
+    }
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( mappingCorrupted ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel m = makeCornerProblem(grid);
+
+    std::ostringstream os(std::ios::binary);
+    writeBinary(os, m);
+    const std::string data = os.str();
+
+    std::string outputFilename = "./mappedCorruptedSparseModel.bin";
+    const auto writeTruncated = [&](size_t size) {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        outputFile.write(data.data(), size);
+    };
+    const auto writeCorrupted = [&](size_t offset, std::uint64_t value) {
+        std::string corrupted = data;
+        std::memcpy(&corrupted[offset], &value, sizeof(value));
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        outputFile.write(corrupted.data(), corrupted.size());
+    };
+
+    writeTruncated(data.size() / 2);
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+
+    // Shorter than the header, and empty.
+    writeTruncated(16);
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+    writeTruncated(0);
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+
+    // A discount of zero.
+    writeCorrupted(48, 0);
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+
+    // Column indices out of range, right after the first outer index.
+    const size_t innerOffset = 64 + 8 + (m.getS() + 1) * sizeof(int);
+    writeCorrupted((innerOffset + 7) / 8 * 8, std::uint64_t(1) << 40);
+    BOOST_CHECK_THROW(MappedSparseModel{outputFilename}, std::runtime_error);
+
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
@@ -180,3 +180,75 @@ BOOST_AUTO_TEST_CASE( IO ) {
     }
 }
 */
+
+BOOST_AUTO_TEST_CASE( dirtySyncing ) {
+    using namespace AIToolbox::MDP;
+    using Pairs = std::vector<std::pair<size_t, size_t>>;
+    const size_t S = 5, A = 3;
+
+    Experience exp(S, A);
+    MaximumLikelihoodModel<Experience> model(exp, 1.0, false), reference(exp, 1.0, false);
+
+    // Whatever the Experience did before does not matter after this.
+    model.syncDirty();
+    BOOST_CHECK(model.syncDirty().empty());
+
+    exp.record(1, 2, 3, 4.0);
+    exp.record(1, 2, 4, 2.0);
+    exp.record(0, 1, 0, -1.0);
+
+    const auto dirty = model.syncDirty();
+    BOOST_CHECK(dirty == (Pairs{{0, 1}, {1, 2}}));
+    BOOST_CHECK(model.syncDirty().empty());
+
+    reference.sync();
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            BOOST_CHECK_EQUAL(model.getExpectedReward(s, a, 0), reference.getExpectedReward(s, a, 0));
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(model.getTransitionProbability(s, a, s1), reference.getTransitionProbability(s, a, s1));
+        }
+    }
+
+    // A reset touches everything.
+    exp.reset();
+    BOOST_CHECK_EQUAL(model.syncDirty().size(), S * A);
+    BOOST_CHECK(model.syncDirty().empty());
+
+    // So does replacing the Experience, even with an older one.
+    Experience older(S, A);
+    older.record(2, 0, 1, 3.0);
+    exp.record(1, 1, 1, 1.0);
+    exp = older;
+    BOOST_CHECK_EQUAL(model.syncDirty().size(), S * A);
+    BOOST_CHECK_EQUAL(model.getTransitionProbability(2, 0, 1), 1.0);
+    BOOST_CHECK(model.syncDirty().empty());
+}
+
+BOOST_AUTO_TEST_CASE( dirtySyncingSharedExperience ) {
+    using namespace AIToolbox::MDP;
+    using Pairs = std::vector<std::pair<size_t, size_t>>;
+    const size_t S = 5, A = 3;
+
+    Experience exp(S, A);
+    MaximumLikelihoodModel<Experience> first(exp, 1.0, false), second(exp, 1.0, false);
+    first.syncDirty();
+    second.syncDirty();
+
+    // Both models see the same changes, whichever syncs first.
+    exp.record(1, 2, 3, 4.0);
+    BOOST_CHECK(first.syncDirty() == (Pairs{{1, 2}}));
+    exp.record(0, 1, 0, -1.0);
+    BOOST_CHECK(second.syncDirty() == (Pairs{{0, 1}, {1, 2}}));
+    BOOST_CHECK(first.syncDirty() == (Pairs{{0, 1}}));
+    BOOST_CHECK_EQUAL(first.getTransitionProbability(1, 2, 3), second.getTransitionProbability(1, 2, 3));
+
+    // Restoring an older copy of the same Experience resyncs everything.
+    const Experience backup = exp;
+    exp.record(1, 2, 4, 1.0);
+    first.syncDirty();
+    BOOST_CHECK_EQUAL(first.getTransitionProbability(1, 2, 3), 0.5);
+    exp = backup;
+    BOOST_CHECK_EQUAL(first.syncDirty().size(), S * A);
+    BOOST_CHECK_EQUAL(first.getTransitionProbability(1, 2, 3), 1.0);
+}
@@ -8,7 +8,9 @@
 
 #include <AIToolbox/MDP/Environments/CornerProblem.hpp>
 
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 BOOST_AUTO_TEST_CASE( eigen_model ) {
     BOOST_CHECK(AIToolbox::MDP::is_model_eigen_v<AIToolbox::MDP::Model>);
@@ -126,3 +128,168 @@ BOOST_AUTO_TEST_CASE( cassandraCorner ) {
         BOOST_CHECK(AIToolbox::checkEqualGeneral(m.getExpectedReward(s, a, s1), m2.getExpectedReward(s, a, s1)));
     }
 }
+
+BOOST_AUTO_TEST_CASE( samplingIndex ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    BOOST_CHECK(!model.isSamplingIndexEnabled());
+    BOOST_CHECK_EQUAL(model.getSamplingIndexMemory(), 0);
+
+    // Lazy index: memory grows only as pairs are sampled.
+    model.setSamplingIndex(true);
+    BOOST_CHECK(model.isSamplingIndexEnabled());
+    const auto emptyMemory = model.getSamplingIndexMemory();
+
+    constexpr unsigned N = 20000;
+    const size_t s = 5, a = 1;
+    std::vector<unsigned> counts(S, 0);
+    for ( unsigned i = 0; i < N; ++i )
+        ++counts[std::get<0>(model.sampleSR(s, a))];
+
+    BOOST_CHECK(model.getSamplingIndexMemory() > emptyMemory);
+    for ( size_t s1 = 0; s1 < S; ++s1 )
+        BOOST_CHECK_SMALL(double(counts[s1]) / N - model.getTransitionProbability(s, a, s1), 0.02);
+
+    // Eager index: every pair is built immediately.
+    model.setSamplingIndex(true, true);
+    const auto eagerMemory = model.getSamplingIndexMemory();
+    BOOST_CHECK(eagerMemory > emptyMemory);
+
+    // Each sampler takes at least its ids vector, its alias sampler and
+    // the shared_ptr reference counts, plus an id, a probability and an
+    // alias per possible outcome.
+    size_t minMemory = 0;
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            minMemory += sizeof(std::vector<size_t>) + sizeof(AIToolbox::VoseAliasSampler) + 2 * sizeof(int);
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                if ( model.getTransitionProbability(s, a, s1) > 0.0 )
+                    minMemory += 2 * sizeof(size_t) + sizeof(double);
+        }
+    }
+    BOOST_CHECK(eagerMemory - emptyMemory >= minMemory);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK(model.getTransitionProbability(s, a, std::get<0>(model.sampleSR(s, a))) > 0.0);
+
+    // Changing the transition function invalidates the index.
+    AIToolbox::DumbMatrix3D t(boost::extents[S][A][S]);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            t[s][a][(s + 1) % S] = 1.0;
+    model.setTransitionFunction(t);
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL(std::get<0>(model.sampleSR(s, a)), (s + 1) % S);
+
+    model.setSamplingIndex(false);
+    BOOST_CHECK_EQUAL(model.getSamplingIndexMemory(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( samplingIndexLoad ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    std::stringstream ss;
+    ss << model;
+
+    // Reading keeps the sampling index settings of the target.
+    Model loaded(S, A);
+    loaded.setSamplingIndex(true, true);
+    const auto emptyMemory = loaded.getSamplingIndexMemory();
+
+    BOOST_CHECK(ss >> loaded);
+    BOOST_CHECK(loaded.isSamplingIndexEnabled());
+    BOOST_CHECK(loaded.getSamplingIndexMemory() > 0);
+    BOOST_CHECK(loaded.getSamplingIndexMemory() != emptyMemory);
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK(loaded.getTransitionProbability(s, a, std::get<0>(loaded.sampleSR(s, a))) > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( binaryFiles ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto m = makeCornerProblem(grid);
+    m.setDiscount(0.95);
+
+    std::string outputFilename = "./binaryModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( writeBinary(outputFile, m) );
+    }
+    {
+        const auto m2 = loadBinaryModel(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), m2.getS());
+        BOOST_CHECK_EQUAL(m.getA(), m2.getA());
+        BOOST_CHECK_EQUAL(m.getDiscount(), m2.getDiscount());
+
+        for ( size_t a = 0; a < m.getA(); ++a )
+            BOOST_CHECK(m.getTransitionFunction(a) == m2.getTransitionFunction(a));
+        BOOST_CHECK(m.getRewardFunction() == m2.getRewardFunction());
+
+        // A dense file does not contain a sparse model.
+        BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+    }
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( binaryFilesCorrupted ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model m = makeCornerProblem(grid);
+
+    std::ostringstream os(std::ios::binary);
+    writeBinary(os, m);
+    const std::string data = os.str();
+
+    std::string outputFilename = "./binaryCorruptedModel.bin";
+    const auto writeCorrupted = [&](size_t offset, std::uint64_t value) {
+        std::string corrupted = data;
+        std::memcpy(&corrupted[offset], &value, sizeof(value));
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        outputFile.write(corrupted.data(), corrupted.size());
+    };
+
+    // Both an overflowing and a merely too large size must be rejected
+    // before allocating anything.
+    writeCorrupted(24, std::uint64_t(1) << 40);
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+
+    writeCorrupted(24, std::uint64_t(1) << 20);
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+
+    // The same holds for the number of actions, which sizes the
+    // transition vector before any matrix is read.
+    writeCorrupted(32, std::uint64_t(1) << 61);
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+
+    writeCorrupted(32, 0);
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+
+    // The models are built without checks, so the discount is validated.
+    writeCorrupted(48, 0);
+    BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
@@ -0,0 +1,127 @@
+#define BOOST_TEST_MODULE MDP_ModifiedPolicyIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/ModifiedPolicyIteration.hpp>
+
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include "Utils/OldMDPModel.hpp"
+#include "Utils/CornerProblemSolution.hpp"
+
+namespace ai = AIToolbox;
+namespace aif = AIToolbox::MDP;
+
+BOOST_AUTO_TEST_CASE( escapeToCorners ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+
+    ModifiedPolicyIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+
+    // The QFunction still contains the eliminated actions, and agrees
+    // with the returned values.
+    for ( size_t s = 0; s < model.getS(); ++s )
+        BOOST_CHECK_SMALL( qfun.row(s).maxCoeff() - vfun.values[s], 0.0001 );
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersNoSweeps ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+
+    // Without sweeps nor elimination this is plain value iteration.
+    ModifiedPolicyIteration solver(1000000, 0.00001, 0, false);
+    BOOST_CHECK_EQUAL( solver.getBackups(), 0 );
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+
+    BOOST_CHECK_EQUAL( solver.getEliminatedActions(), 0 );
+    BOOST_CHECK_EQUAL( solver.getBackups(), solver.getIterations() * model.getS() * model.getA() );
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersSparse ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+
+    ModifiedPolicyIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersNonEigen ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    OldMDPModel model = makeCornerProblem(grid);
+
+    ModifiedPolicyIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+}
+
+BOOST_AUTO_TEST_CASE( actionElimination ) {
+    using namespace AIToolbox::MDP;
+
+    // A cycle where every action moves forward, but action a only gives
+    // reward 1 - a/A. Action 0 is optimal everywhere, with value
+    // 1 / (1 - 0.9) = 10.
+    constexpr size_t S = 20, A = 40;
+    ai::Matrix3D transitions(A, ai::Matrix2D::Zero(S, S));
+    ai::Matrix2D rewards(S, A);
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            transitions[a](s, (s + 1) % S) = 1.0;
+            rewards(s, a) = 1.0 - static_cast<double>(a) / A;
+        }
+    }
+    Model model(ai::NO_CHECK, S, A, std::move(transitions), std::move(rewards), 0.9);
+
+    ModifiedPolicyIteration pruned(1000000, 0.00001, 10, true);
+    auto [bound, vfun, qfun] = pruned(model);
+
+    BOOST_CHECK( bound <= pruned.getTolerance() );
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_EQUAL( vfun.actions[s], 0 );
+        BOOST_CHECK_SMALL( vfun.values[s] - 10.0, 0.001 );
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_SMALL( qfun(s, a) - (10.0 - static_cast<double>(a) / A), 0.001 );
+    }
+
+    // After the first improvement step all values have moved by the same
+    // amount, so the MacQueen bounds collapse and every dominated action
+    // is dropped. Later steps only back up action 0.
+    BOOST_CHECK_EQUAL( pruned.getEliminatedActions(), S * (A - 1) );
+    BOOST_CHECK_EQUAL( pruned.getBackups(), S * A + (pruned.getIterations() - 1) * S );
+
+    ModifiedPolicyIteration full(1000000, 0.00001, 10, false);
+    full(model);
+
+    // Elimination does not change the values, so both converge together,
+    // but without it every step backs up all pairs.
+    BOOST_CHECK_EQUAL( full.getIterations(), pruned.getIterations() );
+    BOOST_CHECK_EQUAL( full.getEliminatedActions(), 0 );
+    BOOST_CHECK_EQUAL( full.getBackups(), full.getIterations() * S * A );
+    BOOST_CHECK( pruned.getBackups() < full.getBackups() );
+
+    // Evaluation sweeps make the algorithm converge in fewer iterations.
+    ModifiedPolicyIteration vi(1000000, 0.00001, 0, false);
+    vi(model);
+    BOOST_CHECK( pruned.getIterations() < vi.getIterations() );
+}
@@ -6,6 +6,7 @@
 #include <AIToolbox/MDP/Algorithms/Utils/PolicyEvaluation.hpp>
 #include <AIToolbox/MDP/Policies/Policy.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 
 #include <AIToolbox/MDP/Environments/CornerProblem.hpp>
 
@@ -75,3 +76,86 @@ BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     solution = ev(randomPolicy);
     checkSolution(truthHorizon10, std::get<1>(solution));
 }
+
+template <typename M>
+void checkLinearSolve(const M & model) {
+    using namespace AIToolbox::MDP;
+    const size_t S = model.getS(), A = model.getA();
+
+    Policy randomPolicy(S, A);
+
+    PolicyEvaluation<M> sweeps(model, 1000000, 1e-10);
+    const auto [sweepsBound, sweepsV, sweepsQ] = sweeps(randomPolicy);
+    (void)sweepsBound;
+
+    PolicyEvaluation<M> linear(model, 1000, 1e-12);
+    linear.setLinearSolve(true);
+    BOOST_CHECK(linear.getLinearSolve());
+
+    const auto [bound, v, q] = linear(randomPolicy);
+    BOOST_CHECK(bound < 1e-6);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_SMALL(v[s] - sweepsV[s], 1e-5);
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_SMALL(q(s, a) - sweepsQ(s, a), 1e-5);
+    }
+
+    // Warm starting from the solution should still give the solution.
+    linear.setValues(v);
+    const auto [bound2, v2, q2] = linear(randomPolicy);
+    (void)q2;
+    BOOST_CHECK(bound2 < 1e-6);
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL(v2[s] - v[s], 1e-6);
+}
+
+template <typename M>
+void checkLinearSolveFallback(const M & model) {
+    using namespace AIToolbox::MDP;
+    const size_t S = model.getS(), A = model.getA();
+
+    Policy randomPolicy(S, A);
+
+    // With a single iteration the solver can't converge, so we should
+    // get the same result as a single sweep.
+    PolicyEvaluation<M> sweeps(model, 1, 1e-12);
+    const auto [sweepsBound, sweepsV, sweepsQ] = sweeps(randomPolicy);
+
+    PolicyEvaluation<M> linear(model, 1, 1e-12);
+    linear.setLinearSolve(true);
+    const auto [bound, v, q] = linear(randomPolicy);
+
+    BOOST_CHECK_EQUAL(bound, sweepsBound);
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_EQUAL(v[s], sweepsV[s]);
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL(q(s, a), sweepsQ(s, a));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( linearSolve ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid, 0.8);
+    model.setDiscount(0.999);
+
+    checkLinearSolve(model);
+    checkLinearSolve(SparseModel(model));
+    checkLinearSolve(SparseModelT<float>(model));
+    checkLinearSolve(OldMDPModel(model));
+}
+
+BOOST_AUTO_TEST_CASE( linearSolveFallback ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid, 0.8);
+    model.setDiscount(0.999);
+
+    checkLinearSolveFallback(model);
+    checkLinearSolveFallback(SparseModel(model));
+}
@@ -94,3 +94,33 @@ BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     BOOST_CHECK_EQUAL( policy.getActionProbability(13, RIGHT), 1.0);
     BOOST_CHECK_EQUAL( policy.getActionProbability(14, RIGHT), 1.0);
 }
+
+BOOST_AUTO_TEST_CASE( linearSolve ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid, 0.8);
+    model.setDiscount(0.999);
+    const size_t S = model.getS(), A = model.getA();
+
+    PolicyIteration sweeps(1000000, 1e-9);
+    PolicyIteration linear(1000, 1e-12, true);
+    BOOST_CHECK(linear.getLinearSolve());
+    BOOST_CHECK(!sweeps.getLinearSolve());
+
+    const auto sweepsQ = sweeps(model);
+    const auto linearQ = linear(model);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_SMALL(linearQ(s, a) - sweepsQ(s, a), 1e-4);
+    }
+
+    // Single precision models are solved in double precision.
+    const auto floatQ = linear(SparseModelT<float>(model));
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_SMALL(floatQ(s, a) - sweepsQ(s, a), 1e-3);
+    }
+}
@@ -6,6 +6,7 @@
 #include <AIToolbox/MDP/Algorithms/PrioritizedSweeping.hpp>
 
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 #include <AIToolbox/MDP/Experience.hpp>
 #include <AIToolbox/MDP/MaximumLikelihoodModel.hpp>
 
@@ -65,3 +66,70 @@ BOOST_AUTO_TEST_CASE( cliff ) {
         state = grid.getAdjacent(DOWN, state);
     }
 }
+
+BOOST_AUTO_TEST_CASE( stackedSparseModel ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(12, 3);
+
+    SparseModel model = makeCliffProblem(grid);
+    SparseModel stackedModel(model);
+    stackedModel.setStackedTransitions(true);
+
+    PrioritizedSweeping solver(model);
+    PrioritizedSweeping stackedSolver(stackedModel);
+
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        for ( size_t a = 0; a < model.getA(); ++a ) {
+            solver.stepUpdateQ(s, a);
+            stackedSolver.stepUpdateQ(s, a);
+        }
+        solver.batchUpdateQ();
+        stackedSolver.batchUpdateQ();
+    }
+
+    BOOST_CHECK_EQUAL( solver.getQueueLength(), stackedSolver.getQueueLength() );
+    BOOST_CHECK( solver.getQFunction().isApprox(stackedSolver.getQFunction()) );
+}
+
+BOOST_AUTO_TEST_CASE( predecessorIndex ) {
+    using namespace AIToolbox::MDP;
+
+    // A chain where each state can only be reached from the previous one;
+    // the reward is in the last state. Updating the last state must only
+    // queue its real predecessor.
+    constexpr size_t S = 5, A = 2;
+
+    AIToolbox::DumbMatrix3D transitions(boost::extents[S][A][S]);
+    AIToolbox::DumbMatrix3D rewards(boost::extents[S][A][S]);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][0][std::min(s + 1, S - 1)] = 1.0;
+        transitions[s][1][s] = 1.0;
+    }
+    rewards[S-2][0][S-1] = 10.0;
+
+    Model model(S, A, transitions, rewards, 0.9);
+    PrioritizedSweeping solver(model, 0.01);
+
+    solver.stepUpdateQ(S-2, 0);
+
+    // Both (S-3, 0) and (S-2, 1) lead to S-2.
+    BOOST_CHECK_EQUAL(solver.getQueueLength(), 2);
+
+    solver.batchUpdateQ();
+    BOOST_CHECK(solver.getValueFunction().values[0] > 0.0);
+
+    // We now add a new transition to the model; the solver must be able to
+    // see it after a refresh.
+    PrioritizedSweeping solver2(model, 0.01);
+
+    transitions[0][1][0] = 0.0;
+    transitions[0][1][S-2] = 1.0;
+    model.setTransitionFunction(transitions);
+
+    solver2.updatePredecessors();
+    solver2.stepUpdateQ(S-2, 0);
+
+    BOOST_CHECK_EQUAL(solver2.getQueueLength(), 3);
+}
@@ -7,6 +7,18 @@
 #include <AIToolbox/Utils/Core.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/MDP/Policies/QGreedyPolicy.hpp>
+#include <AIToolbox/MDP/Policies/EpsilonPolicy.hpp>
+#include <AIToolbox/MDP/Policies/Policy.hpp>
+#include <AIToolbox/MDP/Algorithms/QLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/SARSA.hpp>
+#include <AIToolbox/MDP/Algorithms/SARSAL.hpp>
+#include <AIToolbox/MDP/Algorithms/ExpectedSARSA.hpp>
+#include <AIToolbox/MDP/Algorithms/DoubleQLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/HystereticQLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/RLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/QL.hpp>
+#include <AIToolbox/MDP/Algorithms/TreeBackupL.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
 
 BOOST_AUTO_TEST_CASE( sampling ) {
     using namespace AIToolbox;
@@ -118,3 +130,118 @@ BOOST_AUTO_TEST_CASE( getPolicy ) {
     BOOST_CHECK(checkEqualSmall(matrix(2,1), 1.0/3.0));
     BOOST_CHECK(checkEqualSmall(matrix(2,2), 1.0/3.0));
 }
+
+BOOST_AUTO_TEST_CASE( cache ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+    constexpr size_t S = 3, A = 3;
+
+    QLearning learner(S, A, 0.9, 0.5);
+    // Two tied actions in state 1.
+    learner.stepUpdateQ(1, 0, 0, 1.0);
+    learner.stepUpdateQ(1, 2, 0, 1.0);
+
+    Impl::Seeder::setRootSeed(7);
+    QGreedyPolicy p(learner.getQFunction());
+    Impl::Seeder::setRootSeed(7);
+    QGreedyPolicy cached(learner.getQFunction());
+
+    BOOST_CHECK(!cached.isCacheEnabled());
+    cached.enableCache(learner.getQFunctionVersion());
+    BOOST_CHECK(cached.isCacheEnabled());
+
+    // Same seed, so the cache must give exactly the same samples.
+    for (unsigned i = 0; i < 1000; ++i)
+        for (size_t s = 0; s < S; ++s)
+            BOOST_CHECK_EQUAL(p.sampleAction(s), cached.sampleAction(s));
+
+    BOOST_CHECK(p.getPolicy() == cached.getPolicy());
+    BOOST_CHECK_EQUAL(cached.getActionProbability(1, 0), 0.5);
+    BOOST_CHECK_EQUAL(cached.getActionProbability(1, 1), 0.0);
+
+    // Updating the learner invalidates the cache.
+    learner.stepUpdateQ(1, 1, 1, 10.0);
+    for (unsigned i = 0; i < 100; ++i)
+        BOOST_CHECK_EQUAL(cached.sampleAction(1), 1);
+    BOOST_CHECK_EQUAL(cached.getActionProbability(1, 1), 1.0);
+
+    cached.disableCache();
+    BOOST_CHECK(!cached.isCacheEnabled());
+    BOOST_CHECK_EQUAL(cached.sampleAction(1), 1);
+}
+
+BOOST_AUTO_TEST_CASE( batchedProbabilities ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+    constexpr size_t S = 3, A = 3;
+
+    auto q = makeQFunction(S, A);
+    q(0,0) = 45;
+    q(1,0) = 1001; q(1,1) = 1000.99; q(1,2) = 1001;
+
+    size_t version = 0;
+    QGreedyPolicy p(q);
+    EpsilonPolicy e(p, 0.3);
+    Policy table(p);
+
+    const auto check = [&](const MDP::PolicyInterface & policy) {
+        Vector out(A);
+        for (size_t s = 0; s < S; ++s) {
+            policy.getActionProbabilities(s, out);
+            for (size_t a = 0; a < A; ++a)
+                BOOST_CHECK(checkEqualSmall(out[a], policy.getActionProbability(s, a)));
+        }
+    };
+    check(p);
+    check(e);
+    check(table);
+
+    p.enableCache(version);
+    check(p);
+    check(e);
+}
+
+// Checks that a cached policy follows the updates of a learner: update is
+// called as update(s, a, s1, rew).
+template <typename L, typename U>
+void checkCacheFollowsLearner(L & learner, U update) {
+    using namespace AIToolbox::MDP;
+
+    QGreedyPolicy p(learner.getQFunction());
+    p.enableCache(learner.getQFunctionVersion());
+
+    update(0, 0, 1, 1.0);
+    BOOST_CHECK_EQUAL(p.sampleAction(0), 0);
+
+    const auto version = learner.getQFunctionVersion();
+    update(0, 2, 1, 100.0);
+    BOOST_CHECK(learner.getQFunctionVersion() != version);
+    BOOST_CHECK_EQUAL(p.sampleAction(0), 2);
+}
+
+BOOST_AUTO_TEST_CASE( cacheFollowsLearners ) {
+    using namespace AIToolbox::MDP;
+    constexpr size_t S = 2, A = 3;
+
+    const auto step = [](auto & l) {
+        return [&l](size_t s, size_t a, size_t s1, double r) { l.stepUpdateQ(s, a, s1, r); };
+    };
+    const auto stepSARSA = [](auto & l) {
+        return [&l](size_t s, size_t a, size_t s1, double r) { l.stepUpdateQ(s, a, s1, 0, r); };
+    };
+
+    { QLearning l(S, A, 0.9, 0.5);              checkCacheFollowsLearner(l, step(l)); }
+    { HystereticQLearning l(S, A, 0.9, 0.5);    checkCacheFollowsLearner(l, step(l)); }
+    { DoubleQLearning l(S, A, 0.9, 0.5);        checkCacheFollowsLearner(l, step(l)); }
+    { RLearning l(S, A, 0.5);                   checkCacheFollowsLearner(l, step(l)); }
+    { QL l(S, A, 0.9, 0.5);                     checkCacheFollowsLearner(l, step(l)); }
+    { TreeBackupL l(S, A, 0.9, 0.5);            checkCacheFollowsLearner(l, step(l)); }
+    { SARSA l(S, A, 0.9, 0.5);                  checkCacheFollowsLearner(l, stepSARSA(l)); }
+    { SARSAL l(S, A, 0.9, 0.5);                 checkCacheFollowsLearner(l, stepSARSA(l)); }
+    {
+        auto q = makeQFunction(S, A);
+        QGreedyPolicy target(q);
+        ExpectedSARSA l(q, target, 0.9, 0.5);
+        checkCacheFollowsLearner(l, step(l));
+    }
+}
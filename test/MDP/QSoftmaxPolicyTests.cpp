@@ -0,0 +1,84 @@
+#define BOOST_TEST_MODULE MDP_QSoftmaxPolicy
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cmath>
+
+#include <AIToolbox/Utils/Core.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Policies/QSoftmaxPolicy.hpp>
+#include <AIToolbox/MDP/Algorithms/QLearning.hpp>
+
+BOOST_AUTO_TEST_CASE( probabilities ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+    constexpr size_t S = 2, A = 3;
+
+    auto q = makeQFunction(S, A);
+    q(0,0) = 1.0;
+    q(0,1) = 2.0;
+    q(0,2) = 3.0;
+
+    QSoftmaxPolicy p(q, 2.0);
+
+    const double sum = std::exp(0.5) + std::exp(1.0) + std::exp(1.5);
+    BOOST_CHECK_CLOSE(p.getActionProbability(0, 0), std::exp(0.5) / sum, 0.0001);
+    BOOST_CHECK_CLOSE(p.getActionProbability(0, 2), std::exp(1.5) / sum, 0.0001);
+    BOOST_CHECK_CLOSE(p.getActionProbability(1, 1), 1.0 / 3.0, 0.0001);
+
+    BOOST_CHECK_THROW(p.setTemperature(-1.0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE( cache ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::MDP;
+    constexpr size_t S = 3, A = 3;
+
+    QLearning learner(S, A, 0.9, 0.5);
+    learner.stepUpdateQ(0, 0, 0, 1.0);
+    learner.stepUpdateQ(1, 2, 1, 2.0);
+
+    QSoftmaxPolicy p(learner.getQFunction(), 0.5);
+    QSoftmaxPolicy cached(learner.getQFunction(), 0.5);
+    cached.enableCache(learner.getQFunctionVersion());
+    BOOST_CHECK(cached.isCacheEnabled());
+
+    const auto checkSame = [&]() {
+        const auto expected = p.getPolicy();
+        const auto policy = cached.getPolicy();
+        for (size_t s = 0; s < S; ++s)
+            for (size_t a = 0; a < A; ++a)
+                BOOST_CHECK(checkEqualSmall(expected(s, a), policy(s, a)));
+    };
+    checkSame();
+
+    // Sampled frequencies follow the cached distribution.
+    std::array<unsigned, A> counts{{0,0,0}};
+    constexpr unsigned N = 20000;
+    for (unsigned i = 0; i < N; ++i)
+        ++counts[cached.sampleAction(1)];
+    for (size_t a = 0; a < A; ++a)
+        BOOST_CHECK(std::fabs(double(counts[a]) / N - p.getActionProbability(1, a)) < 0.02);
+
+    // Both learner updates and temperature changes invalidate the cache.
+    learner.stepUpdateQ(2, 1, 2, 3.0);
+    checkSame();
+
+    Vector out(A);
+    for (size_t s = 0; s < S; ++s) {
+        cached.getActionProbabilities(s, out);
+        for (size_t a = 0; a < A; ++a)
+            BOOST_CHECK(checkEqualSmall(out[a], p.getActionProbability(s, a)));
+        p.getActionProbabilities(s, out);
+        for (size_t a = 0; a < A; ++a)
+            BOOST_CHECK(checkEqualSmall(out[a], p.getActionProbability(s, a)));
+    }
+
+    p.setTemperature(0.0);
+    cached.setTemperature(0.0);
+    checkSame();
+    for (unsigned i = 0; i < 100; ++i)
+        BOOST_CHECK_EQUAL(cached.sampleAction(2), 1);
+}
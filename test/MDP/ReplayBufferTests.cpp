@@ -0,0 +1,121 @@
+#define BOOST_TEST_MODULE MDP_ReplayBuffer
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/ReplayBuffer.hpp>
+#include <AIToolbox/MDP/Algorithms/QLearning.hpp>
+#include <AIToolbox/MDP/Algorithms/SARSA.hpp>
+#include <AIToolbox/MDP/Algorithms/RLearning.hpp>
+
+namespace aif = AIToolbox::MDP;
+
+BOOST_AUTO_TEST_CASE( construction ) {
+    BOOST_CHECK_THROW( aif::ReplayBuffer(0), std::invalid_argument );
+    BOOST_CHECK_THROW( aif::ReplayBuffer(10, -1.0), std::invalid_argument );
+
+    aif::ReplayBuffer buffer(3);
+    BOOST_CHECK_EQUAL( buffer.getCapacity(), 3 );
+    BOOST_CHECK_EQUAL( buffer.size(), 0 );
+
+    // The buffer wraps around once full.
+    for ( size_t i = 0; i < 5; ++i )
+        buffer.record(i, 0, i, 0.0);
+    BOOST_CHECK_EQUAL( buffer.size(), 3 );
+
+    buffer.clear();
+    BOOST_CHECK_EQUAL( buffer.size(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( uniformReplay ) {
+    // State 0 goes to the absorbing state 1 with reward 1.
+    aif::QLearning learner(2, 1, 0.9, 0.5);
+    aif::ReplayBuffer buffer(10, 0.0, 8);
+
+    buffer.record(0, 0, 1, 1.0);
+    buffer.record(1, 0, 1, 0.0);
+
+    for ( unsigned i = 0; i < 50; ++i )
+        buffer.batchUpdateQ(learner);
+
+    BOOST_CHECK_CLOSE( learner.getQFunction()(0, 0), 1.0, 0.001 );
+    BOOST_CHECK_EQUAL( learner.getQFunction()(1, 0), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( nextActionReplay ) {
+    // A two-state cycle with reward 1, where SARSA follows action 0.
+    aif::SARSA learner(2, 2, 0.5, 0.5);
+    aif::ReplayBuffer buffer(10, 0.0, 8);
+
+    buffer.record(0, 0, 1, 0, 1.0);
+    buffer.record(1, 0, 0, 0, 1.0);
+
+    for ( unsigned i = 0; i < 200; ++i )
+        buffer.batchUpdateQ(learner);
+
+    BOOST_CHECK_CLOSE( learner.getQFunction()(0, 0), 2.0, 0.001 );
+    BOOST_CHECK_CLOSE( learner.getQFunction()(1, 0), 2.0, 0.001 );
+    BOOST_CHECK_EQUAL( learner.getQFunction()(0, 1), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( prioritizedReplay ) {
+    aif::QLearning learner(2, 1, 0.9, 0.5);
+    aif::ReplayBuffer buffer(10, 1.0, 2);
+
+    buffer.record(0, 0, 1, 1.0);
+    buffer.record(1, 0, 1, 0.0);
+
+    // New transitions share the same, maximum, priority.
+    BOOST_CHECK_EQUAL( buffer.getWeight(0), buffer.getWeight(1) );
+
+    // With two equal priorities the stratified minibatch takes both.
+    buffer.batchUpdateQ(learner);
+    BOOST_CHECK_CLOSE( learner.getQFunction()(0, 0), 0.5, 0.001 );
+
+    // The absorbing transition has no error, so its weight collapses.
+    BOOST_CHECK_CLOSE( buffer.getWeight(0), 1.0, 0.001 );
+    BOOST_CHECK( buffer.getWeight(1) < 1e-5 );
+
+    for ( unsigned i = 0; i < 20; ++i )
+        buffer.batchUpdateQ(learner);
+
+    BOOST_CHECK_CLOSE( learner.getQFunction()(0, 0), 1.0, 0.001 );
+    BOOST_CHECK_EQUAL( learner.getQFunction()(1, 0), 0.0 );
+    BOOST_CHECK( buffer.getWeight(0) < 1e-4 );
+}
+
+BOOST_AUTO_TEST_CASE( overloadedLearner ) {
+    // A learner that can do without the next action, but uses it if given.
+    struct Learner {
+        double stepUpdateQ(size_t, size_t, size_t, double) { ++withoutNext; return 0.0; }
+        double stepUpdateQ(size_t, size_t, size_t, size_t, double) { ++withNext; return 0.0; }
+        unsigned withoutNext = 0, withNext = 0;
+    } learner;
+
+    aif::ReplayBuffer buffer(10, 0.0, 4);
+    buffer.record(0, 0, 1, 1, 1.0);
+    buffer.batchUpdateQ(learner);
+
+    BOOST_CHECK_EQUAL( learner.withNext, 4 );
+    BOOST_CHECK_EQUAL( learner.withoutNext, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( rLearningReplay ) {
+    // A single state looping on itself with reward 1.
+    aif::RLearning learner(1, 1, 0.5, 0.1);
+
+    // The returned error is the one applied to the QFunction.
+    const double error = learner.stepUpdateQ(0, 0, 0, 1.0);
+    BOOST_CHECK_CLOSE( error, 1.0, 0.001 );
+    BOOST_CHECK_CLOSE( learner.getQFunction()(0, 0), 0.5 * error, 0.001 );
+
+    aif::ReplayBuffer buffer(10, 1.0, 4);
+    buffer.record(0, 0, 0, 1.0);
+
+    for ( unsigned i = 0; i < 200; ++i )
+        buffer.batchUpdateQ(learner);
+
+    // Once the average reward is learned the error, and so the priority, vanish.
+    BOOST_CHECK_CLOSE( learner.getAverageReward(), 1.0, 0.001 );
+    BOOST_CHECK( buffer.getWeight(0) < 1e-4 );
+}
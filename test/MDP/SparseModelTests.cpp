@@ -8,7 +8,10 @@
 
 #include <AIToolbox/MDP/Environments/CornerProblem.hpp>
 
+#include <climits>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 BOOST_AUTO_TEST_CASE( eigen_model ) {
     BOOST_CHECK(AIToolbox::MDP::is_model_eigen_v<AIToolbox::MDP::SparseModel>);
@@ -121,3 +124,292 @@ BOOST_AUTO_TEST_CASE( setTransitionFunction ) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE( samplingIndex ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    BOOST_CHECK(!model.isSamplingIndexEnabled());
+    BOOST_CHECK_EQUAL(model.getSamplingIndexMemory(), 0);
+
+    // Lazy index: memory grows only as pairs are sampled.
+    model.setSamplingIndex(true);
+    BOOST_CHECK(model.isSamplingIndexEnabled());
+    const auto emptyMemory = model.getSamplingIndexMemory();
+
+    constexpr unsigned N = 20000;
+    const size_t s = 5, a = 1;
+    std::vector<unsigned> counts(S, 0);
+    for ( unsigned i = 0; i < N; ++i )
+        ++counts[std::get<0>(model.sampleSR(s, a))];
+
+    BOOST_CHECK(model.getSamplingIndexMemory() > emptyMemory);
+    for ( size_t s1 = 0; s1 < S; ++s1 )
+        BOOST_CHECK_SMALL(double(counts[s1]) / N - model.getTransitionProbability(s, a, s1), 0.02);
+
+    // Eager index: every pair is built immediately.
+    model.setSamplingIndex(true, true);
+    const auto eagerMemory = model.getSamplingIndexMemory();
+    BOOST_CHECK(eagerMemory > emptyMemory);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK(model.getTransitionProbability(s, a, std::get<0>(model.sampleSR(s, a))) > 0.0);
+
+    // Changing the transition function invalidates the index.
+    AIToolbox::DumbMatrix3D t(boost::extents[S][A][S]);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            t[s][a][(s + 1) % S] = 1.0;
+    model.setTransitionFunction(t);
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL(std::get<0>(model.sampleSR(s, a)), (s + 1) % S);
+
+    model.setSamplingIndex(false);
+    BOOST_CHECK_EQUAL(model.getSamplingIndexMemory(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( stackedTransitions ) {
+    using namespace AIToolbox::MDP;
+
+    BOOST_CHECK(is_model_stacked_v<SparseModel>);
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    BOOST_CHECK(!model.isStackedTransitionsEnabled());
+    BOOST_CHECK_EQUAL(model.getStackedTransitionFunction().nonZeros(), 0);
+
+    model.setStackedTransitions(true);
+    BOOST_CHECK(model.isStackedTransitionsEnabled());
+
+    const auto & stacked = model.getStackedTransitionFunction();
+    BOOST_CHECK_EQUAL(stacked.rows(), S * A);
+    BOOST_CHECK_EQUAL(stacked.cols(), S);
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(stacked.coeff(s * A + a, s1), model.getTransitionProbability(s, a, s1));
+
+    // Changing the transition function rebuilds the stacked matrix.
+    AIToolbox::DumbMatrix3D t(boost::extents[S][A][S]);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            t[s][a][(s + 1) % S] = 1.0;
+    model.setTransitionFunction(t);
+
+    BOOST_CHECK_EQUAL(model.getStackedTransitionFunction().nonZeros(), S * A);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL(model.getStackedTransitionFunction().coeff(s * A + a, (s + 1) % S), 1.0);
+
+    model.setStackedTransitions(false);
+    BOOST_CHECK_EQUAL(model.getStackedTransitionFunction().nonZeros(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( stackedTransitionsLoad ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    std::stringstream ss;
+    ss << model;
+
+    // Reading keeps the stacked setting of the target, and rebuilds the
+    // matrix over the new data.
+    SparseModel loaded(S, A);
+    loaded.setStackedTransitions(true);
+
+    BOOST_CHECK(ss >> loaded);
+    BOOST_CHECK(loaded.isStackedTransitionsEnabled());
+
+    const auto & stacked = loaded.getStackedTransitionFunction();
+    BOOST_CHECK_EQUAL(stacked.rows(), S * A);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(stacked.coeff(s * A + a, s1), loaded.getTransitionProbability(s, a, s1));
+}
+
+BOOST_AUTO_TEST_CASE( singlePrecision ) {
+    using namespace AIToolbox::MDP;
+
+    BOOST_CHECK(is_model_eigen_v<SparseModelT<float>>);
+    BOOST_CHECK(is_model_stacked_v<SparseModelT<float>>);
+
+    GridWorld grid(4, 4);
+    const auto model = makeCornerProblem(grid);
+    SparseModelT<float> floatModel(model);
+    const size_t S = model.getS(), A = model.getA();
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                BOOST_CHECK_CLOSE(floatModel.getTransitionProbability(s, a, s1), model.getTransitionProbability(s, a, s1), 0.0001);
+                BOOST_CHECK_EQUAL(floatModel.getExpectedReward(s, a, s1), model.getExpectedReward(s, a, s1));
+            }
+
+    floatModel.setStackedTransitions(true);
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                BOOST_CHECK_EQUAL(floatModel.getStackedTransitionFunction().coeff(s * A + a, s1), floatModel.getTransitionFunction(a).coeff(s, s1));
+
+    for ( auto index : {false, true} ) {
+        floatModel.setSamplingIndex(index);
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                BOOST_CHECK(floatModel.getTransitionProbability(s, a, std::get<0>(floatModel.sampleSR(s, a))) > 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( samplingIndexLoad ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+    const size_t S = model.getS(), A = model.getA();
+
+    std::stringstream ss;
+    ss << model;
+
+    // Reading keeps the sampling index settings of the target.
+    SparseModel loaded(S, A);
+    loaded.setSamplingIndex(true, true);
+    const auto emptyMemory = loaded.getSamplingIndexMemory();
+
+    BOOST_CHECK(ss >> loaded);
+    BOOST_CHECK(loaded.isSamplingIndexEnabled());
+    BOOST_CHECK(loaded.getSamplingIndexMemory() > 0);
+    BOOST_CHECK(loaded.getSamplingIndexMemory() != emptyMemory);
+
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK(loaded.getTransitionProbability(s, a, std::get<0>(loaded.sampleSR(s, a))) > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( binaryFiles ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel m = makeCornerProblem(grid);
+    m.setDiscount(0.95);
+
+    std::string outputFilename = "./binarySparseModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( writeBinary(outputFile, m) );
+    }
+    {
+        const auto m2 = loadBinarySparseModel(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), m2.getS());
+        BOOST_CHECK_EQUAL(m.getA(), m2.getA());
+        BOOST_CHECK_EQUAL(m.getDiscount(), m2.getDiscount());
+
+        for ( size_t a = 0; a < m.getA(); ++a ) {
+            BOOST_CHECK_EQUAL(m.getTransitionFunction(a).nonZeros(), m2.getTransitionFunction(a).nonZeros());
+            BOOST_CHECK(m.getTransitionFunction(a).isApprox(m2.getTransitionFunction(a)));
+        }
+        BOOST_CHECK(m.getRewardFunction().isApprox(m2.getRewardFunction()));
+
+        for ( size_t s = 0; s < m.getS(); ++s )
+            for ( size_t a = 0; a < m.getA(); ++a )
+                for ( size_t s1 = 0; s1 < m.getS(); ++s1 )
+                    BOOST_CHECK_EQUAL(m.getTransitionProbability(s, a, s1), m2.getTransitionProbability(s, a, s1));
+
+        BOOST_CHECK_THROW(loadBinaryModel(outputFilename), std::runtime_error);
+    }
+    {
+        // A truncated file must be rejected.
+        std::ifstream inputFile(outputFilename, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+        inputFile.close();
+
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        outputFile.write(data.data(), data.size() / 2);
+    }
+    BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( binaryFilesSinglePrecision ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModelT<float> m = makeCornerProblem(grid);
+
+    std::string outputFilename = "./binaryFloatSparseModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( writeBinary(outputFile, m) );
+    }
+    {
+        const auto m2 = loadBinarySparseModel<float>(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), m2.getS());
+        BOOST_CHECK_EQUAL(m.getA(), m2.getA());
+        for ( size_t a = 0; a < m.getA(); ++a )
+            BOOST_CHECK(m.getTransitionFunction(a).isApprox(m2.getTransitionFunction(a)));
+        BOOST_CHECK(m.getRewardFunction().isApprox(m2.getRewardFunction()));
+
+        // The scalar type is stored in the file.
+        BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+    }
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( binaryFilesCorrupted ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel m = makeCornerProblem(grid);
+
+    std::ostringstream os(std::ios::binary);
+    writeBinary(os, m);
+    const std::string data = os.str();
+
+    std::string outputFilename = "./binaryCorruptedSparseModel.bin";
+    const auto writeCorrupted = [&](size_t offset, std::uint64_t value) {
+        std::string corrupted = data;
+        std::memcpy(&corrupted[offset], &value, sizeof(value));
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        outputFile.write(corrupted.data(), corrupted.size());
+    };
+
+    // Huge dimensions must be rejected before allocating anything.
+    writeCorrupted(24, std::uint64_t(1) << 40);
+    BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+
+    writeCorrupted(24, std::uint64_t(INT_MAX) + 1);
+    BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+
+    // So must a huge number of non-zeros in the first section.
+    writeCorrupted(64, std::uint64_t(1) << 62);
+    BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+
+    // The models are built without checks, so the discount is validated.
+    writeCorrupted(48, 0);
+    BOOST_CHECK_THROW(loadBinarySparseModel(outputFilename), std::runtime_error);
+
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
@@ -0,0 +1,149 @@
+#define BOOST_TEST_MODULE MDP_TopologicalValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/TopologicalValueIteration.hpp>
+
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include "Utils/OldMDPModel.hpp"
+#include "Utils/CornerProblemSolution.hpp"
+
+namespace ai = AIToolbox;
+namespace aif = AIToolbox::MDP;
+
+aif::SparseModel makeLoopsProblem(const size_t S, const double reward) {
+    // A chain towards the absorbing state 0, where every third state can
+    // also go back to its successor, forming small loops. The last state
+    // can also stay put.
+    ai::SparseMatrix3D transitions(2, ai::SparseMatrix2D(S, S));
+    ai::SparseMatrix2D rewards(S, 2);
+
+    transitions[0].insert(0, 0) = 1.0;
+    transitions[1].insert(0, 0) = 1.0;
+    for ( size_t s = 1; s < S; ++s ) {
+        transitions[0].insert(s, s - 1) = 1.0;
+        if ( s % 3 == 0 && s + 1 < S ) {
+            transitions[1].insert(s, s + 1) = 1.0;
+            rewards.insert(s, 1) = reward;
+        } else {
+            transitions[1].insert(s, s == S - 1 ? s : s - 1) = 1.0;
+        }
+    }
+    rewards.insert(1, 0) = 1.0;
+
+    return aif::SparseModel(ai::NO_CHECK, S, 2, std::move(transitions), std::move(rewards), 0.9);
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCorners ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+
+    TopologicalValueIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+
+    // The corners are absorbing, and every other cell can reach all others.
+    BOOST_CHECK_EQUAL( solver.getComponents().size(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersSparse ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    SparseModel model(makeCornerProblem(grid));
+
+    TopologicalValueIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+}
+
+BOOST_AUTO_TEST_CASE( escapeToCornersNonEigen ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    OldMDPModel model = makeCornerProblem(grid);
+
+    TopologicalValueIteration solver(1000000, 0.00001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    BOOST_CHECK( bound <= solver.getTolerance() );
+    checkCornerProblemSolution(vfun, 0.0001);
+}
+
+BOOST_AUTO_TEST_CASE( components ) {
+    using namespace AIToolbox::MDP;
+
+    constexpr size_t S = 10;
+    const auto model = makeLoopsProblem(S, 0.5);
+
+    TopologicalValueIteration solver(1000000, 0.0000001);
+    auto [bound, vfun, qfun] = solver(model);
+
+    // In the loops it's best to keep cycling for 0.5 / (1 - 0.81), while
+    // elsewhere one follows the loops or the chain.
+    const double loop = 0.5 / (1.0 - 0.81);
+    const double truth[S] = { 0.0, 1.0, 0.9, loop, 0.9 * loop, 0.81 * loop, loop, 0.9 * loop, 0.81 * loop, 0.729 * loop };
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL( vfun.values[s] - truth[s], 0.00001 );
+    BOOST_CHECK_EQUAL( vfun.actions[3], 1 );
+    BOOST_CHECK_EQUAL( vfun.actions[9], 0 );
+
+    // Loops are {3,4}, {6,7}, {9}; 0 is absorbing and all others are alone.
+    const auto & components = solver.getComponents();
+    const auto & iterations = solver.getComponentIterations();
+    BOOST_CHECK_EQUAL( components.size(), 8 );
+    BOOST_CHECK_EQUAL( iterations.size(), components.size() );
+
+    // Components must be sorted so that successors are solved first.
+    std::vector<size_t> position(S);
+    for ( size_t c = 0; c < components.size(); ++c )
+        for ( auto s : components[c] )
+            position[s] = c;
+
+    for ( size_t s = 1; s < S; ++s )
+        BOOST_CHECK( position[s - 1] <= position[s] );
+    BOOST_CHECK_EQUAL( position[3], position[4] );
+    BOOST_CHECK_EQUAL( position[6], position[7] );
+
+    for ( size_t c = 0; c < components.size(); ++c ) {
+        const auto s = components[c][0];
+        // Acyclic states only need a single backup.
+        if ( s == 1 || s == 2 || s == 5 || s == 8 )
+            BOOST_CHECK_EQUAL( iterations[c], 1 );
+        else if ( s == 3 || s == 4 || s == 6 || s == 7 )
+            BOOST_CHECK( iterations[c] > 1 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( cachedComponents ) {
+    using namespace AIToolbox::MDP;
+
+    constexpr size_t S = 10;
+    const auto model = makeLoopsProblem(S, 0.5);
+    const auto model2 = makeLoopsProblem(S, 0.1);
+
+    TopologicalValueIteration solver(1000000, 0.0000001);
+    solver.computeComponents(model);
+    const auto components = solver.getComponents();
+
+    // Changing the rewards keeps the same decomposition.
+    auto [bound, vfun, qfun] = solver(model2);
+    BOOST_CHECK( solver.getComponents() == components );
+
+    // With a lower reward cycling is not worth it anymore (0.1 / 0.19 < 0.81).
+    const double truth[S] = { 0.0, 1.0, 0.9, 0.81, 0.729, 0.6561, 0.59049, 0.531441, 0.4782969, 0.43046721 };
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL( vfun.values[s] - truth[s], 0.00001 );
+
+    solver.clearComponents();
+    BOOST_CHECK( solver.getComponents().empty() );
+}
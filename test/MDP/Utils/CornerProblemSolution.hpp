@@ -0,0 +1,63 @@
+#ifndef AI_TOOLBOX_CORNER_PROBLEM_SOLUTION_HEADER_FILE
+#define AI_TOOLBOX_CORNER_PROBLEM_SOLUTION_HEADER_FILE
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Environments/CornerProblem.hpp>
+
+/**
+ * @brief This function checks a ValueFunction against the optimal solution of the 4x4 corner problem.
+ *
+ * The solution is for makeCornerProblem() with its default parameters
+ * (step uncertainty 0.8 and discount 0.95). The optimal values only
+ * depend on the distance from the closest corner, and the optimal
+ * actions are the ones that move towards it:
+ *
+ *   0,0
+ *     +-------+-------+-------+-------+
+ *     |   ^   |       |       |       |
+ *     | <-+-> | <-+   | <-+   | <-+   |
+ *     |   v   |       |       |   v   |
+ *     +-------+-------+-------+-------+
+ *     |   ^   |   ^   |   ^   |       |
+ *     |   +   | <-+   | <-+-> |   +   |
+ *     |       |       |   v   |   v   |
+ *     +-------+-------+-------+-------+
+ *     |   ^   |   ^   |       |       |
+ *     |   +   | <-+-> |   +-> |   +   |
+ *     |       |   v   |   v   |   v   |
+ *     +-------+-------+-------+-------+
+ *     |   ^   |       |       |   ^   |
+ *     |   +-> |   +-> |   +-> | <-+-> |
+ *     |       |       |       |   v   |
+ *     +-------+-------+-------+-------+
+ *                                     3,3
+ *
+ * @param vfun The ValueFunction to check.
+ * @param tolerance The maximum allowed error on the values.
+ */
+inline void checkCornerProblemSolution(const AIToolbox::MDP::ValueFunction & vfun, const double tolerance) {
+    using namespace AIToolbox::MDP::GridWorldEnums;
+
+    constexpr double d1 = -0.987654321, d2 = -1.914342326, d3 = -2.783827367;
+    constexpr double values[16] = {
+        0.0, d1,  d2,  d3,
+        d1,  d2,  d3,  d2,
+        d2,  d3,  d2,  d1,
+        d3,  d2,  d1,  0.0,
+    };
+
+    constexpr unsigned all = (1u << UP) | (1u << RIGHT) | (1u << DOWN) | (1u << LEFT);
+    constexpr unsigned actions[16] = {
+        all,        1u << LEFT,                 1u << LEFT,                 (1u << LEFT) | (1u << DOWN),
+        1u << UP,   (1u << LEFT) | (1u << UP),  all,                        1u << DOWN,
+        1u << UP,   all,                        (1u << RIGHT) | (1u << DOWN), 1u << DOWN,
+        (1u << UP) | (1u << RIGHT), 1u << RIGHT, 1u << RIGHT,               all,
+    };
+
+    for ( size_t s = 0; s < 16; ++s ) {
+        BOOST_CHECK_SMALL( vfun.values[s] - values[s], tolerance );
+        BOOST_CHECK( actions[s] & (1u << vfun.actions[s]) );
+    }
+}
+
+#endif
@@ -297,3 +297,85 @@ BOOST_AUTO_TEST_CASE( escapeToCornersNonEigen ) {
         BOOST_CHECK_EQUAL( qfun.row(s).maxCoeff(), values[s] );
     }
 }
+
+BOOST_AUTO_TEST_CASE( multithreadedMatchesSerial ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIteration serial(1000000, 0.0001);
+    ValueIteration parallel(1000000, 0.0001, {Values(), Actions(0)}, 3);
+
+    BOOST_CHECK_EQUAL( parallel.getThreads(), 3 );
+
+    auto [sBound, sVfun, sQfun] = serial(model);
+    auto [pBound, pVfun, pQfun] = parallel(model);
+
+    BOOST_CHECK( pBound <= parallel.getTolerance() );
+    BOOST_CHECK( sVfun.values.isApprox(pVfun.values) );
+    BOOST_CHECK( sQfun.isApprox(pQfun) );
+    for ( size_t s = 0; s < model.getS(); ++s )
+        BOOST_CHECK_EQUAL( pQfun(s, pVfun.actions[s]), pVfun.values[s] );
+
+    auto [spBound, spVfun, spQfun] = parallel(sparseModel);
+
+    BOOST_CHECK( spBound <= parallel.getTolerance() );
+    BOOST_CHECK( sVfun.values.isApprox(spVfun.values) );
+    BOOST_CHECK( sQfun.isApprox(spQfun) );
+    for ( size_t s = 0; s < model.getS(); ++s )
+        BOOST_CHECK_EQUAL( spQfun(s, spVfun.actions[s]), spVfun.values[s] );
+}
+
+BOOST_AUTO_TEST_CASE( stackedMatchesUnstacked ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    SparseModel model = makeCornerProblem(grid);
+    SparseModel stackedModel(model);
+    stackedModel.setStackedTransitions(true);
+
+    ValueIteration serial(1000000, 0.0001);
+    ValueIteration parallel(1000000, 0.0001, {Values(), Actions(0)}, 3);
+
+    auto [bound, vfun, qfun] = serial(model);
+
+    for ( auto * solver : {&serial, &parallel} ) {
+        auto [stBound, stVfun, stQfun] = (*solver)(stackedModel);
+
+        BOOST_CHECK( stBound <= solver->getTolerance() );
+        BOOST_CHECK( vfun.values.isApprox(stVfun.values) );
+        BOOST_CHECK( qfun.isApprox(stQfun) );
+        BOOST_CHECK( vfun.actions == stVfun.actions );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( singlePrecisionModel ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModelT<float> floatModel(model);
+
+    ValueIteration serial(1000000, 0.0001);
+    ValueIteration parallel(1000000, 0.0001, {Values(), Actions(0)}, 3);
+
+    auto [bound, vfun, qfun] = serial(model);
+
+    for ( auto stacked : {false, true} ) {
+        floatModel.setStackedTransitions(stacked);
+        for ( auto * solver : {&serial, &parallel} ) {
+            auto [fBound, fVfun, fQfun] = (*solver)(floatModel);
+
+            BOOST_CHECK( fBound <= solver->getTolerance() );
+            BOOST_CHECK_SMALL( (vfun.values - fVfun.values).cwiseAbs().maxCoeff(), 0.001 );
+            BOOST_CHECK_SMALL( (qfun - fQfun).cwiseAbs().maxCoeff(), 0.001 );
+            for ( size_t s = 0; s < model.getS(); ++s )
+                BOOST_CHECK_EQUAL( fQfun(s, fVfun.actions[s]), fVfun.values[s] );
+        }
+    }
+}
@@ -187,3 +187,38 @@ BOOST_AUTO_TEST_CASE( cassandraEjs4 ) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE( binaryFiles ) {
+    using namespace AIToolbox;
+
+    auto m = POMDP::makeTigerProblem();
+    m.setDiscount(0.95);
+
+    std::string outputFilename = "./binaryModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( POMDP::writeBinary(outputFile, m) );
+    }
+    {
+        const auto m2 = POMDP::loadBinaryModel(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), m2.getS());
+        BOOST_CHECK_EQUAL(m.getA(), m2.getA());
+        BOOST_CHECK_EQUAL(m.getO(), m2.getO());
+        BOOST_CHECK_EQUAL(m.getDiscount(), m2.getDiscount());
+
+        for ( size_t a = 0; a < m.getA(); ++a ) {
+            BOOST_CHECK(m.getTransitionFunction(a) == m2.getTransitionFunction(a));
+            BOOST_CHECK(m.getObservationFunction(a) == m2.getObservationFunction(a));
+        }
+        BOOST_CHECK(m.getRewardFunction() == m2.getRewardFunction());
+
+        // The MDP loader must not accept a POMDP file.
+        BOOST_CHECK_THROW(MDP::loadBinaryModel(outputFilename), std::runtime_error);
+    }
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
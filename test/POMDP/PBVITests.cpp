@@ -6,6 +6,8 @@
 #include <AIToolbox/POMDP/Algorithms/PBVI.hpp>
 #include <AIToolbox/POMDP/Algorithms/IncrementalPruning.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/POMDP/SparseModel.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 #include <AIToolbox/Utils/Core.hpp>
 
 #include <AIToolbox/POMDP/Environments/TigerProblem.hpp>
@@ -97,3 +99,45 @@ BOOST_AUTO_TEST_CASE( undiscountedHorizon ) {
             BOOST_CHECK_EQUAL(vlist[i].action, it->action);
     }
 }
+
+BOOST_AUTO_TEST_CASE( singlePrecisionModel ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::POMDP;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.95);
+
+    const SparseModel<MDP::SparseModelT<float>> floatModel(model);
+
+    // We use the same beliefs for both models, so that the only difference
+    // between the two solutions is the precision of the transitions.
+    std::vector<Belief> beliefs;
+    for ( double p = 0.0; p <= 1.0; p += 0.01 ) {
+        beliefs.emplace_back(2);
+        beliefs.back() << p, 1.0 - p;
+    }
+
+    unsigned horizon = 5;
+    PBVI solver(beliefs.size(), horizon, 0.01);
+    auto solution = solver(floatModel, beliefs);
+    auto truth = solver(model, beliefs);
+
+    auto vf = std::get<1>(solution);
+    auto vt = std::get<1>(truth);
+
+    for ( auto & vl : vt ) std::sort(std::begin(vl), std::end(vl));
+    for ( auto & vl : vf ) std::sort(std::begin(vl), std::end(vl));
+
+    BOOST_CHECK_EQUAL(vf.size(), vt.size());
+    if ( vf.size() != vt.size() ) return;
+    for ( size_t i = 0; i < vf.size(); ++i ) {
+        BOOST_CHECK_EQUAL(vf[i].size(), vt[i].size());
+        if ( vf[i].size() != vt[i].size() ) continue;
+        for ( size_t j = 0; j < vf[i].size(); ++j ) {
+            // Transitions are stored as float, so values only match up
+            // to single precision.
+            BOOST_CHECK_SMALL((vf[i][j].values - vt[i][j].values).cwiseAbs().maxCoeff(), 0.001);
+            BOOST_CHECK_EQUAL(vf[i][j].action, vt[i][j].action);
+        }
+    }
+}
@@ -5,8 +5,12 @@
 
 #include <AIToolbox/POMDP/Algorithms/IncrementalPruning.hpp>
 #include <AIToolbox/POMDP/Algorithms/POMCP.hpp>
+#include <AIToolbox/POMDP/Algorithms/PBVI.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/POMDP/SparseModel.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 #include <AIToolbox/POMDP/Policies/Policy.hpp>
+#include <AIToolbox/MDP/Policies/Policy.hpp>
 #include <AIToolbox/POMDP/Utils.hpp>
 
 #include <AIToolbox/Utils/Probability.hpp>
@@ -87,12 +91,13 @@ BOOST_AUTO_TEST_CASE( horizonOneBelief ) {
         solver.sampleAction(b, horizon);
 
         auto & graph = solver.getGraph();
+        const auto root = graph.getRoot();
 
         unsigned particleCount = 0;
-        for ( auto & a : graph.children ) {
-            for ( auto & b : a.children ) {
-                particleCount += b.second.belief.size();
-            }
+        for ( size_t a = 0; a < model.getA(); ++a ) {
+            auto c = graph.getEdges(root)[a].child;
+            for ( ; c != graph.None; c = graph.getNode(c).sibling )
+                particleCount += graph.getNode(c).data.size();
         }
 
         BOOST_CHECK_EQUAL( particleCount, count );
@@ -124,9 +129,138 @@ BOOST_AUTO_TEST_CASE( sampleOneTime ) {
 
     auto & graph_ = solver.getGraph();
     // We find the leaf we just produced
-    auto it = graph_.children[0].children.begin();
-    auto o = it->first;
+    const auto root = graph_.getRoot();
+    auto o = graph_.getNode(graph_.getEdges(root)[0].child).key;
 
     // We make a,o the new head
     solver.sampleAction( 0, o, horizon-1);
 }
+
+BOOST_AUTO_TEST_CASE( singlePrecisionModel ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::POMDP;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    const SparseModel<MDP::SparseModelT<float>> floatModel(model);
+
+    Matrix2D beliefs(3, 2);
+    beliefs << 0.5,     0.5,
+               1.0,     0.0,
+               0.02,    0.98;
+
+    const unsigned maxHorizon = 3;
+
+    // With this many beliefs PBVI is exact for the tiger problem at these
+    // horizons, so we can use it as ground truth.
+    std::vector<Belief> bList;
+    for ( double b = 0.0; b <= 1.0; b += 0.01 ) {
+        bList.emplace_back(2);
+        bList.back() << b, 1.0 - b;
+    }
+    PBVI groundTruth(bList.size(), maxHorizon, 0.0);
+    auto solution = groundTruth(model, bList);
+    auto & vf = std::get<1>(solution);
+    Policy p(model.getS(), model.getA(), model.getO(), vf);
+
+    for ( unsigned horizon = 1; horizon <= maxHorizon; ++horizon ) {
+        POMCP solver(floatModel, 1000, 10000, horizon * 10000.0);
+
+        for ( auto i = 0; i < beliefs.rows(); ++i ) {
+            auto a = solver.sampleAction(beliefs.row(i), horizon);
+            auto trueA = p.sampleAction(beliefs.row(i), horizon);
+
+            BOOST_CHECK_EQUAL( std::get<0>(trueA), a);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( deadlineSearch ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::POMDP;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    Belief belief(2); belief.fill(0.5);
+
+    // The iterations are ignored when searching with a deadline.
+    POMCP solver(model, 1000, 1, 10000.0);
+    const auto & graph = solver.getGraph();
+
+    SearchStatistics stats;
+    const auto start = SearchClock::now();
+    const auto deadline = start + std::chrono::milliseconds(50);
+
+    const auto a = solver.sampleAction(belief, 5, deadline, &stats);
+    BOOST_CHECK( SearchClock::now() >= deadline );
+
+    BOOST_CHECK( stats.simulations > 1 );
+    BOOST_CHECK( stats.maxDepth > 0 );
+    BOOST_CHECK( stats.maxDepth < 5 );
+    BOOST_CHECK_EQUAL( stats.rootVisits.size(), model.getA() );
+
+    unsigned visits = 0;
+    for (const auto v : stats.rootVisits) visits += v;
+    BOOST_CHECK_EQUAL( visits, stats.simulations );
+    BOOST_CHECK_EQUAL( graph.getNode(graph.getRoot()).N, stats.simulations );
+
+    // Reusing the tree, the root visits include the ones of the kept subtree.
+    const auto child = graph.getEdges(graph.getRoot())[a].child;
+    BOOST_REQUIRE( child != graph.None );
+    const auto o = graph.getNode(child).key;
+    const auto N = graph.getNode(child).N;
+
+    solver.sampleAction(a, o, 4, SearchClock::now() + std::chrono::milliseconds(10), &stats);
+
+    visits = 0;
+    for (const auto v : stats.rootVisits) visits += v;
+    BOOST_CHECK_EQUAL( visits, N + stats.simulations );
+
+    // An expired deadline still runs a single simulation.
+    solver.sampleAction(belief, 5, start, &stats);
+    BOOST_CHECK_EQUAL( stats.simulations, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( rolloutPolicyAndLeafEvaluator ) {
+    using namespace AIToolbox;
+    using namespace AIToolbox::POMDP;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    Belief belief(2); belief.fill(0.5);
+
+    POMCP solver(model, 1000, 1000, 10000.0);
+
+    // A rollout policy that always listens.
+    Matrix2D table = Matrix2D::Zero(model.getS(), model.getA());
+    table.col(0).fill(1.0);
+    MDP::Policy listen(table);
+
+    solver.setRolloutPolicy(&listen);
+    BOOST_CHECK_EQUAL( solver.getRolloutPolicy(), &listen );
+    solver.sampleAction(belief, 5);
+
+    // The evaluator is only called on rollouts truncated before the horizon.
+    unsigned calls = 0;
+    solver.setLeafEvaluator([&calls](size_t) { ++calls; return 100.0; });
+    solver.sampleAction(belief, 5);
+    BOOST_CHECK_EQUAL( calls, 0 );
+
+    // With a single simulation, UCT listens and the new leaf is only
+    // valued by the evaluator.
+    solver.setIterations(1);
+    solver.setRolloutDepth(0);
+    solver.sampleAction(belief, 2);
+    BOOST_CHECK_EQUAL( calls, 1 );
+
+    const auto & graph = solver.getGraph();
+    BOOST_CHECK_CLOSE( graph.getEdges(graph.getRoot())[0].V, -1.0 + 0.85 * 100.0, 0.0001 );
+
+    MDP::QFunction bad = MDP::QFunction::Zero(model.getS() + 1, model.getA());
+    MDP::Policy badPolicy(model.getS() + 1, model.getA());
+    BOOST_CHECK_THROW( solver.setRolloutPolicy(&badPolicy), std::invalid_argument );
+    BOOST_CHECK_THROW( solver.setLeafEvaluator(bad), std::invalid_argument );
+}
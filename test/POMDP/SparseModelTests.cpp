@@ -128,3 +128,41 @@ BOOST_AUTO_TEST_CASE( files ) {
         std::remove(outputFilename.c_str());
     }
 }
+
+BOOST_AUTO_TEST_CASE( binaryFiles ) {
+    using namespace AIToolbox;
+
+    auto model = POMDP::makeTigerProblem();
+    model.setDiscount(0.95);
+    const POMDP::SparseModel<MDP::SparseModel> m(model);
+
+    std::string outputFilename = "./binarySparseModel.bin";
+    {
+        std::ofstream outputFile(outputFilename, std::ios::binary);
+        if ( !outputFile ) BOOST_FAIL("Could not open file for writing: " + outputFilename);
+        BOOST_CHECK( POMDP::writeBinary(outputFile, m) );
+    }
+    {
+        const auto m2 = POMDP::loadBinarySparseModel(outputFilename);
+
+        BOOST_CHECK_EQUAL(m.getS(), m2.getS());
+        BOOST_CHECK_EQUAL(m.getA(), m2.getA());
+        BOOST_CHECK_EQUAL(m.getO(), m2.getO());
+        BOOST_CHECK_EQUAL(m.getDiscount(), m2.getDiscount());
+
+        for ( size_t s = 0; s < m.getS(); ++s ) {
+            for ( size_t a = 0; a < m.getA(); ++a ) {
+                for ( size_t s1 = 0; s1 < m.getS(); ++s1 ) {
+                    BOOST_CHECK_EQUAL(m.getTransitionProbability(s, a, s1), m2.getTransitionProbability(s, a, s1));
+                    BOOST_CHECK_EQUAL(m.getExpectedReward(s, a, s1), m2.getExpectedReward(s, a, s1));
+                }
+                for ( size_t o = 0; o < m.getO(); ++o )
+                    BOOST_CHECK_EQUAL(m.getObservationProbability(s, a, o), m2.getObservationProbability(s, a, o));
+            }
+        }
+    }
+    // Cleanup
+    {
+        std::remove(outputFilename.c_str());
+    }
+}
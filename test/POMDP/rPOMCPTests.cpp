@@ -126,3 +126,34 @@ BOOST_AUTO_TEST_CASE( max_belief ) {
         BOOST_CHECK_EQUAL(solver.sampleAction(beliefs.row(i), 2), solutions[i]);
     }
 }
+
+BOOST_AUTO_TEST_CASE( deadlineSearch ) {
+    using namespace AIToolbox;
+
+    Model model;
+
+    POMDP::Belief belief(4);
+    belief << 0.6, 0.0, 0.2, 0.2;
+
+    // The iterations are ignored when searching with a deadline.
+    POMDP::rPOMCP<decltype(model), true> solver(model, 1000, 1, 200.0);
+
+    SearchStatistics stats;
+    const auto start = SearchClock::now();
+    const auto deadline = start + std::chrono::milliseconds(50);
+
+    solver.sampleAction(belief, 2, deadline, &stats);
+    BOOST_CHECK( SearchClock::now() >= deadline );
+
+    BOOST_CHECK( stats.simulations > 1 );
+    BOOST_CHECK_EQUAL( stats.maxDepth, 1 );
+    BOOST_CHECK_EQUAL( stats.rootVisits.size(), model.getA() );
+
+    unsigned visits = 0;
+    for (const auto v : stats.rootVisits) visits += v;
+    BOOST_CHECK_EQUAL( visits, stats.simulations );
+
+    // An expired deadline still runs a single simulation.
+    solver.sampleAction(belief, 2, start, &stats);
+    BOOST_CHECK_EQUAL( stats.simulations, 1 );
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE UtilsIndexedHeap
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/Utils/IndexedHeap.hpp>
+
+#include <algorithm>
+#include <random>
+
+BOOST_AUTO_TEST_CASE( ordering ) {
+    AIToolbox::IndexedHeap<> heap(10);
+
+    heap.push(3, 1.0);
+    heap.push(7, 5.0);
+    heap.push(1, 3.0);
+    heap.push(9, 4.0);
+
+    BOOST_CHECK_EQUAL(heap.size(), 4);
+    BOOST_CHECK(heap.contains(7));
+    BOOST_CHECK(!heap.contains(0));
+    BOOST_CHECK_EQUAL(heap.getPriority(9), 4.0);
+
+    // Increasing with a lower priority does nothing.
+    heap.increase(9, 2.0);
+    BOOST_CHECK_EQUAL(heap.getPriority(9), 4.0);
+
+    heap.increase(3, 6.0);
+    heap.pushOrIncrease(1, 4.5);
+    heap.pushOrIncrease(0, 0.5);
+
+    const std::vector<size_t> order{3, 7, 1, 9, 0};
+    for ( auto k : order ) {
+        BOOST_CHECK_EQUAL(heap.top().key, k);
+        heap.pop();
+        BOOST_CHECK(!heap.contains(k));
+    }
+    BOOST_CHECK(heap.empty());
+}
+
+BOOST_AUTO_TEST_CASE( growAndClear ) {
+    AIToolbox::IndexedHeap<2> heap;
+
+    heap.push(100, 1.0);
+    heap.push(5, 2.0);
+    BOOST_CHECK(heap.contains(100));
+    BOOST_CHECK_EQUAL(heap.top().key, 5);
+
+    heap.clear();
+    BOOST_CHECK(heap.empty());
+    BOOST_CHECK(!heap.contains(100));
+    BOOST_CHECK(!heap.contains(5));
+
+    heap.push(100, 3.0);
+    BOOST_CHECK_EQUAL(heap.top().key, 100);
+}
+
+BOOST_AUTO_TEST_CASE( randomized ) {
+    std::mt19937 rand(42);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::uniform_int_distribution<size_t> keyDist(0, 199);
+
+    AIToolbox::IndexedHeap<> heap(200);
+    std::vector<double> truth(200, -1.0);
+
+    for ( int i = 0; i < 2000; ++i ) {
+        const auto k = keyDist(rand);
+        const auto p = dist(rand);
+        heap.pushOrIncrease(k, p);
+        truth[k] = std::max(truth[k], p);
+
+        // Every so often we pop a bit.
+        if ( i % 10 == 9 ) {
+            const auto best = std::max_element(std::begin(truth), std::end(truth));
+            BOOST_CHECK_EQUAL(heap.top().priority, *best);
+            BOOST_CHECK_EQUAL(truth[heap.top().key], *best);
+            truth[heap.top().key] = -1.0;
+            heap.pop();
+        }
+    }
+    BOOST_CHECK_EQUAL(heap.size(), std::count_if(std::begin(truth), std::end(truth), [](double d){ return d >= 0.0; }));
+}
@@ -62,3 +62,24 @@ BOOST_AUTO_TEST_CASE( vose_alias_sampling ) {
         BOOST_CHECK(std::abs(counters[i] - exactAmount) < percentageErrorAllowed * exactAmount);
     }
 }
+
+BOOST_AUTO_TEST_CASE( sparse_sampling_short_row ) {
+    AIToolbox::RandomEngine rand(AIToolbox::Impl::Seeder::getSeed());
+
+    // A row summing to less than one, as can happen with rounding, must
+    // not be scanned past its end.
+    AIToolbox::SparseMatrix2DT<float> m(2, 10);
+    m.insert(0, 2) = 0.25f;
+    m.insert(0, 5) = 0.25f;
+    m.insert(1, 0) = 1.0f;
+    m.makeCompressed();
+    const auto & cm = m;
+
+    constexpr size_t trials = 10'000;
+    std::vector<size_t> counters(10);
+    for (size_t i = 0; i < trials; ++i)
+        ++counters[AIToolbox::sampleProbability(10, cm.row(0), rand)];
+
+    BOOST_CHECK_EQUAL(counters[2] + counters[5], trials);
+    BOOST_CHECK(counters[5] > counters[2]);
+}
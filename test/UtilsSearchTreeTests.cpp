@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE UtilsSearchTree
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/Utils/SearchTree.hpp>
+
+#include <vector>
+
+using Tree = AIToolbox::SearchTree<std::vector<int>>;
+
+BOOST_AUTO_TEST_CASE( construction ) {
+    Tree tree(3);
+
+    const auto root = tree.getRoot();
+    BOOST_CHECK_EQUAL( tree.getA(), 3 );
+    BOOST_CHECK_EQUAL( tree.getAllocatedNodes(), 1 );
+    BOOST_CHECK( !tree.isExpanded(root) );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 0, 0), Tree::None );
+
+    tree.expand(root);
+    BOOST_CHECK( tree.isExpanded(root) );
+    for ( size_t a = 0; a < 3; ++a ) {
+        const auto & edge = tree.getEdges(root)[a];
+        BOOST_CHECK_EQUAL( edge.N, 0 );
+        BOOST_CHECK_EQUAL( edge.V, 0.0 );
+        BOOST_CHECK_EQUAL( edge.child, Tree::None );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( children ) {
+    Tree tree(2);
+    const auto root = tree.getRoot();
+    tree.expand(root);
+
+    const auto c1 = tree.addChild(root, 1, 10);
+    const auto c2 = tree.addChild(root, 1, 20);
+    const auto c3 = tree.addChild(root, 0, 10);
+
+    BOOST_CHECK_EQUAL( tree.findChild(root, 1, 10), c1 );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 1, 20), c2 );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 0, 10), c3 );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 0, 20), Tree::None );
+
+    BOOST_CHECK_EQUAL( tree.getNode(c2).key, 20 );
+    BOOST_CHECK( !tree.isExpanded(c2) );
+
+    // References stay valid while the arena grows.
+    auto & node = tree.getNode(c1);
+    node.data.push_back(5);
+    tree.expand(c1);
+    auto * edges = tree.getEdges(c1);
+    edges[0].N = 7;
+
+    auto parent = c1;
+    for ( size_t i = 0; i < 5000; ++i ) {
+        tree.expand(parent);
+        parent = tree.addChild(parent, i % 2, i);
+    }
+
+    BOOST_CHECK_EQUAL( &node, &tree.getNode(c1) );
+    BOOST_CHECK_EQUAL( edges, tree.getEdges(c1) );
+    BOOST_CHECK_EQUAL( tree.getEdges(c1)[0].N, 7 );
+    BOOST_CHECK_EQUAL( tree.getNode(c1).data.size(), 1 );
+    BOOST_CHECK_EQUAL( tree.getAllocatedNodes(), 5004 );
+
+    // Copies are independent.
+    Tree copy(tree);
+    copy.getEdges(c1)[0].N = 3;
+    BOOST_CHECK_EQUAL( tree.getEdges(c1)[0].N, 7 );
+    BOOST_CHECK_EQUAL( copy.getNode(c1).data.size(), 1 );
+    BOOST_CHECK_EQUAL( copy.findChild(root, 1, 20), c2 );
+}
+
+BOOST_AUTO_TEST_CASE( reroot ) {
+    Tree tree(2);
+    auto root = tree.getRoot();
+    tree.expand(root);
+
+    const auto c1 = tree.addChild(root, 0, 1);
+    const auto c2 = tree.addChild(root, 0, 2);
+    const auto c3 = tree.addChild(root, 0, 3);
+    tree.addChild(root, 1, 2);
+
+    tree.getNode(c2).N = 4;
+    tree.getNode(c2).data.push_back(1);
+    tree.expand(c2);
+    const auto g = tree.addChild(c2, 1, 9);
+
+    BOOST_CHECK( !tree.reroot(1, 7) );
+    BOOST_CHECK_EQUAL( tree.getRoot(), root );
+
+    BOOST_CHECK( tree.reroot(0, 2) );
+    root = tree.getRoot();
+    BOOST_CHECK_EQUAL( root, c2 );
+    BOOST_CHECK_EQUAL( tree.getNode(root).N, 4 );
+    BOOST_CHECK_EQUAL( tree.getNode(root).data.size(), 1 );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 1, 9), g );
+
+    // The rest of the tree is recycled before the arena grows.
+    const auto allocated = tree.getAllocatedNodes();
+    for ( size_t i = 0; i < 4; ++i ) {
+        const auto c = tree.addChild(root, 0, 100 + i);
+        BOOST_CHECK( c != c2 && c != g );
+        BOOST_CHECK( !tree.isExpanded(c) );
+        BOOST_CHECK_EQUAL( tree.getNode(c).N, 0 );
+        BOOST_CHECK( tree.getNode(c).data.empty() );
+    }
+    BOOST_CHECK_EQUAL( tree.getAllocatedNodes(), allocated );
+    BOOST_CHECK_EQUAL( tree.findChild(root, 1, 9), g );
+
+    tree.addChild(root, 0, 200);
+    BOOST_CHECK_EQUAL( tree.getAllocatedNodes(), allocated + 1 );
+
+    (void)c1; (void)c3;
+}
+
+BOOST_AUTO_TEST_CASE( reset ) {
+    Tree tree(4);
+
+    for ( unsigned r = 0; r < 10; ++r ) {
+        tree.reset();
+        const auto root = tree.getRoot();
+        BOOST_CHECK( !tree.isExpanded(root) );
+        BOOST_CHECK_EQUAL( tree.getNode(root).N, 0 );
+
+        tree.expand(root);
+        for ( size_t i = 0; i < 100; ++i ) {
+            const auto c = tree.addChild(root, i % 4, i);
+            tree.expand(c);
+            // Recycled edges are zeroed.
+            BOOST_CHECK_EQUAL( tree.getEdges(c)[0].N, 0 );
+            tree.getEdges(c)[0].N = 1;
+        }
+        BOOST_CHECK_EQUAL( tree.getEdges(root)[0].N, 0 );
+    }
+    BOOST_CHECK_EQUAL( tree.getAllocatedNodes(), 101 );
+}
@@ -0,0 +1,81 @@
+#define BOOST_TEST_MODULE UtilsTranspositionTable
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/Utils/TranspositionTable.hpp>
+#include <AIToolbox/Utils/SearchTree.hpp>
+
+using Table = AIToolbox::TranspositionTable<AIToolbox::SearchTree<>::Edge>;
+
+BOOST_AUTO_TEST_CASE( construction ) {
+    Table table(3, 10);
+
+    // The capacity is rounded up to whole buckets.
+    BOOST_CHECK_EQUAL( table.getCapacity(), 12 );
+    BOOST_CHECK_EQUAL( table.getA(), 3 );
+    BOOST_CHECK_EQUAL( table.size(), 0 );
+    BOOST_CHECK_EQUAL( table.find(0, 0), Table::None );
+
+    Table empty(3, 0);
+    BOOST_CHECK_EQUAL( empty.getCapacity(), 0 );
+    BOOST_CHECK_EQUAL( empty.find(0, 0), Table::None );
+    BOOST_CHECK_EQUAL( empty.insert(0, 0), Table::None );
+}
+
+BOOST_AUTO_TEST_CASE( insertion ) {
+    Table table(2, 100);
+
+    const auto i = table.insert(5, 3);
+    BOOST_REQUIRE( i != Table::None );
+    BOOST_CHECK_EQUAL( table.size(), 1 );
+    BOOST_CHECK_EQUAL( table.getNode(i).key, 5 );
+    BOOST_CHECK_EQUAL( table.getNode(i).depth, 3 );
+    BOOST_CHECK_EQUAL( table.getNode(i).N, 0 );
+
+    table.getNode(i).N = 4;
+    table.getEdges(i)[1].V = 2.0;
+
+    // Keys are distinguished by depth.
+    BOOST_CHECK_EQUAL( table.find(5, 3), i );
+    BOOST_CHECK_EQUAL( table.find(5, 2), Table::None );
+    BOOST_CHECK_EQUAL( table.getEdges(table.find(5, 3))[1].V, 2.0 );
+
+    const auto j = table.insert(5, 2);
+    BOOST_CHECK( j != i );
+    BOOST_CHECK_EQUAL( table.getEdges(j)[1].V, 0.0 );
+    BOOST_CHECK_EQUAL( table.size(), 2 );
+
+    table.clear();
+    BOOST_CHECK_EQUAL( table.size(), 0 );
+    BOOST_CHECK_EQUAL( table.find(5, 3), Table::None );
+}
+
+BOOST_AUTO_TEST_CASE( replacement ) {
+    // A single bucket.
+    Table table(1, Table::Ways);
+
+    // Entries of the current generation are never replaced.
+    for ( size_t k = 0; k < Table::Ways; ++k )
+        BOOST_CHECK( table.insert(k, 0) != Table::None );
+    BOOST_CHECK_EQUAL( table.insert(100, 0), Table::None );
+    BOOST_CHECK_EQUAL( table.size(), Table::Ways );
+
+    // In a new generation, the least recently used entry goes first.
+    table.newGeneration();
+    table.find(0, 0);
+    table.newGeneration();
+    for ( size_t k = 2; k < Table::Ways; ++k )
+        table.find(k, 0);
+
+    const auto i = table.insert(100, 0);
+    BOOST_REQUIRE( i != Table::None );
+    BOOST_CHECK_EQUAL( table.find(1, 0), Table::None );
+    BOOST_CHECK_EQUAL( table.find(100, 0), i );
+    BOOST_CHECK_EQUAL( table.size(), Table::Ways );
+
+    // Then the one used one generation ago.
+    BOOST_CHECK( table.insert(200, 0) != Table::None );
+    BOOST_CHECK_EQUAL( table.find(0, 0), Table::None );
+    BOOST_CHECK_EQUAL( table.insert(300, 0), Table::None );
+}